@@ -0,0 +1,246 @@
+/* Gerador de programas C- sintéticos para medir a vazão do compilador.
+ *
+ * O programa gerado é válido para o compilador: cada função declara suas
+ * variáveis no início, só chama funções já definidas e devolve um int. O
+ * tamanho é controlado pelos parâmetros e a saída é sempre a mesma para a
+ * mesma semente.
+ *
+ *   ./gerador [--functions=N] [--statements=M] [--depth=D] [--globals=G]
+ *             [--arrays=A] [--call-density=P] [--seed=S] > programa.c-
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARRAY_SIZE 16   // tamanho dos vetores globais
+#define LOCALS 4        // variáveis locais de cada função (xa..xd)
+#define LOOP_LOCAL 3    // xd conta os laços; só o while escreve nela
+#define MAX_PARAMS 3
+
+typedef struct {
+    int functions;      // funções além de main
+    int statements;     // comandos por função
+    int depth;          // aninhamento máximo de if/while
+    int globals;        // variáveis globais escalares
+    int arrays;         // vetores globais
+    int callDensity;    // % dos comandos que são chamadas
+    unsigned int seed;
+} GeneratorOptions;
+
+static unsigned int state;
+
+// Gerador congruencial: a mesma semente sempre gera o mesmo programa
+static int randomInt(int limit) {
+    state = state * 1103515245u + 12345u;
+    return (int)((state >> 16) % (unsigned int)limit);
+}
+
+// Identificadores de C- só têm letras: o índice vira letras (0 = a, 25 = z, 26 = ba...)
+static const char* name(char prefix, int index) {
+    static char buffers[4][16];
+    static int next = 0;
+    char* text = buffers[next++ & 3];
+    char digits[16];
+    int length = 0;
+    do {
+        digits[length++] = (char)('a' + index % 26);
+        index /= 26;
+    } while (index > 0);
+    text[0] = prefix;
+    for (int i = 0; i < length; i++) {
+        text[i + 1] = digits[length - 1 - i];
+    }
+    text[length + 1] = '\0';
+    return text;
+}
+
+static int paramCount(int function) {
+    return 1 + function % MAX_PARAMS;
+}
+
+static void indent(int level) {
+    for (int i = 0; i < level; i++) {
+        fputs("    ", stdout);
+    }
+}
+
+// Operando: local, parâmetro, global, elemento de vetor ou constante
+static void operand(const GeneratorOptions* options, int params) {
+    switch (randomInt(5)) {
+        case 0:
+            printf("%s", name('x', randomInt(LOCALS)));
+            break;
+        case 1:
+            printf("%s", name('p', randomInt(params)));
+            break;
+        case 2:
+            if (options->globals > 0) {
+                printf("%s", name('g', randomInt(options->globals)));
+                break;
+            }
+            /* fall through */
+        case 3:
+            if (options->arrays > 0) {
+                printf("%s[%d]", name('v', randomInt(options->arrays)), randomInt(ARRAY_SIZE));
+                break;
+            }
+            /* fall through */
+        default:
+            printf("%d", 1 + randomInt(9));
+            break;
+    }
+}
+
+static void expression(const GeneratorOptions* options, int params) {
+    static const char* operators[] = {"+", "-", "*", "+"};
+    operand(options, params);
+    printf(" %s ", operators[randomInt(4)]);
+    operand(options, params);
+}
+
+static void condition(const GeneratorOptions* options, int params) {
+    static const char* relations[] = {"<", "<=", ">", ">=", "==", "!="};
+    operand(options, params);
+    printf(" %s ", relations[randomInt(6)]);
+    operand(options, params);
+}
+
+static void destination(const GeneratorOptions* options) {
+    int kind = randomInt(4);
+    if (kind == 1 && options->globals > 0) {
+        printf("%s", name('g', randomInt(options->globals)));
+    } else if (kind == 2 && options->arrays > 0) {
+        printf("%s[%d]", name('v', randomInt(options->arrays)), randomInt(ARRAY_SIZE));
+    } else {
+        printf("%s", name('x', randomInt(LOOP_LOCAL)));
+    }
+}
+
+static void statement(const GeneratorOptions* options, int function, int level, int* remaining);
+
+static void block(const GeneratorOptions* options, int function, int level, int* remaining, int count) {
+    for (int i = 0; i < count && *remaining > 0; i++) {
+        statement(options, function, level, remaining);
+    }
+}
+
+// Um comando; if e while consomem os comandos do próprio corpo
+static void statement(const GeneratorOptions* options, int function, int level, int* remaining) {
+    int params = paramCount(function);
+    (*remaining)--;
+    indent(level);
+
+    if (function > 0 && randomInt(100) < options->callDensity) {
+        int callee = randomInt(function);
+        printf("%s = %s(", name('x', randomInt(LOOP_LOCAL)), name('f', callee));
+        for (int i = 0; i < paramCount(callee); i++) {
+            printf("%s", i > 0 ? ", " : "");
+            operand(options, params);
+        }
+        printf(");\n");
+        return;
+    }
+
+    int kind = level <= options->depth ? randomInt(6) : 0;
+    if (kind == 4 && *remaining > 0) {
+        printf("if (");
+        condition(options, params);
+        printf(") {\n");
+        block(options, function, level + 1, remaining, 1 + randomInt(3));
+        indent(level);
+        printf("} else {\n");
+        block(options, function, level + 1, remaining, 1 + randomInt(2));
+        indent(level);
+        printf("}\n");
+    } else if (kind == 5 && level == 1 && *remaining > 0) {
+        // laço contado por xd, que o corpo não altera
+        printf("%s = 0;\n", name('x', LOOP_LOCAL));
+        indent(level);
+        printf("while (%s < %d) {\n", name('x', LOOP_LOCAL), 2 + randomInt(8));
+        block(options, function, level + 1, remaining, 1 + randomInt(3));
+        indent(level + 1);
+        printf("%s = %s + 1;\n", name('x', LOOP_LOCAL), name('x', LOOP_LOCAL));
+        indent(level);
+        printf("}\n");
+    } else {
+        destination(options);
+        printf(" = ");
+        expression(options, params);
+        printf(";\n");
+    }
+}
+
+static void function(const GeneratorOptions* options, int index) {
+    printf("int %s(", name('f', index));
+    for (int i = 0; i < paramCount(index); i++) {
+        printf("%sint %s", i > 0 ? ", " : "", name('p', i));
+    }
+    printf(") {\n");
+    for (int i = 0; i < LOCALS; i++) {
+        printf("    int %s;\n", name('x', i));
+    }
+    for (int i = 0; i < LOCALS; i++) {
+        printf("    %s = %d;\n", name('x', i), i + 1);
+    }
+    int remaining = options->statements;
+    while (remaining > 0) {
+        statement(options, index, 1, &remaining);
+    }
+    printf("    return xa + xb;\n}\n\n");
+}
+
+static int parseOption(const char* arg, const char* name, int* value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) == 0 && arg[length] == '=') {
+        *value = atoi(arg + length + 1);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    GeneratorOptions options = {10, 10, 2, 8, 2, 20, 1};
+    for (int i = 1; i < argc; i++) {
+        int seed;
+        if (!parseOption(argv[i], "--functions", &options.functions) &&
+            !parseOption(argv[i], "--statements", &options.statements) &&
+            !parseOption(argv[i], "--depth", &options.depth) &&
+            !parseOption(argv[i], "--globals", &options.globals) &&
+            !parseOption(argv[i], "--arrays", &options.arrays) &&
+            !parseOption(argv[i], "--call-density", &options.callDensity)) {
+            if (parseOption(argv[i], "--seed", &seed)) {
+                options.seed = (unsigned int)seed;
+            } else {
+                fprintf(stderr, "Opção desconhecida: %s\n", argv[i]);
+                return 1;
+            }
+        }
+    }
+    state = options.seed;
+
+    printf("/* Gerado por Bench/gerador: %d funções, %d comandos, profundidade %d, "
+           "%d globais, %d vetores, %d%% de chamadas, semente %u */\n",
+           options.functions, options.statements, options.depth, options.globals, options.arrays,
+           options.callDensity, options.seed);
+    for (int i = 0; i < options.globals; i++) {
+        printf("int %s;\n", name('g', i));
+    }
+    for (int i = 0; i < options.arrays; i++) {
+        printf("int %s[%d];\n", name('v', i), ARRAY_SIZE);
+    }
+    printf("\n");
+    for (int i = 0; i < options.functions; i++) {
+        function(&options, i);
+    }
+
+    printf("void main(void) {\n    int r;\n    r = 0;\n");
+    for (int i = options.functions - 1; i >= 0 && i >= options.functions - 4; i--) {
+        printf("    r = r + %s(", name('f', i));
+        for (int p = 0; p < paramCount(i); p++) {
+            printf("%s%d", p > 0 ? ", " : "", p + 1);
+        }
+        printf(");\n");
+    }
+    printf("    output(r);\n    saltoSO();\n}\n");
+    return 0;
+}
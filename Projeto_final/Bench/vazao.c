@@ -0,0 +1,314 @@
+/* Vazão do compilador: gera programas sintéticos em escalas crescentes
+ * (Bench/gerador), compila cada um medindo o tempo de cada fase
+ * (--phase-times) e o pico de memória do processo, e aponta as fases cujo
+ * tempo cresce mais que linearmente com o tamanho do programa.
+ *
+ *   ./Bench/vazao [--scales=1,10,100,1000] [--timeout=S] [--compiler=./cminus_parser]
+ *                 [--generator=./Bench/gerador] [opções do gerador...]
+ *
+ * A escala multiplica o número de funções; as outras opções do gerador
+ * (--statements, --depth, --globals, --arrays, --call-density, --seed) são
+ * repassadas como vieram. Resultados em Output/vazao/resultado.json.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#define RESULT_DIR "Output/vazao"
+#define MAX_SCALES 8
+#define MAX_PHASES 32
+#define MAX_GENERATOR_ARGS 16
+#define BASE_FUNCTIONS 10        // funções na escala 1x
+#define SUPERLINEAR_EXPONENT 1.5 // tempo ~ tamanho^k; acima disso a fase é apontada
+#define MIN_MEASURED_TIME 0.005  // tempos menores que isso são ruído para o expoente
+
+typedef struct {
+    char name[64];
+    double seconds;
+    long long calls;
+    int depth;
+} Phase;
+
+typedef struct {
+    int scale;
+    int functions;
+    long lines;
+    int status;          // 0 ok, 1 erro de compilação, 2 tempo esgotado
+    double seconds;      // tempo de parede do processo do compilador
+    long peakKb;         // pico de memória residente (ru_maxrss)
+    Phase phases[MAX_PHASES];
+    int phaseCount;
+} ScaleResult;
+
+static const char* compiler = "./cminus_parser";
+static const char* generator = "./Bench/gerador";
+static int timeoutSeconds = 120;  // por escala; estourar já indica crescimento ruim
+
+static double now(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Executa argv com stdin/stdout redirecionados; devolve o status do wait4
+static int run(char* const argv[], const char* input, const char* output, struct rusage* usage,
+               double* seconds, int* timedOut) {
+    double start = now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        if (input != NULL) {
+            int in = open(input, O_RDONLY);
+            dup2(in, STDIN_FILENO);
+        }
+        int out = open(output, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        dup2(out, STDOUT_FILENO);
+        dup2(out, STDERR_FILENO);
+        execv(argv[0], argv);
+        _exit(127);
+    }
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+
+    int status = 0;
+    *timedOut = 0;
+    while (wait4(pid, &status, WNOHANG, usage) == 0) {
+        if (now() - start > timeoutSeconds) {
+            kill(pid, SIGKILL);
+            wait4(pid, &status, 0, usage);
+            *timedOut = 1;
+            break;
+        }
+        usleep(2000);
+    }
+    *seconds = now() - start;
+    return status;
+}
+
+static long countLines(const char* path) {
+    FILE* file = fopen(path, "r");
+    long lines = 0;
+    int c;
+    if (file == NULL) {
+        return 0;
+    }
+    while ((c = fgetc(file)) != EOF) {
+        lines += c == '\n';
+    }
+    fclose(file);
+    return lines;
+}
+
+static void readPhases(const char* path, ScaleResult* result) {
+    FILE* file = fopen(path, "r");
+    char line[256];
+    if (file == NULL) {
+        return;
+    }
+    while (result->phaseCount < MAX_PHASES && fgets(line, sizeof(line), file) != NULL) {
+        Phase* phase = &result->phases[result->phaseCount];
+        if (sscanf(line, "%63[^\t]\t%lf\t%lld\t%d", phase->name, &phase->seconds, &phase->calls,
+                   &phase->depth) == 4) {
+            result->phaseCount++;
+        }
+    }
+    fclose(file);
+}
+
+// A mesma fase pode aparecer sob pais diferentes: vale a ocorrência de mesma ordem
+static const Phase* findPhase(const ScaleResult* result, const char* name, int occurrence) {
+    for (int i = 0; i < result->phaseCount; i++) {
+        if (strcmp(result->phases[i].name, name) == 0 && occurrence-- == 0) {
+            return &result->phases[i];
+        }
+    }
+    return NULL;
+}
+
+static int measureScale(int scale, char** generatorArgs, int generatorArgCount, ScaleResult* result) {
+    char source[256], list[256], log[256], phases[256], dir[256], functions[64], phaseOption[300], batchOption[300];
+    snprintf(dir, sizeof(dir), RESULT_DIR "/escala_%d", scale);
+    snprintf(source, sizeof(source), RESULT_DIR "/escala_%d.c-", scale);
+    snprintf(list, sizeof(list), RESULT_DIR "/escala_%d.lista", scale);
+    snprintf(log, sizeof(log), RESULT_DIR "/escala_%d.log", scale);
+    snprintf(phases, sizeof(phases), RESULT_DIR "/escala_%d.fases", scale);
+    memset(result, 0, sizeof(ScaleResult));
+    result->scale = scale;
+    result->functions = BASE_FUNCTIONS * scale;
+
+    // Programa sintético
+    char* args[MAX_GENERATOR_ARGS + 3];
+    int count = 0;
+    snprintf(functions, sizeof(functions), "--functions=%d", result->functions);
+    args[count++] = (char*)generator;
+    args[count++] = functions;
+    for (int i = 0; i < generatorArgCount; i++) {
+        args[count++] = generatorArgs[i];
+    }
+    args[count] = NULL;
+    struct rusage usage;
+    double seconds;
+    int timedOut;
+    if (run(args, NULL, source, &usage, &seconds, &timedOut) != 0) {
+        fprintf(stderr, "Erro ao gerar %s com %s.\n", source, generator);
+        return -1;
+    }
+    result->lines = countLines(source);
+
+    // Compilação pelo modo lote, para os arquivos gerados irem para o diretório da escala
+    FILE* file = fopen(list, "w");
+    fprintf(file, "%s %s\n", source, dir);
+    fclose(file);
+    remove(phases);
+    snprintf(phaseOption, sizeof(phaseOption), "--phase-times=%s", phases);
+    snprintf(batchOption, sizeof(batchOption), "--batch=%s", list);
+    char* compile[] = {(char*)compiler, phaseOption, batchOption, NULL};
+    int status = run(compile, NULL, log, &usage, &result->seconds, &timedOut);
+    result->peakKb = usage.ru_maxrss;
+    result->status = timedOut ? 2 : (WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : 1);
+    readPhases(phases, result);
+    return 0;
+}
+
+// Expoente k de tempo ~ tamanho^k entre duas escalas (0 se o tempo é pequeno demais)
+static double growthExponent(double before, double after, int scaleBefore, int scaleAfter) {
+    if (before < MIN_MEASURED_TIME || after < MIN_MEASURED_TIME) {
+        return 0;
+    }
+    return log(after / before) / log((double)scaleAfter / scaleBefore);
+}
+
+static void printResults(const ScaleResult* results, int count) {
+    static const char* statusText[] = {"ok", "erro", "tempo esgotado"};
+    printf("\n%-8s %8s %9s %10s %11s  %s\n", "escala", "funções", "linhas", "tempo (s)", "pico (KB)", "situação");
+    for (int i = 0; i < count; i++) {
+        printf("%6dx  %8d %9ld %10.3f %11ld  %s\n", results[i].scale, results[i].functions, results[i].lines,
+               results[i].seconds, results[i].peakKb, statusText[results[i].status]);
+    }
+
+    // Fases na ordem da maior escala medida por completo
+    const ScaleResult* reference = NULL;
+    for (int i = 0; i < count; i++) {
+        if (results[i].phaseCount > 0) {
+            reference = &results[i];
+        }
+    }
+    if (reference == NULL) {
+        return;
+    }
+    printf("\n%-38s", "fase (s)");
+    for (int i = 0; i < count; i++) {
+        printf(" %9dx", results[i].scale);
+    }
+    printf("  expoente\n");
+    for (int p = 0; p < reference->phaseCount; p++) {
+        const char* name = reference->phases[p].name;
+        int occurrence = 0;
+        for (int q = 0; q < p; q++) {
+            occurrence += strcmp(reference->phases[q].name, name) == 0;
+        }
+        printf("%*s%-*s", reference->phases[p].depth * 2, "", 38 - reference->phases[p].depth * 2, name);
+        const Phase* previous = NULL;
+        int previousScale = 0;
+        double exponent = 0;
+        for (int i = 0; i < count; i++) {
+            const Phase* phase = findPhase(&results[i], name, occurrence);
+            if (phase == NULL) {
+                printf(" %10s", "-");
+                continue;
+            }
+            printf(" %10.4f", phase->seconds);
+            if (previous != NULL) {
+                exponent = growthExponent(previous->seconds, phase->seconds, previousScale, results[i].scale);
+            }
+            previous = phase;
+            previousScale = results[i].scale;
+        }
+        if (exponent > 0) {
+            printf("  %8.2f%s", exponent, exponent > SUPERLINEAR_EXPONENT ? "  <- cresce mais que linear" : "");
+        }
+        printf("\n");
+    }
+}
+
+static void writeJson(const ScaleResult* results, int count) {
+    FILE* file = fopen(RESULT_DIR "/resultado.json", "w");
+    if (file == NULL) {
+        return;
+    }
+    fprintf(file, "{\"escalas\": [\n");
+    for (int i = 0; i < count; i++) {
+        const ScaleResult* r = &results[i];
+        fprintf(file, "%s{\"escala\": %d, \"funcoes\": %d, \"linhas\": %ld, \"situacao\": %d, "
+                "\"segundos\": %.6f, \"pico_kb\": %ld, \"fases\": [",
+                i > 0 ? ",\n" : "", r->scale, r->functions, r->lines, r->status, r->seconds, r->peakKb);
+        for (int p = 0; p < r->phaseCount; p++) {
+            fprintf(file, "%s{\"nome\": \"%s\", \"segundos\": %.6f, \"chamadas\": %lld, \"nivel\": %d}",
+                    p > 0 ? ", " : "", r->phases[p].name, r->phases[p].seconds, r->phases[p].calls,
+                    r->phases[p].depth);
+        }
+        fprintf(file, "]}");
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+}
+
+int main(int argc, char* argv[]) {
+    int scales[MAX_SCALES] = {1, 10, 100, 1000};
+    int scaleCount = 4;
+    char* generatorArgs[MAX_GENERATOR_ARGS];
+    int generatorArgCount = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--scales=", 9) == 0) {
+            scaleCount = 0;
+            for (char* p = argv[i] + 9; *p != '\0' && scaleCount < MAX_SCALES; p += *p == ',') {
+                scales[scaleCount++] = (int)strtol(p, &p, 10);
+            }
+        } else if (strncmp(argv[i], "--timeout=", 10) == 0) {
+            timeoutSeconds = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--compiler=", 11) == 0) {
+            compiler = argv[i] + 11;
+        } else if (strncmp(argv[i], "--generator=", 12) == 0) {
+            generator = argv[i] + 12;
+        } else if (generatorArgCount < MAX_GENERATOR_ARGS) {
+            generatorArgs[generatorArgCount++] = argv[i];
+        }
+    }
+
+    mkdir("Output", 0755);
+    mkdir(RESULT_DIR, 0755);
+    ScaleResult* results = calloc(scaleCount, sizeof(ScaleResult));
+    int measured = 0;
+    for (int i = 0; i < scaleCount; i++) {
+        printf("Escala %dx (%d funções)...\n", scales[i], BASE_FUNCTIONS * scales[i]);
+        fflush(stdout);
+        if (measureScale(scales[i], generatorArgs, generatorArgCount, &results[measured]) != 0) {
+            break;
+        }
+        measured++;
+        if (results[measured - 1].status == 2) {
+            printf("Tempo esgotado (%d s); escalas maiores não foram medidas.\n", timeoutSeconds);
+            break;
+        }
+    }
+    printResults(results, measured);
+    writeJson(results, measured);
+    printf("\nResultados em %s/resultado.json\n", RESULT_DIR);
+
+    int failed = 0;
+    for (int i = 0; i < measured; i++) {
+        failed |= results[i].status == 1;
+    }
+    free(results);
+    return failed;
+}
@@ -1,8 +1,9 @@
 #include "asnt.h"
+#include "tempo_fases.h"
 
 // Função para criar nós da árvore
 ASTNode* createNode(NodeType type, ASTNode* left, ASTNode* right, char* value, int lineno, char *idType) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode)); //alocação de memória para o nó
+    ASTNode* node = (ASTNode*)memAlloc(sizeof(ASTNode)); //alocação de memória para o nó
     if (!node) { //se não funcionar, imprime um erro
         fprintf(stderr, "Erro ao alocar memória para ASTNode.\n");
         exit(EXIT_FAILURE);
@@ -10,7 +11,7 @@ ASTNode* createNode(NodeType type, ASTNode* left, ASTNode* right, char* value, i
     node->type = type;
     node->left = left;
     node->right = right;
-    node->value = value ? strdup(value) : NULL; //Se value não for NULL, duplica a string usando strdup e inicializa o campo value
+    node->value = value ? memStrdup(value) : NULL; //Se value não for NULL, duplica a string usando strdup e inicializa o campo value
     node->lineno = lineno;
     node->idType = idType;
     node->scope = NULL;  // Inicializa o novo campo
@@ -22,8 +23,8 @@ void freeAST(ASTNode* root) {
     if (root == NULL) return;
     freeAST(root->left);
     freeAST(root->right);
-    if (root->value) free(root->value);
-    free(root);
+    if (root->value) memFree(root->value);
+    memFree(root);
 }
 
 // Função para converter NodeType para string
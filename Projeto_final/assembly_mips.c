@@ -1,4 +1,13 @@
 #include "assembly_mips.h"
+#include "tempo_fases.h"
+
+static RegisterMapping argumentRegs[6]; // a0-a5
+static RegisterMapping paramRegs[6]; // p0-p5
+static RegisterMapping tempLocalRegs[27];  // t0-t26
+static RegisterMapping tempGlobalRegs[13];  // t0-t12
+static RegisterMapping returnRegs[1]; // v0
+
+static char currentFunction[50] = ""; // Função atual sendo processada
 
 // Ver o Operador (OP) a partir da tabela de quadruplas
 OperationType getOpTypeFromString(const char* op) {
@@ -26,9 +35,195 @@ OperationType getOpTypeFromString(const char* op) {
     if (strcmp(op, "ARRAY_LOAD") == 0) return OP_ARRAY_LOAD;
     if (strcmp(op, "ARRAY_STORE") == 0) return OP_ARRAY_STORE;
     if (strcmp(op, "ALLOC") == 0) return OP_ALLOC;
+    if (strcmp(op, "COUNT") == 0) return OP_COUNT;
     return -1;
 }
 
+// Forma longa por padrão: os opcodes relativos (29, 33-37) ainda não existem no
+// decodificador do processador; --pc-relative-branches os liga
+int desvioLongo = 1;
+
+// Sufixo do mnemônico dos desvios condicionais: "r" seleciona a forma relativa ao PC,
+// cujo deslocamento vai no imediato e dispensa o addil que carrega o destino em r43
+static const char* sufixoDesvio(void) {
+    return desvioLongo ? "" : "r";
+}
+
+/* ---------- emissão de código de máquina ----------
+ * O backend emite instruções já decodificadas (opcode/formato da tabela de instruções,
+ * registradores e imediatos como inteiros, rótulos como relocações). O comentário de
+ * cada instrução só é formatado quando o assembly textual foi pedido. */
+
+static MachineInstr* emitInstr(MachineCode* output, const char* mnemonic, const char* comment, va_list args) {
+    MachineInstr* instr = appendMachineInstr(output, findInstruction(mnemonic));
+    setInstrComment(output, instr, comment, args);
+    return instr;
+}
+
+// add/sub/mul/div/sl/sr $rd $rs $rt
+static void emitR(MachineCode* output, const char* mnemonic, int rd, int rs, int rt, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, mnemonic, comment, args);
+    va_end(args);
+    instr->regs[0] = rd;
+    instr->regs[1] = rs;
+    instr->regs[2] = rt;
+}
+
+// addi/subi $rt $rs imediato
+static void emitI(MachineCode* output, const char* mnemonic, int rt, int rs, int imm, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, mnemonic, comment, args);
+    va_end(args);
+    instr->regs[0] = rt;
+    instr->regs[1] = rs;
+    instr->imm = imm;
+}
+
+// li $rt imediato
+static void emitLi(MachineCode* output, int rt, int imm, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, "li", comment, args);
+    va_end(args);
+    instr->regs[0] = rt;
+    instr->imm = imm;
+}
+
+// li $rt valor, onde valor é uma constante em texto ou um rótulo
+static void emitLoad(MachineCode* output, int rt, const char* value, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, "li", comment, args);
+    va_end(args);
+    instr->regs[0] = rt;
+    setInstrTarget(instr, value);
+}
+
+// lw/sw $rt offset($base)
+static void emitMem(MachineCode* output, const char* mnemonic, int rt, int offset, int base, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, mnemonic, comment, args);
+    va_end(args);
+    instr->regs[0] = rt;
+    instr->regs[1] = base;
+    instr->imm = offset;
+}
+
+// move $rt $rs
+static void emitMove(MachineCode* output, int rt, int rs, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, "move", comment, args);
+    va_end(args);
+    instr->regs[0] = rt;
+    instr->regs[1] = rs;
+}
+
+// Desvio condicional; a forma (relativa ou absoluta) segue --pc-relative-branches
+static void emitBranch(MachineCode* output, const char* mnemonic, int rs, int rt, const char* target, const char* comment, ...) {
+    char name[16];
+    va_list args;
+    snprintf(name, sizeof(name), "%s%s", mnemonic, sufixoDesvio());
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, name, comment, args);
+    va_end(args);
+    instr->regs[0] = rs;
+    instr->regs[1] = rt;
+    setInstrTarget(instr, target);
+}
+
+// addil $rt $rs destino
+static void emitAddil(MachineCode* output, int rt, int rs, const char* target, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, "addil", comment, args);
+    va_end(args);
+    instr->regs[0] = rt;
+    instr->regs[1] = rs;
+    setInstrTarget(instr, target);
+}
+
+// j/jal destino
+static void emitJump(MachineCode* output, const char* mnemonic, const char* target, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, mnemonic, comment, args);
+    va_end(args);
+    setInstrTarget(instr, target);
+}
+
+// Instruções de um registrador: in, out, jr, msgLcd, saltoUser, syscall
+static void emitReg(MachineCode* output, const char* mnemonic, int reg, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, mnemonic, comment, args);
+    va_end(args);
+    instr->regs[0] = reg;
+}
+
+static void emitNop(MachineCode* output, int imm, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = emitInstr(output, "nop", comment, args);
+    va_end(args);
+    instr->imm = imm;
+}
+
+static void emitHalt(MachineCode* output, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    emitInstr(output, "halt", comment, args);
+    va_end(args);
+}
+
+static MachineInstr* emitLabelEntry(MachineCode* output, const char* name, const char* comment, va_list args) {
+    MachineInstr* instr = appendMachineInstr(output, NULL);
+    instr->label = strdup(name);
+    setInstrComment(output, instr, comment, args);
+    return instr;
+}
+
+static void emitLabel(MachineCode* output, const char* name, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    emitLabelEntry(output, name, comment, args);
+    va_end(args);
+}
+
+// Rótulo de entrada de uma função
+static void emitFunctionLabel(MachineCode* output, const char* name, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    emitLabelEntry(output, name, comment, args)->isFunction = 1;
+    va_end(args);
+}
+
+// Linha só de comentário; a entrada existe mesmo sem -S para o peephole ver o mesmo código
+static void emitComment(MachineCode* output, const char* comment, ...) {
+    va_list args;
+    va_start(args, comment);
+    MachineInstr* instr = appendMachineInstr(output, NULL);
+    setInstrComment(output, instr, comment, args);
+    va_end(args);
+}
+
+// Chamada ao dispatcher: r58 recebe o endereço de retorno (rótulo RDn) e o salto vai
+// para o início da imagem do dispatcher, endereço que só o ligador conhece (@imagem)
+static void emitDispatcherJump(MachineCode* output, const char* imagem, int retorno) {
+    char rotulo[16];
+    char destino[64];
+    snprintf(rotulo, sizeof(rotulo), "RD%d", retorno);
+    snprintf(destino, sizeof(destino), "%c%s", EXTERNAL_SYMBOL_PREFIX, imagem);
+    emitLoad(output, 58, rotulo, "endereço de retorno do dispatcher");
+    emitLoad(output, 43, destino, NULL);
+    emitJump(output, "j", destino, NULL);
+    emitLabel(output, rotulo, "Retorno do dispatcher");
+}
+
 //Inicialização dos registradores
 void initRegisterMappings() {
     int i;
@@ -181,7 +376,7 @@ int getRegisterIndex(char* name) {
         }
         else if (strcmp(symbol->idType, "var") == 0 && strcmp(symbol->scope, "global") == 0){
             // se a variavel for global
-            for (int i = 0; i < 7; i++) {
+            for (int i = 0; i < GLOBAL_REGISTER_COUNT; i++) {
                 if (tempGlobalRegs[i].isUsed && strcmp(tempGlobalRegs[i].varName, name) == 0) {
                     DEBUG_ASSEMBLY("DEBUG - getRegisterIndex: Variável global '%s' já mapeada para t%d (r%d)\n", 
                            name, i, 33 + i);
@@ -189,7 +384,7 @@ int getRegisterIndex(char* name) {
                 }
             }
             // Nova variável global, mapeia para o próximo registrador livre
-            int tempIdx = getNextFreeReg(tempGlobalRegs, 7);
+            int tempIdx = getNextFreeReg(tempGlobalRegs, GLOBAL_REGISTER_COUNT);
             sprintf(tempGlobalRegs[tempIdx].varName, "%s", name);
             DEBUG_ASSEMBLY("DEBUG - getRegisterIndex: Nova variável local '%s' mapeada para t%d (r%d)\n", 
                    name, tempIdx, 33 + tempIdx);
@@ -240,109 +435,63 @@ void updateCurrentFunction(const char* funcName) {
     }
 }
 
+// Copia a quádrupla para os campos de texto usados pelo gerador; argumento ausente vira "-"
+static void readQuadruple(const Quadruple* q, QuadrupleInfo* info) {
+    info->line = q->line;
+    info->sourceLine = q->sourceLine;
+    snprintf(info->op, sizeof(info->op), "%s", getOpName(q->op));
+    snprintf(info->arg1, sizeof(info->arg1), "%s", q->arg1 ? q->arg1 : "-");
+    snprintf(info->arg2, sizeof(info->arg2), "%s", q->arg2 ? q->arg2 : "-");
+    snprintf(info->result, sizeof(info->result), "%s", q->result ? q->result : "-");
+}
+
+// Quádrupla vazia (op "" e argumentos "-"), quando não há a seguinte
+static void clearQuadruple(QuadrupleInfo* info) {
+    strcpy(info->op, "");
+    strcpy(info->arg1, "-");
+    strcpy(info->arg2, "-");
+    strcpy(info->result, "-");
+}
+
 // Função para verificar duas quádruplas à frente
-void checkNextNextQuadruple(FILE* inputFile, long* filePos, QuadrupleInfo* nextQuad, QuadrupleInfo* nextNextQuad) {
-    char buffer[256];
-    
-    // Salva a posição atual no arquivo
-    *filePos = ftell(inputFile);
-    
-    // Inicializa ambas as quádruplas
-    strcpy(nextQuad->op, "");
-    strcpy(nextQuad->arg1, "-");
-    strcpy(nextQuad->arg2, "-");
-    strcpy(nextQuad->result, "-");
-    
-    strcpy(nextNextQuad->op, "");
-    strcpy(nextNextQuad->arg1, "-");
-    strcpy(nextNextQuad->arg2, "-");
-    strcpy(nextNextQuad->result, "-");
-    
-    int quadCount = 0;
-    
-    // Tenta ler as próximas duas linhas válidas
-    while (fgets(buffer, sizeof(buffer), inputFile) != NULL && quadCount < 2) {
-        // Ignora linhas de separação e cabeçalho
-        if (strstr(buffer, "---") != NULL || 
-            strstr(buffer, "Quad") != NULL ||
-            strlen(buffer) <= 1) {
-            continue;
+void checkNextNextQuadruple(const Quadruple* current, QuadrupleInfo* nextQuad, QuadrupleInfo* nextNextQuad) {
+    clearQuadruple(nextQuad);
+    clearQuadruple(nextNextQuad);
+    const Quadruple* next = current->next;
+    if (next != NULL) {
+        readQuadruple(next, nextQuad);
+        if (next->next != NULL) {
+            readQuadruple(next->next, nextNextQuad);
         }
-        
-        // Analisa a linha para extrair os campos
-        if (quadCount == 0) {
-            sscanf(buffer, "%d %d %s %s %s %s",
-                   &nextQuad->line, &nextQuad->sourceLine, 
-                   nextQuad->op, nextQuad->arg1, nextQuad->arg2, nextQuad->result);
-        } else {
-            sscanf(buffer, "%d %d %s %s %s %s",
-                   &nextNextQuad->line, &nextNextQuad->sourceLine, 
-                   nextNextQuad->op, nextNextQuad->arg1, nextNextQuad->arg2, nextNextQuad->result);
-        }
-        quadCount++;
     }
-    
-    // Volta para a posição original no arquivo
-    fseek(inputFile, *filePos, SEEK_SET);
 }
 
 // Função auxiliar para verificar a próxima quádrupla
-void checkNextQuadruple(FILE* inputFile, long* filePos, QuadrupleInfo* nextQuad) {
-    char buffer[256];
-    
-    // Salva a posição atual no arquivo
-    *filePos = ftell(inputFile);
-    
-    // Inicializa a próxima quadrupla
-    strcpy(nextQuad->op, "");
-    strcpy(nextQuad->arg1, "-");
-    strcpy(nextQuad->arg2, "-");
-    strcpy(nextQuad->result, "-");
-    
-    // Tenta ler a próxima linha válida (não vazia, não separador)
-    while (fgets(buffer, sizeof(buffer), inputFile) != NULL) {
-        // Ignora linhas de separação e cabeçalho
-        if (strstr(buffer, "---") != NULL || 
-            strstr(buffer, "Quad") != NULL ||
-            strlen(buffer) <= 1) {
-            continue;
-        }
-        
-        // Analisa a próxima linha para extrair os campos
-        sscanf(buffer, "%d %d %s %s %s %s",
-               &nextQuad->line, &nextQuad->sourceLine, 
-               nextQuad->op, nextQuad->arg1, nextQuad->arg2, nextQuad->result);
-        break;
+void checkNextQuadruple(const Quadruple* current, QuadrupleInfo* nextQuad) {
+    clearQuadruple(nextQuad);
+    if (current->next != NULL) {
+        readQuadruple(current->next, nextQuad);
     }
-    
-    // Volta para a posição original no arquivo
-    fseek(inputFile, *filePos, SEEK_SET);
 }
 
 // Empurra um registrador na pilha
-void pushRegister(FILE* output, int reg, int* stackOffset, int* lineIndex) {
+void pushRegister(MachineCode* output, int reg, int* stackOffset) {
     (*stackOffset) -= 4;
-    fprintf(output, "%d - subi $r1 $r1 1      # aloca espaço na pilha\n", (*lineIndex)++);
-    fprintf(output, "%d - sw $r%d 0($r1)       # empilha registrador\n", (*lineIndex)++, reg);
+    emitI(output, "subi", 1, 1, 1, "aloca espaço na pilha");
+    emitMem(output, "sw", reg, 0, 1, "empilha registrador");
     DEBUG_ASSEMBLY("DEBUG - pushRegister: Empilhando r%d, stack offset agora é %d\n", reg, *stackOffset);
 }
 
 // Restaura um registrador da pilha
-void popRegister(FILE* output, int reg, int* stackOffset, int* lineIndex) {
-    fprintf(output, "%d - lw $r%d 0($r1)       # desempilha registrador\n", (*lineIndex)++, reg);
+void popRegister(MachineCode* output, int reg, int* stackOffset) {
+    emitMem(output, "lw", reg, 0, 1, "desempilha registrador");
     (*stackOffset) += 4;
-    fprintf(output, "%d - addi $r1 $r1 1       #desaloca espaço na pilha\n", (*lineIndex)++);
+    emitI(output, "addi", 1, 1, 1, "desaloca espaço na pilha");
     DEBUG_ASSEMBLY("DEBUG - popRegister: Desempilhando para r%d, stack offset agora é %d\n", reg, *stackOffset);
 }
 
 //função auxiliar para imprimir o uso de registradores
-void analyzeRegisterUsage(const char* assemblyFilePath) {
-    FILE* assemblyFile = fopen(assemblyFilePath, "r");
-    if (!assemblyFile) {
-        fprintf(stderr, "Erro: Não foi possível abrir o arquivo assembly para análise: %s\n", assemblyFilePath);
-        return;
-    }
-    
+void analyzeRegisterUsage(const MachineCode* code) {
     // Estrutura para armazenar informações sobre o uso de registradores
     typedef struct {
         int isUsed;
@@ -388,88 +537,75 @@ void analyzeRegisterUsage(const char* assemblyFilePath) {
             strcpy(regUsage[i].regName, "zero");
     }
     
-    char buffer[256];
-    int lineNum = 0;
     char currentFunction[64] = "";
     
-    while (fgets(buffer, sizeof(buffer), assemblyFile) != NULL) {
-        lineNum++;
+    for (int lineNum = 1; lineNum <= code->count; lineNum++) {
+        const MachineInstr* instr = &code->items[lineNum - 1];
         
         // Verificar se estamos mudando de função
-        char functionName[64];
-        if (sscanf(buffer, "%*d - %[^:]:", functionName) == 1 && 
-            strstr(buffer, "# nova função") != NULL) {
-            strcpy(currentFunction, functionName);
-            printf("\nAnalisando função: %s\n", currentFunction);
+        if (instr->label != NULL && instr->isFunction) {
+            snprintf(currentFunction, sizeof(currentFunction), "%s", instr->label);
+            printInfo("\nAnalisando função: %s", currentFunction);
+        }
+        if (instr->info == NULL) {
+            continue;
         }
         
-        // Extrair registradores usados na instrução
-        for (int i = 0; i < 64; i++) {
-            char regPattern[10];
-            sprintf(regPattern, "$r%d", i);
+        // Registradores usados na instrução (cada um conta uma vez por instrução)
+        int regCount = formatRegisterCount(instr->info->format);
+        for (int k = 0; k < regCount; k++) {
+            int i = instr->regs[k];
+            int repeated = 0;
+            for (int m = 0; m < k; m++) {
+                if (instr->regs[m] == i) repeated = 1;
+            }
+            if (i < 0 || i >= 64 || repeated) {
+                continue;
+            }
             
-            // Verifica se o registro é realmente usado na instrução, não apenas mencionado em comentário
-            char* regPos = strstr(buffer, regPattern);
-            if (regPos != NULL) {
-                // Verifica se o registro aparece antes de qualquer "#" (comentário)
-                char* commentPos = strstr(buffer, "#");
-                
-                // Se não há comentário ou o registro aparece antes do comentário
-                if (commentPos == NULL || regPos < commentPos) {
-                    // Verifica se é um verdadeiro uso (não parte de outro nome de registro)
-                    // Ex: $r3 vs $r30 - queremos detectar $r3, mas não como parte de $r30
-                    char nextChar = *(regPos + strlen(regPattern));
-                    if (nextChar == ' ' || nextChar == ',' || nextChar == '\n' || 
-                        nextChar == ')' || nextChar == '\0' || nextChar == '\r') {
-                        
-                        // Atualiza informações de uso do registrador
-                        if (!regUsage[i].isUsed) {
-                            regUsage[i].isUsed = 1;
-                            regUsage[i].firstUsedAt = lineNum;
-                            
-                            // Determinar finalidade baseado no registrador
-                            if (i == 0) strcpy(regUsage[i].purpose, "output");
-                            else if (i == 1) strcpy(regUsage[i].purpose, "stack pointer");
-                            else if (i == 2) strcpy(regUsage[i].purpose, "frame pointer");
-                            else if (i == 3) strcpy(regUsage[i].purpose, "input");
-                            else if (i >= 4 && i <= 30) strcpy(regUsage[i].purpose, "temporary local");
-                            else if (i == 31) strcpy(regUsage[i].purpose, "return address");
-                            else if (i >= 32 && i <= 42) strcpy(regUsage[i].purpose, "temporary global");
-                            else if (i >= 43 && i <= 44) strcpy(regUsage[i].purpose, "so aux");
-                            else if (i == 45) strcpy(regUsage[i].purpose, "return value");
-                            else if (i >= 46 && i <= 51) strcpy(regUsage[i].purpose, "argument");
-                            else if (i >= 52 && i <= 57) strcpy(regUsage[i].purpose, "param");
-                            else if (i == 58) strcpy(regUsage[i].purpose, "so_ra");
-                            else if (i == 59) strcpy(regUsage[i].purpose, "so_ap");
-                            else if (i >= 60) strcpy(regUsage[i].purpose, "so_tp");
-                            else if (i >= 61) strcpy(regUsage[i].purpose, "so_sp");
-                            else if (i == 62) strcpy(regUsage[i].purpose, "stack pointer offset");
-                            else if (i == 63) strcpy(regUsage[i].purpose, "zero constant");
-                        }
-                        
-                        regUsage[i].lastUsedAt = lineNum;
-                        regUsage[i].useCount++;
-                    }
-                }
+            if (!regUsage[i].isUsed) {
+                regUsage[i].isUsed = 1;
+                regUsage[i].firstUsedAt = lineNum;
+
+                // Determinar finalidade baseado no registrador
+                if (i == 0) strcpy(regUsage[i].purpose, "output");
+                else if (i == 1) strcpy(regUsage[i].purpose, "stack pointer");
+                else if (i == 2) strcpy(regUsage[i].purpose, "frame pointer");
+                else if (i == 3) strcpy(regUsage[i].purpose, "input");
+                else if (i >= 4 && i <= 30) strcpy(regUsage[i].purpose, "temporary local");
+                else if (i == 31) strcpy(regUsage[i].purpose, "return address");
+                else if (i >= 32 && i <= 42) strcpy(regUsage[i].purpose, "temporary global");
+                else if (i >= 43 && i <= 44) strcpy(regUsage[i].purpose, "so aux");
+                else if (i == 45) strcpy(regUsage[i].purpose, "return value");
+                else if (i >= 46 && i <= 51) strcpy(regUsage[i].purpose, "argument");
+                else if (i >= 52 && i <= 57) strcpy(regUsage[i].purpose, "param");
+                else if (i == 58) strcpy(regUsage[i].purpose, "so_ra");
+                else if (i == 59) strcpy(regUsage[i].purpose, "so_ap");
+                else if (i >= 60) strcpy(regUsage[i].purpose, "so_tp");
+                else if (i >= 61) strcpy(regUsage[i].purpose, "so_sp");
+                else if (i == 62) strcpy(regUsage[i].purpose, "stack pointer offset");
+                else if (i == 63) strcpy(regUsage[i].purpose, "zero constant");
             }
+
+            regUsage[i].lastUsedAt = lineNum;
+            regUsage[i].useCount++;
         }
     }
     
     // Imprime relatório de uso de registradores
-    printf("\n=== RELATÓRIO DE USO DE REGISTRADORES ===\n");
-    printf("Reg  | Nome | Usado | Primeira | Última | Contagem | Finalidade\n");
-    printf("-----+------+-------+----------+--------+----------+------------\n");
+    printInfo("\n=== RELATÓRIO DE USO DE REGISTRADORES ===");
+    printInfo("Reg  | Nome | Usado | Primeira | Última | Contagem | Finalidade");
+    printInfo("-----+------+-------+----------+--------+----------+------------");
     
     for (int i = 0; i < 64; i++) {
         if (regUsage[i].isUsed) {
-            printf("$r%-2d | %-4s | Sim   | %-8d | %-6d | %-8d | %s\n", 
+            printInfo("$r%-2d | %-4s | Sim   | %-8d | %-6d | %-8d | %s", 
                   i, regUsage[i].regName, regUsage[i].firstUsedAt-1, regUsage[i].lastUsedAt-1, 
                   regUsage[i].useCount, regUsage[i].purpose);
         }
     }
     
-    fclose(assemblyFile);
-    printf("\nAnálise de registradores concluída.\n");
+    printInfo("\nAnálise de registradores concluída.");
 }
 
 // Calcula o deslocamento de um parâmetro na pilha
@@ -478,40 +614,40 @@ int getParameterOffset(int paramIndex) {
 }
 
 // Carrega um parâmetro da pilha para um registrador
-void loadParameter(FILE* output, int paramIndex, int destReg, int* lineIndex) {
+void loadParameter(MachineCode* output, int paramIndex, int destReg) {
     int offset = (paramIndex + 2); // +2 para o endereço de retorno e o frame pointer salvo
-    fprintf(output, "%d - lw $r%d %d($r2)      # carrega param %d\n", (*lineIndex)++, destReg, offset, paramIndex);
+    emitMem(output, "lw", destReg, offset, 2, "carrega param %d", paramIndex);
     DEBUG_ASSEMBLY("DEBUG - loadParameter: Carregando parâmetro %d do offset %d para r%d\n", 
            paramIndex, offset, destReg);
 }
 
 // Salva o frame atual na entrada de uma função
-void setupFrame(FILE* output, int* lineIndex, int* stackOffset) {
+void setupFrame(MachineCode* output, int* stackOffset) {
     // Salva o endereço de retorno
-    pushRegister(output, 31, stackOffset, lineIndex);  // RA
+    pushRegister(output, 31, stackOffset);  // RA
     
     // Salva o frame pointer atual
-    pushRegister(output, 2, stackOffset, lineIndex);   // FP
+    pushRegister(output, 2, stackOffset);   // FP
     
     DEBUG_ASSEMBLY("DEBUG - setupFrame: Frame configurado, SP=%d, FP=SP\n", *stackOffset);
 }
 
 // Restaura o frame na saída de uma função
-void restoreFrame(FILE* output, int* lineIndex, int* stackOffset) {
+void restoreFrame(MachineCode* output, int* stackOffset) {
     // Restaura o stack pointer para o frame pointer atual
-    fprintf(output, "%d - move $r1 $r2         # restaura stack pointer\n", (*lineIndex)++);
+    emitMove(output, 1, 2, "restaura stack pointer");
     
     // Restaura o frame pointer antigo
-    popRegister(output, 2, stackOffset, lineIndex);    // FP
+    popRegister(output, 2, stackOffset);    // FP
     
     // Restaura o endereço de retorno
-    popRegister(output, 31, stackOffset, lineIndex);   // RA
+    popRegister(output, 31, stackOffset);   // RA
     
     DEBUG_ASSEMBLY("DEBUG - restoreFrame: Frame restaurado, SP=%d\n", *stackOffset);
 }
 
 // Aloca espaço para parâmetros de funções
-void allocateArgumentSpace(FILE* output, int argumentCount, int* lineIndex, int* stackOffset) {
+void allocateArgumentSpace(MachineCode* output, int argumentCount, int* stackOffset) {
     if (argumentCount > 0) {
         int totalSize = argumentCount;  // Cada parâmetro ocupa 4 bytes
         
@@ -525,41 +661,13 @@ void allocateArgumentSpace(FILE* output, int argumentCount, int* lineIndex, int*
 }
 
 // Função para contar quantos argumentos existem até encontrar uma chamada de função, para empilhar o último primeiro
-int countArgumentsUntilCall(FILE* inputFile, long currentPos) {
-    char buffer[256];
+int countArgumentsUntilCall(const Quadruple* q) {
     int count = 0;
-    long savedPos = ftell(inputFile); // Salva a posição atual no arquivo
-    
-    // Posiciona o ponteiro do arquivo na posição fornecida
-    fseek(inputFile, currentPos, SEEK_SET);
-    
-    // Lê as quádruplas até encontrar um CALL ou EOF
-    while (fgets(buffer, sizeof(buffer), inputFile) != NULL) {
-        // Ignora linhas de separação e cabeçalho
-        if (strstr(buffer, "---") != NULL || 
-            strstr(buffer, "Quad") != NULL ||
-            strlen(buffer) <= 1) {
-            continue;
-        }
-        
-        // Extrai o operador da quádrupla
-        char op[32] = "";
-        int line, sourceLine;
-        if (sscanf(buffer, "%d %d %s", &line, &sourceLine, op) < 3) {
-            continue;
-        }
-        
-        if (strcmp(op, "ARGUMENT") == 0) {
+    for (; q != NULL && q->op != OP_CALL; q = q->next) {
+        if (q->op == OP_ARGUMENT) {
             count++;
-        } else if (strcmp(op, "CALL") == 0) {
-            // Encontrou a chamada de função, termina a contagem
-            break;
         }
     }
-    
-    // Retorna à posição original no arquivo
-    fseek(inputFile, savedPos, SEEK_SET);
-    
     return count;
 }
 
@@ -582,30 +690,121 @@ void reiniciarRg(int r1){
     }
 }
 
-// Função principal para gerar o código assembly a partir do arquivo de entrada
-void generateAssembly(FILE* inputFile, int mode) {
-    FILE* output = fopen("Output/assembly.asm", "w");
+
+int divisaoPorDeslocamento = 0;
+
+// Retorna k se valor == 2^k, ou -1
+static int log2Exato(int valor) {
+    if (valor <= 0 || (valor & (valor - 1)) != 0) {
+        return -1;
+    }
+    int k = 0;
+    while ((1 << k) < valor) {
+        k++;
+    }
+    return k;
+}
+
+// Multiplicação por constante: escolhe pela tabela de custos entre li + mul e
+// sequências de deslocamento/soma (x+x, x*2^k, x*(2^k+1), x*(2^k-1)). rk é o registrador
+// reservado para a constante e pode receber a quantidade de deslocamento.
+static void emitMultConst(MachineCode* output, int rd, int rs, int rk, int valor, const char* destino) {
+    int custoMul = instructionCost("li") + instructionCost("mul");
+    int k;
+
+    if (valor == 0 && instructionCost("move") < custoMul) {
+        emitMove(output, rd, 63, "%s = x * 0", destino);
+    } else if (valor == 1 && instructionCost("move") < custoMul) {
+        emitMove(output, rd, rs, "%s = x * 1", destino);
+    } else if (valor == 2 && instructionCost("add") < custoMul) {
+        emitR(output, "add", rd, rs, rs, "%s = x * 2", destino);
+    } else if ((k = log2Exato(valor)) > 0 && instructionCost("li") + instructionCost("sl") < custoMul) {
+        emitLi(output, rk, k, NULL);
+        emitR(output, "sl", rd, rs, rk, "%s = x * %d", destino, valor);
+    } else if (rd != rs && (k = log2Exato(valor - 1)) > 0 &&
+               instructionCost("li") + instructionCost("sl") + instructionCost("add") < custoMul) {
+        emitLi(output, rk, k, NULL);
+        emitR(output, "sl", rd, rs, rk, NULL);
+        emitR(output, "add", rd, rd, rs, "%s = x * %d", destino, valor);
+    } else if (rd != rs && (k = log2Exato(valor + 1)) > 0 &&
+               instructionCost("li") + instructionCost("sl") + instructionCost("sub") < custoMul) {
+        emitLi(output, rk, k, NULL);
+        emitR(output, "sl", rd, rs, rk, NULL);
+        emitR(output, "sub", rd, rd, rs, "%s = x * %d", destino, valor);
+    } else {
+        emitLi(output, rk, valor, NULL);
+        emitR(output, "mul", rd, rs, rk, "salva em %s (r%d)", destino, rd);
+    }
+}
+
+// Divisão por constante: x / 1 e, com --div-shift (dividendo não negativo), x / 2^k com sr
+static void emitDivConst(MachineCode* output, int rd, int rs, int rk, int valor, const char* destino) {
+    int custoDiv = instructionCost("li") + instructionCost("div");
+    int k = log2Exato(valor);
+
+    if (valor == 1 && instructionCost("move") < custoDiv) {
+        emitMove(output, rd, rs, "%s = x / 1", destino);
+    } else if (divisaoPorDeslocamento && k > 0 && instructionCost("li") + instructionCost("sr") < custoDiv) {
+        emitLi(output, rk, k, NULL);
+        emitR(output, "sr", rd, rs, rk, "%s = x / %d", destino, valor);
+    } else {
+        emitLi(output, rk, valor, NULL);
+        emitR(output, "div", rd, rs, rk, "salva em %s (r%d)", destino, rd);
+    }
+}
+
+// Constante que cabe no imediato de 14 bits das instruções do tipo I (addi, subi, andi, ori)
+static int cabeNoImediato(int valor) {
+    return valor >= IMEDIATO_MIN && valor <= IMEDIATO_MAX;
+}
+
+// A constante carregada em temp é consumida pela próxima quádrupla como segundo operando
+// de uma operação que a seleção de instruções sabe especializar
+static int constanteEspecializavel(QuadrupleInfo* proxima, const char* temp, int valor) {
+    OperationType op = getOpTypeFromString(proxima->op);
+    if (strcmp(proxima->arg2, temp) != 0 || strcmp(proxima->arg1, temp) == 0) {
+        return 0;
+    }
+    return op == OP_MULT || op == OP_DIV ||
+           ((op == OP_ADD || op == OP_SUB) && cabeNoImediato(valor));
+}
+
+void initGlobalRegisterMap(GlobalRegisterMap* globais) {
+    for (int i = 0; i < GLOBAL_REGISTER_COUNT; i++) {
+        globais->nomes[i][0] = '\0';
+    }
+}
+
+// Inicialização do BCP, antes da primeira função (só no modo normal)
+void generatePrologue(int mode, MachineCode* output) {
+    if(mode == 1){
+        emitMove(output, 32, 1, "endereço bcp");
+        emitI(output, "subi", 1, 1, 70, "endereço bcp");
+    }
+}
+
+// Gera o código de uma faixa de quádruplas: uma função (FUNCTION até END) ou as
+// declarações globais até a próxima função. A função parte dos registradores das
+// globais em 'globais' e não muda o mapa; as declarações globais o atualizam.
+// Rótulos RDn começam em 0 (*retornos devolve quantos). Devolve a quádrupla seguinte.
+const Quadruple* generateRangeAssembly(const Quadruple* inicio, GlobalRegisterMap* globais, int primeiraFuncao,
+                                       MachineCode* output, int* retornos) {
     // Inicializa os mapeamentos de registradores
     initRegisterMappings();
+    for (int i = 0; i < GLOBAL_REGISTER_COUNT; i++) {
+        tempGlobalRegs[i].isUsed = globais->nomes[i][0] != '\0';
+        snprintf(tempGlobalRegs[i].varName, sizeof(tempGlobalRegs[i].varName), "%s", globais->nomes[i]);
+    }
+    int ehFuncao = inicio != NULL && inicio->op == OP_FUNCTION;
+    if (!ehFuncao) {
+        updateCurrentFunction("");  // declarações globais: nomes procurados no escopo global
+    }
     
     // Variável para controlar o deslocamento da pilha
     int stackOffset = 0;
-    
-    // Ignora o cabeçalho da tabela (4 linhas)
-    char buffer[256];
-    for (int i = 0; i < 4; i++) {
-        if (fgets(buffer, sizeof(buffer), inputFile) == NULL) {
-            fprintf(stderr, "Erro: Formato de arquivo inesperado.\n");
-            fclose(inputFile);
-            fclose(output);
-            return;
-        }
-    }
 
     QuadrupleInfo quad, nextQuad, nextNextQuad;
     //variáveis para controle de quádruplas
-    int lineIndex = 0;
-    long filePos;
     int argumentCount = 0;  
     int varLocalCount = 0;
     int varGlobalCount = 0;
@@ -616,46 +815,29 @@ void generateAssembly(FILE* inputFile, int mode) {
     int rvet; 
     int rindice;
     int rbase;
-    char* pularTemp = "";
     int addehone = 0;
     int r1comp;
-    int r2comp;
-    int pularJump = 0;
-    int proximoReturn = 0;
-    int labelCount = 0;
+    int r2comp = 63; // registrador da última comparação (63 = nenhum a liberar)
+    int retornoCount = 0; // rótulos RDn marcam o ponto de retorno das chamadas ao dispatcher
+    char tempConstante[50] = ""; // temporário cuja constante ainda não foi carregada (li adiado)
+    int valorConstante = 0;
     int saveinitialCount = 0;
     int loadinitialCount = 0;
     int savepktCount = 0;
     int loadpktCount = 0;
     int savenewinfoCount = 0;
-
-    if(mode == 1){
-        fprintf(output, "%d - move $r32 $r1 # endereço bcp\n", lineIndex++);
-        fprintf(output, "%d - subi $r1 $r1 70 # endereço bcp\n", lineIndex++);
-    }
                 
-    int ehPrimeiraFuncao = 1;
-
-    // Lê as quádruplas do arquivo e gera o código assembly
-    while (fgets(buffer, sizeof(buffer), inputFile) != NULL) {
-        // Ignora linhas de separação e cabeçalho
-        if (strstr(buffer, "---") != NULL || 
-            strstr(buffer, "Quad") != NULL ||
-            strlen(buffer) <= 1) {
-            continue;
-        }
-
-        // Inicializa com valores padrão
-        quad.line = 0;
-        quad.sourceLine = 0;
-        strcpy(quad.op, "");
-        strcpy(quad.arg1, "-");
-        strcpy(quad.arg2, "-");
-        strcpy(quad.result, "-");
+    int ehPrimeiraFuncao = primeiraFuncao;
+    const Quadruple* fim = NULL;
 
-        // Analisa a linha para extrair os campos da quádrupla
-        sscanf(buffer, "%d %d %s %s %s %s",
-               &quad.line, &quad.sourceLine, quad.op, quad.arg1, quad.arg2, quad.result);
+    // Percorre as quádruplas e gera o código assembly
+    for (const Quadruple* atual = inicio; atual != NULL; atual = atual->next) {
+        if (!ehFuncao && atual->op == OP_FUNCTION) {
+            fim = atual;  // fim das declarações globais
+            break;
+        }
+        readQuadruple(atual, &quad);
+        output->sourceLine = quad.sourceLine;  // para a tabela de linhas (-g)
 
         // Atualiza a função atual quando encontra uma definição de função
         if (strcmp(quad.op, "FUNCTION") == 0) {
@@ -664,13 +846,24 @@ void generateAssembly(FILE* inputFile, int mode) {
             argumentCount = 0;  
             varLocalCount = 0;  
             paramCount = 0; 
-    
         }
 
         // Processa a quádrupla lida, para saber o operador e os index
         OperationType opType = getOpTypeFromString(quad.op);
+        if (opType == OP_COUNT) {
+            // --instrument: contador do bloco no endereço absoluto; r43 só leva destinos de salto
+            // e está livre no início de um bloco
+            int endereco = atoi(quad.arg1);
+            emitMem(output, "lw", 43, endereco, 63, "contador do bloco");
+            emitI(output, "addi", 43, 43, 1, NULL);
+            emitMem(output, "sw", 43, endereco, 63, NULL);
+            continue;
+        }
         int r1 = strcmp(quad.arg1, "-") != 0 ? getRegisterIndex(quad.arg1) : 0;
-        int r2 = strcmp(quad.arg2, "-") != 0 ? getRegisterIndex(quad.arg2) : 0;
+        // segundo operando constante de add/sub vai no imediato (addi/subi), sem registrador
+        int constanteImediata = tempConstante[0] != '\0' && strcmp(quad.arg2, tempConstante) == 0 &&
+                                (opType == OP_ADD || opType == OP_SUB);
+        int r2 = strcmp(quad.arg2, "-") != 0 && !constanteImediata ? getRegisterIndex(quad.arg2) : 0;
         int r3 = strcmp(quad.result, "-") != 0 ? getRegisterIndex(quad.result) : 0;
 
         // Para operações de comparação, olha a próxima quádrupla para otimizar
@@ -678,12 +871,14 @@ void generateAssembly(FILE* inputFile, int mode) {
             opType == OP_LTE || opType == OP_GTE) {
             
             // Verifica a próxima quádrupla para ver se é um salto condicional
-            checkNextQuadruple(inputFile, &filePos, &nextQuad);
+            checkNextQuadruple(atual, &nextQuad);
             OperationType nextOpType = getOpTypeFromString(nextQuad.op);
             
             // Se a próxima op for um salto condicional, otimiza para um único jump
             if (nextOpType == OP_JUMPFALSE || nextOpType == OP_JUMPTRUE) {
-                fprintf(output, "%d - addil $r43 $r44 %s\n", lineIndex++, nextQuad.result);
+                if (desvioLongo) {
+                    emitAddil(output, 43, 44, nextQuad.result, NULL);
+                }
                     
                 switch (opType) {
                     case OP_EQ:
@@ -693,12 +888,10 @@ void generateAssembly(FILE* inputFile, int mode) {
                                 quad.arg1, r1, quad.arg2, r2);
                             
                             // Se EQ é falso (valores diferentes), pula para o label
-                            fprintf(output, "%d - bnq $r%d $r%d %s # jump se %s != %s\n", 
-                                    lineIndex++, r1, r2, nextQuad.result, quad.arg1, quad.arg2);
+                            emitBranch(output, "bnq", r1, r2, nextQuad.result, "jump se %s != %s", quad.arg1, quad.arg2);
                         } else { // JUMPTRUE
                             // Se EQ é verdadeiro (valores iguais), pula para o label
-                            fprintf(output, "%d - beq $r%d $r%d %s # jump se %s == %s\n", 
-                                    lineIndex++, r1, r2, nextQuad.result, quad.arg1, quad.arg2);
+                            emitBranch(output, "beq", r1, r2, nextQuad.result, "jump se %s == %s", quad.arg1, quad.arg2);
                         }
                         r1comp = r1;
                         r2comp = r2;
@@ -707,12 +900,10 @@ void generateAssembly(FILE* inputFile, int mode) {
                     case OP_NEQ:
                         if (nextOpType == OP_JUMPFALSE) {
                             // Se NEQ é falso (valores iguais), pula para o label
-                            fprintf(output, "%d - beq $r%d $r%d %s # jump se ==\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "beq", r1, r2, nextQuad.result, "jump se ==");
                         } else { // JUMPTRUE
                             // Se NEQ é verdadeiro (valores diferentes), pula para o label
-                            fprintf(output, "%d - bnq $r%d $r%d %s # jump se !=\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "bnq", r1, r2, nextQuad.result, "jump se !=");
                         }
                         r1comp = r1;
                         r2comp = r2;
@@ -721,12 +912,10 @@ void generateAssembly(FILE* inputFile, int mode) {
                     case OP_LT:
                         if (nextOpType == OP_JUMPFALSE) {
                             // Se LT é falso (>=), pula para o label
-                            fprintf(output, "%d - bge $r%d $r%d %s # jump >=\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "bge", r1, r2, nextQuad.result, "jump >=");
                         } else { // JUMPTRUE
                             // Se LT é verdadeiro (<), pula para o label
-                            fprintf(output, "%d - blt $r%d $r%d %s #jump se <\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "blt", r1, r2, nextQuad.result, "jump se <");
                         }
                         r1comp = r1;
                         r2comp = r2;
@@ -735,12 +924,10 @@ void generateAssembly(FILE* inputFile, int mode) {
                     case OP_GT:
                         if (nextOpType == OP_JUMPFALSE) {
                             // Se GT é falso (<=), pula para o label
-                            fprintf(output, "%d - ble $r%d $r%d %s # jump se <=\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "ble", r1, r2, nextQuad.result, "jump se <=");
                         } else { // JUMPTRUE
                             // Se GT é verdadeiro (>), pula para o label
-                            fprintf(output, "%d - bgt $r%d $r%d %s # jump se >\n",
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "bgt", r1, r2, nextQuad.result, "jump se >");
                         }
                         r1comp = r1;
                         r2comp = r2;
@@ -749,12 +936,10 @@ void generateAssembly(FILE* inputFile, int mode) {
                     case OP_LTE:  // <=
                         if (nextOpType == OP_JUMPFALSE) {
                             // Se BLTE é falso (>), pula para o label
-                            fprintf(output, "%d - bgt $r%d $r%d %s # jump se >\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "bgt", r1, r2, nextQuad.result, "jump se >");
                         } else { // JUMPTRUE
                             // Se BLTE é verdadeiro (<=), pula para o label
-                            fprintf(output, "%d - ble $r%d $r%d %s # jump se <=\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "ble", r1, r2, nextQuad.result, "jump se <=");
                         }
                         r1comp = r1;
                         r2comp = r2;
@@ -763,24 +948,24 @@ void generateAssembly(FILE* inputFile, int mode) {
                     case OP_GTE:  // >=
                         if (nextOpType == OP_JUMPFALSE) {
                             // Se BGTE é falso (<), pula para o label
-                            fprintf(output, "%d - blt $r%d $r%d %s # jump se <\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "blt", r1, r2, nextQuad.result, "jump se <");
                         } else { // JUMPTRUE
                             // Se BGTE é verdadeiro (>=), pula para o label
-                            fprintf(output, "%d - bge $r%d $r%d %s # jump se >=\n", 
-                                    lineIndex++, r1, r2, nextQuad.result);
+                            emitBranch(output, "bge", r1, r2, nextQuad.result, "jump se >=");
                         }
                         r1comp = r1;
                         r2comp = r2;
                         break;
                         default:
-                            fprintf(output, "%d - ; operação relacional não suportada\n", lineIndex++);
+                            emitComment(output, "operação relacional não suportada");
                             break;
                 }
                 
                 // Avança para consumir a próxima quadrupla (JUMPFALSE/JUMPTRUE)
                 // já que ela foi processada em conjunto com a operação de comparação
-                fgets(buffer, sizeof(buffer), inputFile);
+                if (atual->next != NULL) {
+                    atual = atual->next;
+                }
                 continue;
             } 
             continue;
@@ -789,12 +974,20 @@ void generateAssembly(FILE* inputFile, int mode) {
         // Se estamos carregando uma constante
         if (strcmp(quad.op, "ASSIGN") == 0){
             if(isdigit(quad.arg1[0])) {
-                fprintf(output, "%d - li $r%d %s\n", lineIndex++, r3, quad.arg1);
-                reiniciarRg(r1);
-                checkNextQuadruple(inputFile, &filePos, &nextQuad);
-                if(strcmp(nextQuad.op,"RETURN")== 0){
-                    proximoReturn = 1;
+                // Constante usada só pela próxima operação: a seleção de instruções decide como carregá-la
+                checkNextQuadruple(atual, &nextQuad);
+                if (constanteEspecializavel(&nextQuad, quad.result, atoi(quad.arg1))) {
+                    strcpy(tempConstante, quad.result);
+                    valorConstante = atoi(quad.arg1);
+                    reiniciarRg(r1);
+                    OperationType consumidor = getOpTypeFromString(nextQuad.op);
+                    if (consumidor == OP_ADD || consumidor == OP_SUB) {
+                        reiniciarRg(r3); // vai no imediato, não precisa de registrador
+                    }
+                    continue;
                 }
+                emitLoad(output, r3, quad.arg1, NULL);
+                reiniciarRg(r1);
                 
                 continue;
             }
@@ -805,29 +998,21 @@ void generateAssembly(FILE* inputFile, int mode) {
                 // Verifica se é uma movimentação redundante (mesmo registrador fonte e destino)
                 if (r3 == 44 || r3 == 59 || r3 == 60 || r3 == 58 || r3 == 62 || r3 == 41 || r3 == 42 || r3 == 43 || r3 == 51 || r3 == 57 || r3 == 30 || r3 == 39) {
                     // Força o uso de 'move' para atribuir valor diretamente a esses registradores
-                    fprintf(output, "%d - move $r%d $r%d # movendo %s para registrador especial %s\n", lineIndex++, r3, r1, quad.arg1, quad.result);
+                    emitMove(output, r3, r1, "movendo %s para registrador especial %s", quad.arg1, quad.result);
                 } 
                 else if (r1 == 44 || r1 == 59 || r1 == 60 || r1 == 58 || r1 == 62 || r1 == 41 || r1 == 42 || r1 == 43 || r1 == 51 || r1 == 57 || r1 == 30 || r1 == 39) {
                     // Força o uso de 'move' para atribuir valor diretamente a esses registradores
-                    fprintf(output, "%d - move $r%d $r%d # movendo %s para registrador especial %s\n", lineIndex++, r3, r1, quad.arg1, quad.result);
+                    emitMove(output, r3, r1, "movendo %s para registrador especial %s", quad.arg1, quad.result);
                 } 
                 else if (r1 != r3) {
                     if (((r1 > 3 && r1 < 31) || (r1 > 31 && r1 < 41)||(r1 >= 58 && r1 <= 62)) && (quad.result[0] == 't' && isdigit(quad.result[1]))){
-                        fprintf(output, "%d - lw $r%d 0($r%d) # movendo %s para %s\n", lineIndex++, r3, r1, quad.arg1, quad.result); 
-                        checkNextQuadruple(inputFile, &filePos, &nextQuad);
-                        if(strcmp(nextQuad.op,"RETURN")== 0){
-                            proximoReturn = 1;
-                        }
+                        emitMem(output, "lw", r3, 0, r1, "movendo %s para %s", quad.arg1, quad.result); 
                     }
                     else if (((r3 > 3 && r3 < 31) || (r3 > 31 && r3 < 41) ||(r3 >= 59 && r3 <= 62)) && (quad.arg1[0] == 't' && isdigit(quad.arg1[1]))) {
-                        fprintf(output, "%d - sw $r%d 0($r%d) # movendo %s para %s\n", lineIndex++, r1, r3, quad.arg1, quad.result);
+                        emitMem(output, "sw", r1, 0, r3, "movendo %s para %s", quad.arg1, quad.result);
                     }
                     else {
-                        fprintf(output, "%d - move $r%d $r%d # movendo %s para %s\n", lineIndex++, r3, r1, quad.arg1, quad.result);
-                        checkNextQuadruple(inputFile, &filePos, &nextQuad);
-                        if(strcmp(nextQuad.op,"RETURN")== 0){
-                            proximoReturn = 1;
-                        }
+                        emitMove(output, r3, r1, "movendo %s para %s", quad.arg1, quad.result);
                     }
                     if(quad.arg1[0] == 't' && isdigit(quad.arg1[1])){
                         reiniciarRg(r1);
@@ -837,43 +1022,55 @@ void generateAssembly(FILE* inputFile, int mode) {
                 break;
 
             case OP_ADD:
-                // printf("addehone = %d\n", addehone);
-                // printf("pularTempoi = %s\n", pularTemp);
-                // printf("quad.arg2 = %s\n", quad.arg2);
-                fprintf(output, "%d - add $r%d $r%d $r%d # salva em %s (r%d) \n", lineIndex++, r3, r1, r2, quad.result, r3);
+                if (constanteImediata) {
+                    emitI(output, "addi", r3, r1, valorConstante, "salva em %s (r%d)", quad.result, r3);
+                    tempConstante[0] = '\0';
+                } else {
+                    emitR(output, "add", r3, r1, r2, "salva em %s (r%d)", quad.result, r3);
+                }
                 reiniciarRg(r1);
                 reiniciarRg(r2);
-                checkNextQuadruple(inputFile, &filePos, &nextQuad);
-                if(strcmp(nextQuad.op,"RETURN")== 0){
-                    proximoReturn = 1;
-                }            
                 break;
 
             case OP_SUB:
-                // Se o segundo operando é a constante "1", usar diretamente $r61 (que já contém o valor 1)
-                fprintf(output, "%d - sub $r%d $r%d $r%d # salva em %s (r%d) \n", lineIndex++, r3, r1, r2, quad.result, r3);
+                // Constante pequena como segundo operando vai direto no imediato do subi
+                if (constanteImediata) {
+                    emitI(output, "subi", r3, r1, valorConstante, "salva em %s (r%d)", quad.result, r3);
+                    tempConstante[0] = '\0';
+                } else {
+                    emitR(output, "sub", r3, r1, r2, "salva em %s (r%d)", quad.result, r3);
+                }
                 reiniciarRg(r1);
                 reiniciarRg(r2);
                 
                 break;
 
             case OP_MULT:
-                fprintf(output, "%d - mul $r%d $r%d $r%d # salva em %s (r%d) \n", lineIndex++, r3, r1, r2, quad.result, r3);
+                if (strcmp(quad.arg2, tempConstante) == 0) {
+                    emitMultConst(output, r3, r1, r2, valorConstante, quad.result);
+                    tempConstante[0] = '\0';
+                } else {
+                    emitR(output, "mul", r3, r1, r2, "salva em %s (r%d)", quad.result, r3);
+                }
                 reiniciarRg(r1);
                 reiniciarRg(r2);
                 break;
 
             case OP_DIV:
-                fprintf(output, "%d - div $r%d $r%d $r%d # salva em %s (r%d) \n", lineIndex++, r3, r1, r2, quad.result, r3);
+                if (strcmp(quad.arg2, tempConstante) == 0) {
+                    emitDivConst(output, r3, r1, r2, valorConstante, quad.result);
+                    tempConstante[0] = '\0';
+                } else {
+                    emitR(output, "div", r3, r1, r2, "salva em %s (r%d)", quad.result, r3);
+                }
                 reiniciarRg(r1);
                 reiniciarRg(r2);
                 break;
 
             case OP_LABEL:
-                labelCount  = labelCount + 1;
-                checkNextQuadruple(inputFile, &filePos, &nextQuad);
+                checkNextQuadruple(atual, &nextQuad);
                    
-                    fprintf(output, "%d - %s: #Nova Label %s\n", lineIndex++, quad.result, quad.result);
+                    emitLabel(output, quad.result, "Nova Label %s", quad.result);
                     // reiniciarRg(r1comp);
                     if(r2comp != 63){
                         reiniciarRg(r2comp);
@@ -882,70 +1079,56 @@ void generateAssembly(FILE* inputFile, int mode) {
                     break;
 
             case OP_JUMP:
-                if(pularJump == 0){
-                    fprintf(output, "%d - addil $r43 $r44 %s\n", lineIndex++, quad.result);
-                    fprintf(output, "%d - j %s\n", lineIndex++, quad.result);
-                }
-                else {
-                    pularJump = 0;
-                }
+                // o salto logo após um return é inalcançável e é removido pelo peephole
+                emitAddil(output, 43, 44, quad.result, NULL);
+                emitJump(output, "j", quad.result, NULL);
                 break;
 
             case OP_JUMPFALSE:
                 // Jump se o valor é falso (igual a zero)
-                fprintf(output, "%d - beq $r%d $r63 %s # jump se é falso\n", 
-                        lineIndex++, r1, quad.result);
+                emitBranch(output, "beq", r1, 63, quad.result, "jump se é falso");
                 r1comp = r1;
                 r2comp = 63;
                 break;
 
             case OP_JUMPTRUE:
                 // Jump se o valor é verdadeiro (diferente de zero)
-                fprintf(output, "%d - bnq $r%d $r63 %s # jump se é verdadeiro\n", 
-                        lineIndex++, r1, quad.result);
+                emitBranch(output, "bnq", r1, 63, quad.result, "jump se é verdadeiro");
                 r1comp = r1;
                 r2comp = 63;
                 break;
 
             case OP_FUNCTION:
-                labelCount  = labelCount + 1;
                 reinitRegisterMappings(); // Reinicia os mapeamentos de registradores
                 
                 if(ehPrimeiraFuncao){
-                    if(strcmp(quad.arg1,"dispatcherloadnpremp")!=0 && strcmp(quad.arg1,"dispatchersavenpremp")!=0 && strcmp(quad.arg1,"dispatchersavepprog")!=0 && strcmp(quad.arg1,"dispatchersavepremp")!=0){
-                        fprintf(output, "%d - addil $r43 $r44 main\n", lineIndex++);
-                        fprintf(output, "%d - j main\n", lineIndex++); //começa na main
+                    output->sourceLine = 0; // o salto inicial para a main não é da função
+                    if(!isDispatcherEntry(quad.arg1)){
+                        emitAddil(output, 43, 44, "main", NULL);
+                        emitJump(output, "j", "main", NULL); //começa na main
                         ehPrimeiraFuncao = 0; // marca que já processou a primeira função
                     }
                     else{
-                        if(strcmp(quad.arg1,"dispatchersavenpremp")==0){
-                            fprintf(output, "%d - li $r39 1001\n", lineIndex++);    
-                        }
-                        else if(strcmp(quad.arg1,"dispatcherloadnpremp")==0){
-                            fprintf(output, "%d - li $r39 1201\n", lineIndex++);                                
-                        }
-                        else if(strcmp(quad.arg1,"dispatchersavepprog")==0){
-                            fprintf(output, "%d - li $r39 1401\n", lineIndex++);                                
-                        }
-                        else if(strcmp(quad.arg1,"dispatchersavepremp")==0){
-                            fprintf(output, "%d - li $r39 1601\n", lineIndex++);                                
-                        }
-                        
-                        fprintf(output, "%d - addil $r43 $r39 main\n", lineIndex++, quad.arg1);
-                        fprintf(output, "%d - j main\n", lineIndex++, quad.arg1);
+                        // r39 recebe o endereço de carga da própria imagem do dispatcher
+                        char baseImagem[64];
+                        snprintf(baseImagem, sizeof(baseImagem), "%c%s", EXTERNAL_SYMBOL_PREFIX, quad.arg1);
+                        emitLoad(output, 39, baseImagem, NULL);
+
+                        emitAddil(output, 43, 39, "main", NULL);
+                        emitJump(output, "j", "main", NULL);
                     
                         ehPrimeiraFuncao = 0; // marca que já processou a primeira função
                     }
-
+                    output->sourceLine = quad.sourceLine;
                 }
-                fprintf(output, "%d - %s: # nova função %s\n", lineIndex++, quad.arg1, quad.arg1);
+                emitFunctionLabel(output, quad.arg1, "nova função %s", quad.arg1);
                 // fprintf(output, "%d - out $r1 # define o início da função\n", lineIndex++);
                 // Configura o frame da função usando nossa nova função
-                if(strcmp(currentFunction, "main") != 0 && strcmp(quad.arg1,"dispatcherloadnpremp")!=0 && strcmp(quad.arg1,"dispatchersavenpremp")!=0 && strcmp(quad.arg1,"dispatchersavepprog")!=0 && strcmp(quad.arg1,"dispatchersavepremp")!=0){
-                    setupFrame(output, &lineIndex, &stackOffset);
+                if(strcmp(currentFunction, "main") != 0 && !isDispatcherEntry(quad.arg1)){
+                    setupFrame(output, &stackOffset);
                     
-                    checkNextQuadruple(inputFile, &filePos, &nextQuad);
-                    fprintf(output, "%d - move $r2 $r1         # fp = sp\n", lineIndex++);
+                    checkNextQuadruple(atual, &nextQuad);
+                    emitMove(output, 2, 1, "fp = sp");
                     
                     // Aloca espaço para parâmetros no início da função
                     // Será atualizado quando encontrarmos todos os parâmetros
@@ -956,39 +1139,35 @@ void generateAssembly(FILE* inputFile, int mode) {
                 break;
 
             case OP_RETURN:
-                // Carrega valor de retorno em v0 (r45)
-                if (r1 < 45 && proximoReturn==0) { // Evita move redundante se o valor já estiver em v0
-                    fprintf(output, "%d - lw $r45 0($r%d) # move valor de retorno para v0\n", lineIndex++, r1);
+                // Carrega valor de retorno em v0 (r45): temporários e parâmetros já guardam o valor,
+                // variáveis guardam o endereço
+                if (r1 < 45 && !(quad.arg1[0] == 't' && isdigit(quad.arg1[1]))) {
+                    emitMem(output, "lw", 45, 0, r1, "move valor de retorno para v0");
                 }
                 else{
-                    fprintf(output, "%d - move $r45 $r%d # move valor de retorno para v0\n", lineIndex++, r1);   
-                    proximoReturn=0;
+                    emitMove(output, 45, r1, "move valor de retorno para v0");   
                 }
                 
                 // Restaura o frame usando nossa nova função
-                restoreFrame(output, &lineIndex, &stackOffset);
-                fprintf(output, "%d - jr $r31         # retorna\n", lineIndex++);
-                checkNextQuadruple(inputFile, &filePos, &nextQuad);
-                if(strcmp(nextQuad.op,"JUMP")== 0){
-                     pularJump = 1;
-                }
+                restoreFrame(output, &stackOffset);
+                emitReg(output, "jr", 31, "retorna");
                 break;
 
             case OP_END:
-                if (strcmp(currentFunction, "main") != 0 && strcmp(quad.arg1,"dispatcherloadnpremp")!=0 && strcmp(quad.arg1,"dispatchersavenpremp")!=0 && strcmp(quad.arg1,"dispatchersavepprog")!=0 && strcmp(quad.arg1,"dispatchersavepremp")!=0) {
+                if (strcmp(currentFunction, "main") != 0 && !isDispatcherEntry(quad.arg1)) {
                     BucketList funcSymbol = st_lookup_in_scope(currentFunction, "global");
                     int isVoidFunction = (funcSymbol && strcmp(funcSymbol->dataType, "void") == 0);
                     if (isVoidFunction) {
-                        restoreFrame(output, &lineIndex, &stackOffset);
-                        fprintf(output, "%d - move $r0 $r0\n", lineIndex++);
-                        fprintf(output, "%d - jr $r31         # retorna (void function end)\n", lineIndex++);
+                        restoreFrame(output, &stackOffset);
+                        emitMove(output, 0, 0, NULL);
+                        emitReg(output, "jr", 31, "retorna (void function end)");
                     }
                 }
             break;
 
             case OP_ARGUMENT: 
                 {
-                    checkNextQuadruple(inputFile, &filePos, &nextQuad);
+                    checkNextQuadruple(atual, &nextQuad);
                     int argumentNum = atoi(quad.arg2);
                     int destReg = 46 + argumentNum; // a0, a1, etc.
                     // Verifica se o argumento é uma variável local (armazenada na memória)
@@ -1006,13 +1185,11 @@ void generateAssembly(FILE* inputFile, int mode) {
                     
                     // Verifica se é o primeiro argumento (arg0) e conta o total até o CALL
                     if (argumentNum == 0) {
-                        long currentPos = ftell(inputFile);
-                        int totalArgs = countArgumentsUntilCall(inputFile, currentPos);
-                        checkNextNextQuadruple(inputFile, &filePos, &nextQuad, &nextNextQuad);
+                        int totalArgs = countArgumentsUntilCall(atual->next);
+                        checkNextNextQuadruple(atual, &nextQuad, &nextNextQuad);
                         if(strcmp(nextQuad.arg1,"output") !=0 && strcmp(nextQuad.arg1,"msgLcd")!=0 && strcmp(nextQuad.arg1,"saltoUser")!=0  && strcmp(nextNextQuad.arg1,"saveword") !=0 && strcmp(nextQuad.arg1,"loadword")!=0){
                             // Aloca espaço para todos os argumentos de uma vez
-                            fprintf(output, "%d - subi $r1 $r1 %d  # aloca espaço para %d argumentos\n", 
-                                    lineIndex++, (totalArgs+1), totalArgs+1);
+                            emitI(output, "subi", 1, 1, (totalArgs+1), "aloca espaço para %d argumentos", totalArgs+1);
                             stackOffset -= ((totalArgs+1));
                             
                             DEBUG_ASSEMBLY("DEBUG - OP_ARGUMENT: Alocados %d bytes para %d argumentos\n", 
@@ -1022,14 +1199,13 @@ void generateAssembly(FILE* inputFile, int mode) {
                     
                     //se o argumento é uma constante, carrega o valor em um registrador primeiro
                     if (isdigit(quad.arg1[0])) {
-                        fprintf(output, "%d - li $r%d %s # argument %d (%s)\n", lineIndex++, destReg, quad.arg1, argumentNum, quad.arg1);
+                        emitLoad(output, destReg, quad.arg1, "argument %d (%s)", argumentNum, quad.arg1);
                     }
                     // Se o argumento é uma variável local, precisamos carregar seu valor da memória
                     else if (symbol != NULL && strcmp(symbol->idType, "var") == 0 && strcmp(nextQuad.arg1,"saltoUser") !=0) {  
                         // Primeiro carrega o valor da memória 
                         // Carrega o endereço da variável (que já está em r1) para o registrador de argumento
-                        fprintf(output, "%d - lw $r%d 0($r%d)    # carrega valor da variável local '%s' para argument %d\n", 
-                                lineIndex++, destReg, r1, quad.arg1, argumentNum);
+                        emitMem(output, "lw", destReg, 0, r1, "carrega valor da variável local '%s' para argument %d", quad.arg1, argumentNum);
                     } 
                     //precisa ver a variavel global varglobalcount $gp 62
                     
@@ -1038,23 +1214,19 @@ void generateAssembly(FILE* inputFile, int mode) {
   
                         if (destReg != r1) {
                             if((r1 > 31 && r1 < 40) && (symbol != NULL && symbol->isArray != 1)){
-                                fprintf(output, "%d - lw $r%d 0($r%d) # argument %d - (%s)\n", 
-                                        lineIndex++, destReg, r1, argumentNum, quad.arg1);
+                                emitMem(output, "lw", destReg, 0, r1, "argument %d - (%s)", argumentNum, quad.arg1);
                             }
                             else{
                                 if(strcmp(nextQuad.arg1,"saltoUser") !=0){
-                                    fprintf(output, "%d - move $r%d $r%d # argument %d (%s)\n", 
-                                            lineIndex++, destReg, r1, argumentNum, quad.arg1);
+                                    emitMove(output, destReg, r1, "argument %d (%s)", argumentNum, quad.arg1);
                                 }
                             }
                         } else {
-                            fprintf(output, "%d - # argument (%d) %s já está em $r%d\n", 
-                                    lineIndex++, argumentNum, quad.arg1, destReg);
+                            emitComment(output, "argument (%d) %s já está em $r%d", argumentNum, quad.arg1, destReg);
                         }
                     }
                     if(strcmp(nextQuad.arg1,"output") !=0 && strcmp(nextQuad.arg1,"halt") !=0 && strcmp(nextQuad.arg1,"saltoUser") !=0 && strcmp(nextQuad.arg1,"msgLcd") !=0 && strcmp(nextQuad.arg1,"loadword") !=0 && strcmp(nextNextQuad.arg1,"saveword") !=0){
-                        fprintf(output, "%d - sw $r%d %d($r1)  # salva argument %d na pilha\n", 
-                                lineIndex++, destReg, argumentNum, argumentNum);
+                        emitMem(output, "sw", destReg, argumentNum, 1, "salva argument %d na pilha", argumentNum);
                     }
                 }
                 break;
@@ -1065,172 +1237,154 @@ void generateAssembly(FILE* inputFile, int mode) {
                 parameters[paramCount] = r1; // Armazena o nome do parâmetro
                 // printf("parametro %d, index %d\n", parameters[paramCount], paramCount);
                 // printf("quad.arg1 %s\n", quad.arg1);
-                loadParameter(output, paramCount++, r1, &lineIndex);
-                checkNextQuadruple(inputFile, &filePos, &nextQuad);
+                loadParameter(output, paramCount++, r1);
+                checkNextQuadruple(atual, &nextQuad);
                 break;
 
             case OP_CALL:
                 if (strcmp(quad.arg1, "input") == 0) {
                     // input() → in $rX
-                    fprintf(output, "%d - in $r3\n", lineIndex++);
+                    emitReg(output, "in", 3, NULL);
                     if(quad.result[0] == 't'){
                         tempLocalRegs[r3-4].isUsed = 1;
-                        fprintf(output, "%d - move $r%d $r3 # move valor de input para %s\n", 
-                                lineIndex++, r3, quad.result);
+                        emitMove(output, r3, 3, "move valor de input para %s", quad.result);
                     } else {
-                        fprintf(output, "%d - sw $r3 0($r%d) # armazena em %s\n", 
-                             lineIndex++, r3, quad.result);
+                        emitMem(output, "sw", 3, 0, r3, "armazena em %s", quad.result);
                     }
                 } else if (strcmp(quad.arg1, "output") == 0) {
                     // Para output, usamos o registro do parâmetro passado (a0)
-                    fprintf(output, "%d - move $r0 $r46\n", lineIndex++); // out r0 (registrador reservado para output)
-                    fprintf(output, "%d - out $r0\n", lineIndex++); // out r0 (registrador reservado para output)
+                    emitMove(output, 0, 46, NULL); // out r0 (registrador reservado para output)
+                    emitReg(output, "out", 0, NULL); // out r0 (registrador reservado para output)
                     // fprintf(output, "%d - addi $r1 $r1 1 # desaloca espaço na pilha\n", lineIndex++);
                 } else if (strcmp(quad.arg1, "msgLcd") == 0){
-                    fprintf(output, "%d - msgLcd $r%d\n", 
-                            lineIndex++, 46); // talvez mudar para pegar do regs
+                    emitReg(output, "msgLcd", 46, NULL); // talvez mudar para pegar do regs
                 } else if (strcmp(quad.arg1, "halt") == 0){
-                    fprintf(output, "%d - halt # termina a execução\n", lineIndex++);
+                    emitHalt(output, "termina a execução");
                 } else if (strcmp(quad.arg1, "nop") == 0){
-                    fprintf(output, "%d - nop 0\n", lineIndex++);
+                    emitNop(output, 0, NULL);
                 } else if (strcmp(quad.arg1, "saltoUser") == 0){
-                    fprintf(output, "%d - addil $r43 $r44 0\n", lineIndex++); //r referente ao salto
-                    fprintf(output, "%d - move $r1 $r62 # carrega o destino do salto\n", lineIndex++);
-                    fprintf(output, "%d - saltoUser $r%d # usar o dado1 para o salto_rom\n", 
-                            lineIndex++, 44); //r referente ao salto
+                    emitAddil(output, 43, 44, "0", NULL); //r referente ao salto
+                    emitMove(output, 1, 62, "carrega o destino do salto");
+                    emitReg(output, "saltoUser", 44, "usar o dado1 para o salto_rom"); //r referente ao salto
                 
                 }  else if (strcmp(quad.arg1, "saltoSO") == 0){
-                    fprintf(output, "%d - li $r51 1\n", lineIndex++);
-                    fprintf(output, "%d - syscall $r58\n", lineIndex++); 
+                    emitLi(output, 51, 1, NULL);
+                    emitReg(output, "syscall", 58, NULL); 
                 }  
                 else if (strcmp(quad.arg1, "retornoSO") == 0){
-                    fprintf(output, "%d - syscall $r58\n", lineIndex++); 
+                    emitReg(output, "syscall", 58, NULL); 
                 }  
                 else if (strcmp(quad.arg1, "dispatchersavenp") == 0){
-                    fprintf(output, "%d - move $r42 $r1 # salva a posição de memoria\n", lineIndex++); //r referente ao destino do salto  
-                    fprintf(output, "%d - move $r1 $r40\n", lineIndex++); //r referente ao salto
-                    fprintf(output, "%d - li $r58 %d \n", lineIndex++, (lineIndex)-labelCount+3); //r referente ao salto
-                    fprintf(output, "%d - li $r43 1001\n", lineIndex++);
-                    fprintf(output, "%d - j 1001\n", lineIndex++);
+                    emitMove(output, 42, 1, "salva a posição de memoria"); //r referente ao destino do salto  
+                    emitMove(output, 1, 40, NULL); //r referente ao salto
+                    emitDispatcherJump(output, "dispatchersavenpremp", retornoCount++);
                 }
                 else if (strcmp(quad.arg1, "dispatcherloadnp") == 0){
-                    fprintf(output, "%d - move $r1 $r40 # carrega o valor salvo\n", lineIndex++); //r referente ao salto
-                    fprintf(output, "%d - li $r58 %d \n", lineIndex++, (lineIndex)-labelCount+3); //r referente ao salto
-                    fprintf(output, "%d - li $r43 1201\n", lineIndex++);
-                    fprintf(output, "%d - j 1201\n", lineIndex++);
-                    fprintf(output, "%d - move $r1 $r42 # carrega a posição de memoria\n", lineIndex++); //r referente ao destino do salto  
+                    emitMove(output, 1, 40, "carrega o valor salvo"); //r referente ao salto
+                    emitDispatcherJump(output, "dispatcherloadnpremp", retornoCount++);
+                    emitMove(output, 1, 42, "carrega a posição de memoria"); //r referente ao destino do salto  
                 }
                 else if (strcmp(quad.arg1, "dispatchersavep") == 0){
-                    fprintf(output, "%d - move $r42 $r1 # salva a posição de memoria\n", lineIndex++); //r referente ao destino do salto  
-                    fprintf(output, "%d - move $r1 $r40\n", lineIndex++); //r referente ao salto
-                    fprintf(output, "%d - li $r58 %d \n", lineIndex++, (lineIndex)-labelCount+3); //r referente ao salto
-                    fprintf(output, "%d - li $r43 1601\n", lineIndex++);
-                    fprintf(output, "%d - j 1601\n", lineIndex++);
+                    emitMove(output, 42, 1, "salva a posição de memoria"); //r referente ao destino do salto  
+                    emitMove(output, 1, 40, NULL); //r referente ao salto
+                    emitDispatcherJump(output, "dispatchersavepremp", retornoCount++);
                 }
                 else if (strcmp(quad.arg1, "salvaregSO") == 0){
                     for (int j=63; j>=0; j--){
                         if(j!=1 && j!=58 && j!=42 && j!=44 && j!=40 && j!= 59 && j!= 60 && j!= 58 && j!= 62 && j!= 41 && j!= 42 && j!= 43 && j!= 51 && j!= 57 && j!= 30 && j!= 39){
-                            fprintf(output, "%d - subi $r1 $r1 1 # salva o reg\n", lineIndex++); 
-                            fprintf(output, "%d - sw $r%d 0($r1) # salva o reg\n", lineIndex++, j); 
+                            emitI(output, "subi", 1, 1, 1, "salva o reg"); 
+                            emitMem(output, "sw", j, 0, 1, "salva o reg"); 
                         }
                     }
                 }
                 else if (strcmp(quad.arg1, "loadregSO") == 0){
                     for (int j=63; j>=0; j--){
                         if(j!=1 && j!=58 && j!=42 && j!=44 && j!=40 && j!= 59 && j!= 60 && j!= 58 && j!= 62 && j!= 41 && j!= 42 && j!= 43 && j!= 51 && j!= 57 && j!= 30 && j!= 39){
-                            fprintf(output, "%d - subi $r1 $r1 1 # salva o reg\n", lineIndex++); 
-                            fprintf(output, "%d - lw $r%d 0($r1) # salva o reg\n", lineIndex++, j); 
+                            emitI(output, "subi", 1, 1, 1, "salva o reg"); 
+                            emitMem(output, "lw", j, 0, 1, "salva o reg"); 
                         }
                     }
                 }
                 else if (strcmp(quad.arg1, "salvaregprog") == 0){
-                    fprintf(output, "%d - move $r30 $r1 # salva posição memoria \n", lineIndex++); 
-                    fprintf(output, "%d - move $r1 $r62 # bcp do programa\n", lineIndex++);      
+                    emitMove(output, 30, 1, "salva posição memoria"); 
+                    emitMove(output, 1, 62, "bcp do programa");      
                    
                    
-                    fprintf(output, "%d - move $r63 $r57 # pc do prog\n", lineIndex++);      
-                    fprintf(output, "%d - subi $r57 $r63 1 # pc do prog\n", lineIndex++);      
-                    fprintf(output, "%d - li $r63 0 # pc do prog\n", lineIndex++);      
+                    emitMove(output, 63, 57, "pc do prog");      
+                    emitI(output, "subi", 57, 63, 1, "pc do prog");      
+                    emitLi(output, 63, 0, "pc do prog");      
                     // fprintf(output, "%d - subi $r57 $r57 1 # pc do prog\n", lineIndex++);      
                     // fprintf(output, "%d - out $r57 # pc do prog\n", lineIndex++);      
                     
-                    fprintf(output, "%d - subi $r1 $r1 1 # salva o reg\n", lineIndex++); 
-                    fprintf(output, "%d - sw $r57 0($r1) # pc do processo\n", lineIndex++); 
-                    fprintf(output, "%d - subi $r1 $r1 1 # salva o reg\n", lineIndex++); 
-                    fprintf(output, "%d - sw $r30 0($r1) # memdados do processo\n", lineIndex++);     
+                    emitI(output, "subi", 1, 1, 1, "salva o reg"); 
+                    emitMem(output, "sw", 57, 0, 1, "pc do processo"); 
+                    emitI(output, "subi", 1, 1, 1, "salva o reg"); 
+                    emitMem(output, "sw", 30, 0, 1, "memdados do processo");     
                     
                     for (int j=63; j>=0; j--){
                         if(j!=1 && j!=58 && j!=42 && j!=44 && j!=40 && j!= 59 && j!= 60 && j!= 58 && j!= 62 && j!= 41 && j!= 42 && j!= 51 && j!= 57 && j!= 30 && j!= 39){
-                            fprintf(output, "%d - subi $r1 $r1 1 # salva o reg\n", lineIndex++); 
-                            fprintf(output, "%d - sw $r%d 0($r1) # salva o reg\n", lineIndex++, j); 
+                            emitI(output, "subi", 1, 1, 1, "salva o reg"); 
+                            emitMem(output, "sw", j, 0, 1, "salva o reg"); 
                         }
                     }
                 }
                 else if (strcmp(quad.arg1, "loadregprog") == 0){
-                    fprintf(output, "%d - move $r1 $r62 # bcp do programa\n", lineIndex++);      
+                    emitMove(output, 1, 62, "bcp do programa");      
                     
-                    fprintf(output, "%d - subi $r1 $r1 1 # carrega o reg\n", lineIndex++); 
-                    fprintf(output, "%d - lw $r57 0($r1) # carrega o pc\n", lineIndex++); 
+                    emitI(output, "subi", 1, 1, 1, "carrega o reg"); 
+                    emitMem(output, "lw", 57, 0, 1, "carrega o pc"); 
                     // fprintf(output, "%d - out $r57 # pc do prog\n", lineIndex++);      
-                    fprintf(output, "%d - subi $r1 $r1 1 # carrega o reg\n", lineIndex++); 
-                    fprintf(output, "%d - lw $r30 0($r1) # carrega o reg\n", lineIndex++);     
+                    emitI(output, "subi", 1, 1, 1, "carrega o reg"); 
+                    emitMem(output, "lw", 30, 0, 1, "carrega o reg");     
                     
                     for (int j=63; j>=0; j--){
                         if(j!=1 && j!=58 && j!=42 && j!=44 && j!=40 && j!= 59 && j!= 60 && j!= 58 && j!= 62 && j!= 41 && j!= 42 && j!= 51 && j!= 57 && j!= 30 && j!= 39){
-                            fprintf(output, "%d - subi $r1 $r1 1 # carrega o reg\n", lineIndex++); 
-                            fprintf(output, "%d - lw $r%d 0($r1) # carrega o reg\n", lineIndex++, j); 
+                            emitI(output, "subi", 1, 1, 1, "carrega o reg"); 
+                            emitMem(output, "lw", j, 0, 1, "carrega o reg"); 
                         }
                     }
-                    fprintf(output, "%d - move $r1 $r30 # restaura posição memoria \n", lineIndex++);
-                    fprintf(output, "%d - move $r43 $r57\n", lineIndex++); //r referente ao salto
+                    emitMove(output, 1, 30, "restaura posição memoria");
+                    emitMove(output, 43, 57, NULL); //r referente ao salto
                     // fprintf(output, "%d - out $r43 # pc do prog\n", lineIndex++);      
-                    fprintf(output, "%d - saltoUser $r%d # usar o dado1 para o salto_rom\n", 
-                            lineIndex++, 57); //r referente ao salto    
+                    emitReg(output, "saltoUser", 57, "usar o dado1 para o salto_rom"); //r referente ao salto    
                 }
                 
                 else if(strcmp(quad.arg1,"loadword") == 0){
-                    fprintf(output, "%d - lw $r%d 0($r46)\n", lineIndex++, r3);
+                    emitMem(output, "lw", r3, 0, 46, NULL);
                     // fprintf(output, "%d - move $r0 $r46 # debug loadword\n", lineIndex++);
                     // fprintf(output, "%d - out $r0 # debug loadword\n", lineIndex++);
                 }
                 else if(strcmp(quad.arg1,"saveword") == 0){
-                    fprintf(output, "%d - sw $r%d 0($r46)\n", lineIndex++, 47);
+                    emitMem(output, "sw", 47, 0, 46, NULL);
                 }
                 else {
                     // Aloca espaço para os argumentos na pilha antes da chamada
                     int argCount = atoi(quad.arg2);
                     if (argCount > 0) {
-                        allocateArgumentSpace(output, argCount, &lineIndex, &stackOffset);
+                        allocateArgumentSpace(output, argCount, &stackOffset);
                     }
                     
                     // Chamada normal de função
-                    if(strcmp(quad.arg1,"dispatcherloadnpremp")!=0 && strcmp(quad.arg1,"dispatchersavenpremp")!=0 && strcmp(quad.arg1,"dispatchersavepprog")!=0  && strcmp(quad.arg1,"dispatchersavepremp")!=0){
-                        fprintf(output, "%d - addil $r43 $r44 %s\n", lineIndex++, quad.arg1);
-                        fprintf(output, "%d - jal %s\n", lineIndex++, quad.arg1);
+                    if(!isDispatcherEntry(quad.arg1)){
+                        // limparVar não tem corpo: desvia para o início do programa, que reinicializa as variáveis
+                        const char* alvo = strcmp(quad.arg1, "limparVar") == 0 ? "0" : quad.arg1;
+                        emitAddil(output, 43, 44, alvo, NULL);
+                        emitJump(output, "jal", alvo, NULL);
                         // Libera espaço dos argumentos após chamada
                     }
                     else{
-                        if(strcmp(quad.arg1,"dispatchersavenpremp")==0){
-                            fprintf(output, "%d - li $r39 1001\n", lineIndex++);    
-                        }
-                        else if(strcmp(quad.arg1,"dispatcherloadnpremp")==0){
-                            fprintf(output, "%d - li $r39 1201\n", lineIndex++);                                
-                        }
-                        else if(strcmp(quad.arg1,"dispatchersavepprog")==0){
-                            fprintf(output, "%d - li $r39 1401\n", lineIndex++);                                
-                        }
-                        else if(strcmp(quad.arg1,"dispatchersavepremp")==0){
-                            fprintf(output, "%d - li $r39 1601\n", lineIndex++);                                
-                        }
-                        
-                        fprintf(output, "%d - addil $r43 $r39 %s\n", lineIndex++, quad.arg1);
-                        fprintf(output, "%d - j %s\n", lineIndex++, quad.arg1);
+                        // r39 recebe o endereço de carga da própria imagem do dispatcher
+                        char baseImagem[64];
+                        snprintf(baseImagem, sizeof(baseImagem), "%c%s", EXTERNAL_SYMBOL_PREFIX, quad.arg1);
+                        emitLoad(output, 39, baseImagem, NULL);
+
+                        emitAddil(output, 43, 39, quad.arg1, NULL);
+                        emitJump(output, "j", quad.arg1, NULL);
                     }
                     
                     if (argCount > 0) {
                         int totalSize = argCount;
-                        fprintf(output, "%d - addi $r1 $r1 %d  # libera espaço de %d argumentos\n", 
-                                lineIndex++, totalSize, argCount);
+                        emitI(output, "addi", 1, 1, totalSize, "libera espaço de %d argumentos", argCount);
                         stackOffset += totalSize;
                     }
 
@@ -1243,7 +1397,7 @@ void generateAssembly(FILE* inputFile, int mode) {
                         for (int i = 0; i < paramCount; i++) {
                             // printf("parametro %d, registrador\n", parameters[i]);
                             // int rx = getRegisterIndex(parameters[i]);
-                            loadParameter(output, i, parameters[i], &lineIndex);
+                            loadParameter(output, i, parameters[i]);
                         }
                     }
 
@@ -1254,7 +1408,7 @@ void generateAssembly(FILE* inputFile, int mode) {
                         for (int i = 0; i < varLocalCount; i++) {
                             // fprintf(output, "%d - subi $r62 $r62 1 # desce na pilha\n", lineIndex++);
                             // fprintf(output, "%d - move $r%d $r62 # recarrega variavel local\n", lineIndex++, localVars[i]);
-                            fprintf(output, "%d - lw $r%d -%d($r2)  # recarrega variavel local\n", lineIndex++, localVars[i], i+1);
+                            emitMem(output, "lw", localVars[i], -(i+1), 2, "recarrega variavel local");
                         
                         }
                     }
@@ -1265,14 +1419,9 @@ void generateAssembly(FILE* inputFile, int mode) {
                             // Função void, não gera instrução de move, apenas adiciona comentário
                             // fprintf(output, "%d - # Chamada void para função %s, sem valor de retorno\n", lineIndex++, quad.arg1);
                         } else {
-                            fprintf(output, "%d - move $r%d $r45 # copia retorno (v0) para %s\n", 
-                                        lineIndex++, r3, quad.result);
+                            emitMove(output, r3, 45, "copia retorno (v0) para %s", quad.result);
                         } 
                     }
-                    checkNextQuadruple(inputFile, &filePos, &nextQuad);
-                    if(strcmp(nextQuad.op,"RETURN")== 0){
-                        proximoReturn = 1;
-                    }
                 }
                 
                 break;
@@ -1291,14 +1440,10 @@ void generateAssembly(FILE* inputFile, int mode) {
                 tempLocalRegs[rbase-4].isUsed = 1;
                 // fprintf(output, "%d - addi $r%d $r%d 1 # índice + 1\n", lineIndex++, rindice, rindice);
                 // fprintf(output, "%d - mul $r%d $r%d $r62      # índice * 4 (tamanho do inteiro)\n", lineIndex++, rindice, rindice);
-                fprintf(output, "%d - sub $r%d $r%d $r%d    # endereço base - deslocamento\n", lineIndex++, rbase, rvet, rindice);
-                fprintf(output, "%d - lw $r%d 0($r%d)      # carrega %s[%s] em %s\n", lineIndex++, r3, rbase, quad.arg1, quad.arg2, quad.result);
+                emitR(output, "sub", rbase, rvet, rindice, "endereço base - deslocamento");
+                emitMem(output, "lw", r3, 0, rbase, "carrega %s[%s] em %s", quad.arg1, quad.arg2, quad.result);
                 reiniciarRg(rbase);
 
-                checkNextQuadruple(inputFile, &filePos, &nextQuad);
-                if(strcmp(nextQuad.op,"RETURN")== 0){
-                    proximoReturn = 1;
-                }
                 break;
 
             case OP_ARRAY_STORE:
@@ -1316,9 +1461,9 @@ void generateAssembly(FILE* inputFile, int mode) {
                 tempLocalRegs[rbase-4].isUsed = 1;
                 // fprintf(output, "%d - addi $r%d $r%d 1 # índice + 1\n", lineIndex++, rindice, rindice);
                 // fprintf(output, "%d - mul $r%d $r%d $r62      # índice * 4 (tamanho do inteiro)\n", lineIndex++, rindice, rindice);
-                fprintf(output, "%d - sub $r%d $r%d $r%d    # endereço base - deslocamento\n", lineIndex++, rbase, rvet, rindice);
+                emitR(output, "sub", rbase, rvet, rindice, "endereço base - deslocamento");
                 // fprintf(output, "%d - out $r%d\n", lineIndex++, rbase); // Exibe o endereço base do array
-                fprintf(output, "%d - sw $r%d 0($r%d)      # armazena %s em %s[%s]\n", lineIndex++, r1, rbase, quad.arg1, quad.result, quad.arg2);
+                emitMem(output, "sw", r1, 0, rbase, "armazena %s em %s[%s]", quad.arg1, quad.result, quad.arg2);
                 reiniciarRg(rbase);
                 reiniciarRg(r1);
                 break;
@@ -1332,7 +1477,7 @@ void generateAssembly(FILE* inputFile, int mode) {
                     
                     // fprintf(output, "%d - subi $r1 $r1 1  # aloca espaço para referência do array '%s'\n", lineIndex++, quad.result);
                     // // Salva o endereço base do array no registrador de resultado
-                    fprintf(output, "%d - move $r%d $r1   # endereço base do array '%s'\n", lineIndex++, r3, quad.result);
+                    emitMove(output, r3, 1, "endereço base do array '%s'", quad.result);
                     // fprintf(output, "%d - out $r32\n", lineIndex++); // Exibe o endereço base do array
                     if (strcmp(currentFunction, "global") == 0) {
                         globalVars[varGlobalCount] = r3; // Armazena o registrador da variável global
@@ -1347,18 +1492,18 @@ void generateAssembly(FILE* inputFile, int mode) {
                     stackOffset -= (size); //size já é o tamanho em bytes
                     
                     char loopLabel[32], endLoopLabel[32];
-                    fprintf(output, "%d - subi $r1 $r1 %d  # próximo elemento\n", lineIndex++, size/4);
+                    emitI(output, "subi", 1, 1, size/4, "próximo elemento");
                     // fprintf(output, "%d - out $r1\n", lineIndex++);
                 } else {
                     if (strcmp(quad.result, "processosCarregados")!=0 && strcmp(quad.result, "processoAtual")!=0 && strcmp(quad.result, "salto")!=0  && strcmp(quad.result, "memdados")!=0  && strcmp(quad.result, "opcao")!=0 && strcmp(quad.result, "sinalsyscall")!=0 && strcmp(quad.result, "pc_processo")!=0){
 
                         // É uma variável simples, apenas reserva espaço na pilha
-                        fprintf(output, "%d - subi $r1 $r1 1 # aloca espaço para variável '%s'\n", lineIndex++, quad.result);
-                        fprintf(output, "%d - sw $r63 0($r1)  # inicializa com 0\n", lineIndex++);
+                        emitI(output, "subi", 1, 1, 1, "aloca espaço para variável '%s'", quad.result);
+                        emitMem(output, "sw", 63, 0, 1, "inicializa com 0");
                         stackOffset -= 4;
                         
                         // Guarda o endereço da variável no registrador de resultado
-                        fprintf(output, "%d - move $r%d $r1   # endereço da variável '%s'\n", lineIndex++, r3, quad.result);
+                        emitMove(output, r3, 1, "endereço da variável '%s'", quad.result);
                         
                         //se escopo == global
                         if (strcmp(currentFunction, "global") == 0) {
@@ -1374,11 +1519,24 @@ void generateAssembly(FILE* inputFile, int mode) {
                 break;
 
             default:
-                fprintf(output, "%d - ; instrução %s ainda não implementada\n", lineIndex++, quad.op);
+                emitComment(output, "instrução %s ainda não implementada", quad.op);
                 break;
         }
+
+        if (opType == OP_END) {
+            fim = atual->next;
+            break;
+        }
     }
 
-    fclose(output);
-    analyzeRegisterUsage("Output/assembly.asm");
-}
\ No newline at end of file
+    // As declarações globais deixam o mapa para as funções seguintes
+    if (!ehFuncao) {
+        for (int i = 0; i < GLOBAL_REGISTER_COUNT; i++) {
+            snprintf(globais->nomes[i], sizeof(globais->nomes[i]), "%s",
+                     tempGlobalRegs[i].isUsed ? tempGlobalRegs[i].varName : "");
+        }
+    }
+    *retornos = retornoCount;
+    return fim;
+}
+
@@ -4,6 +4,7 @@
 #include "globals.h"
 #include "cinter.h"  
 #include "symtab.h"
+#include "codigo_maquina.h"
 
 #define MAX_REGS 64 //numero maximo de registradores
 #define REG_OUT  0   // r0 - registrador de saída (OUT)
@@ -13,6 +14,10 @@
 #define REG_FP  1   // r1 - frame pointer (FP)
 #define REG_IN 3   // r3 - registrador de entrada (IN)
 
+// Faixa do imediato de 14 bits com sinal das instruções do tipo I
+#define IMEDIATO_MIN (-8192)
+#define IMEDIATO_MAX 8191
+
 // Estrutura para armazenar uma quádrupla durante a leitura do arquivo
 typedef struct {
     int line;
@@ -30,32 +35,42 @@ typedef struct {
     int isUsed;
 } RegisterMapping;
 
-static RegisterMapping argumentRegs[6]; // a0-a5
-static RegisterMapping paramRegs[6]; // p0-p5
-static RegisterMapping tempLocalRegs[27];  // t0-t26
-static RegisterMapping tempGlobalRegs[13];  // t0-t12
-static RegisterMapping returnRegs[1]; // v0
+// 1 força a forma longa dos desvios condicionais (addil + bxx); 0 usa os desvios relativos ao PC (bxxr)
+extern int desvioLongo;
 
-static char currentFunction[50] = ""; // Função atual sendo processada
+// 1 permite trocar x / 2^k por sr (correto apenas para dividendos não negativos)
+extern int divisaoPorDeslocamento;
 
 OperationType getOpTypeFromString(const char* op);
 void initRegisterMappings(void);
 int getNextFreeReg(RegisterMapping* regs, int count);
 int getRegisterIndexFromName(const char* name);
 void updateCurrentFunction(const char* funcName);
-void checkNextQuadruple(FILE* inputFile, long* filePos, QuadrupleInfo* nextQuad);
+void checkNextQuadruple(const Quadruple* current, QuadrupleInfo* nextQuad);
 void collectFunctionInfo(void);
-void generateAssembly(FILE* inputFile, int mode);
+// Registradores das variáveis globais (r33 em diante) que as declarações globais já
+// mapearam. É tudo o que o código de uma função herda das faixas anteriores.
+#define GLOBAL_REGISTER_COUNT 7
+typedef struct {
+    char nomes[GLOBAL_REGISTER_COUNT][64];  // "" = registrador livre
+} GlobalRegisterMap;
+
+void initGlobalRegisterMap(GlobalRegisterMap* globais);
+
+// Gera o código de máquina direto da lista de quádruplas do código intermediário,
+// uma faixa por vez (ver generateRangeAssembly no .c)
+void generatePrologue(int mode, MachineCode* output);
+const Quadruple* generateRangeAssembly(const Quadruple* inicio, GlobalRegisterMap* globais, int primeiraFuncao,
+                                       MachineCode* output, int* retornos);
+void analyzeRegisterUsage(const MachineCode* code);
 
 // Funções para manipulação de pilha
-void pushRegister(FILE* output, int reg, int* stackOffset, int* lineIndex);
-void popRegister(FILE* output, int reg, int* stackOffset, int* lineIndex);
+void pushRegister(MachineCode* output, int reg, int* stackOffset);
+void popRegister(MachineCode* output, int reg, int* stackOffset);
 int getParameterOffset(int paramIndex);
-void loadParameter(FILE* output, int paramIndex, int destReg, int* lineIndex);
-void setupFrame(FILE* output, int* lineIndex, int* stackOffset);
-void restoreFrame(FILE* output, int* lineIndex, int* stackOffset);
-void saveCallerSavedRegs(FILE* output, int* lineIndex, int* stackOffset);
-void restoreCallerSavedRegs(FILE* output, int* lineIndex, int* stackOffset);
+void loadParameter(MachineCode* output, int paramIndex, int destReg);
+void setupFrame(MachineCode* output, int* stackOffset);
+void restoreFrame(MachineCode* output, int* stackOffset);
 
 
 #endif
\ No newline at end of file
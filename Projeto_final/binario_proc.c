@@ -1,531 +1,725 @@
 #include "binario_proc.h"
+#include "ligador.h"
+#include "metricas.h"
+#include "tempo_fases.h"
 
-// Array global para armazenar os mapeamentos
-LabelMapping mappingLabel[MAX_LABELS];
-int labelCount = 0;
+// Tabela global de rótulos -> endereços
+static LabelMap labelMap = {NULL, 0, 0};
+static int assemblerErrors = 0;
 
-// Função para adicionar um mapeamento de rótulo
-void addLabelMapping(const char* label, int index) {
-    if (labelCount < MAX_LABELS && label[0] != '\0') {
-        mappingLabel[labelCount].label = strdup(label);
-        mappingLabel[labelCount].index = index-labelCount;
-        printf("Mapeamento: %s -> %d %d %d\n", mappingLabel[labelCount].label, index, index-labelCount, labelCount);
-        labelCount++;
+// Hash FNV-1a do nome do rótulo
+static unsigned int hashLabel(const char* label) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)label; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
     }
+    return hash;
 }
 
-// Função para liberar a memória alocada para os rótulos
-void freeLabelMappings() {
-    for (int i = 0; i < labelCount; i++) {
-        free(mappingLabel[i].label);
+static void growLabelMap(void) {
+    int newCapacity = labelMap.capacity ? labelMap.capacity * 2 : LABEL_MAP_INITIAL_CAPACITY;
+    LabelMapping** newBuckets = calloc(newCapacity, sizeof(LabelMapping*));
+    for (int i = 0; i < labelMap.capacity; i++) {
+        LabelMapping* entry = labelMap.buckets[i];
+        while (entry != NULL) {
+            LabelMapping* next = entry->next;
+            unsigned int slot = hashLabel(entry->label) & (newCapacity - 1);
+            entry->next = newBuckets[slot];
+            newBuckets[slot] = entry;
+            entry = next;
+        }
     }
-    labelCount = 0;
+    free(labelMap.buckets);
+    labelMap.buckets = newBuckets;
+    labelMap.capacity = newCapacity;
 }
 
-void getLabelNumber(char* line, char* label, int* index) {    
-    *index = -1; // Valor padrão se não encontrar índice
-    label[0] = '\0'; // Valor padrão para o rótulo
-    
-    // Limpar espaços iniciais
-    char* start = line;
-    while (*start && isspace(*start)) {
-        start++;
-    }
-    
-    // Verificar o formato "número - label:"
-    char* dash_pos = strstr(start, " - ");
-    if (dash_pos != NULL) {
-        // Extrair o número (índice)
-        char index_str[32] = {0};
-        int i = 0;
-        for (char* p = start; p < dash_pos && i < 31; p++) {
-            if (isdigit(*p)) {
-                index_str[i++] = *p;
-            }
-        }
-        index_str[i] = '\0';
-        
-        // Converter string para inteiro
-        if (index_str[0] != '\0') {
-            *index = atoi(index_str);
-            // *index = *index + 1; // Incrementar o índice em 1, para começar pela instrução 1 da função
-        }
-        
-        // Extrair o rótulo (label)
-        char* label_start = dash_pos + 3; // Pular o " - "
-        
-        // Encontrar o final do rótulo (antes de ':' ou fim da linha)
-        char* colon_pos = strchr(label_start, ':');
-        
-        if (colon_pos != NULL) {
-            // Temos um rótulo seguido por ':'
-            int length = colon_pos - label_start;
-            strncpy(label, label_start, length);
-            label[length] = '\0'; // Garantir terminação da string
-        } else {
-            label[0] = '\0'; // Não encontramos um rótulo válido
+static LabelMapping* findLabel(const char* label) {
+    if (labelMap.capacity == 0) {
+        return NULL;
+    }
+    LabelMapping* entry = labelMap.buckets[hashLabel(label) & (labelMap.capacity - 1)];
+    while (entry != NULL && strcmp(entry->label, label) != 0) {
+        entry = entry->next;
+    }
+    return entry;
+}
+
+// Insere sem imprimir; retorna -1 se o rótulo já existe
+static int putLabel(const char* label, int index) {
+    if (findLabel(label) != NULL) {
+        return -1;
+    }
+    if (labelMap.count + 1 > labelMap.capacity * 3 / 4) {
+        growLabelMap();
+    }
+    unsigned int slot = hashLabel(label) & (labelMap.capacity - 1);
+    LabelMapping* entry = malloc(sizeof(LabelMapping));
+    entry->label = strdup(label);
+    entry->index = index;
+    entry->next = labelMap.buckets[slot];
+    labelMap.buckets[slot] = entry;
+    labelMap.count++;
+    return 0;
+}
+
+// Define um rótulo no endereço da próxima instrução; rótulo repetido é erro
+static void defineLabel(const char* label, int address) {
+    if (putLabel(label, address) != 0) {
+        printError("Erro: rótulo '%s' definido mais de uma vez.", label);
+        assemblerErrors++;
+    }
+}
+
+// Função para liberar a memória alocada para os rótulos
+void freeLabelMappings(void) {
+    for (int i = 0; i < labelMap.capacity; i++) {
+        LabelMapping* entry = labelMap.buckets[i];
+        while (entry != NULL) {
+            LabelMapping* next = entry->next;
+            free(entry->label);
+            free(entry);
+            entry = next;
         }
     }
-    
-    // Remover espaços no fim do rótulo
-    int len = strlen(label);
-    while (len > 0 && isspace(label[len-1])) {
-        label[--len] = '\0';
+    free(labelMap.buckets);
+    labelMap.buckets = NULL;
+    labelMap.capacity = 0;
+    labelMap.count = 0;
+}
+
+// Retorna o endereço do rótulo ou -1 se ele não foi mapeado
+int lookupLabel(const char* label) {
+    if (label == NULL) {
+        return -1;
     }
+    countOperation(COUNTER_LABEL_LOOKUP);
+    LabelMapping* entry = findLabel(label);
+    return entry ? entry->index : -1;
 }
 
-InstructionInfo instructionTable[] = {
-    {"add", TYPE_R, 0, 2},     // 000000 ... 0010
-    {"sub", TYPE_R, 0, 3},     // 000000 ... 0011
-    {"mul", TYPE_R, 0, 4},     // 000000 ... 0100
-    {"div", TYPE_R, 0, 5},     // 000000 ... 0101
-    {"and", TYPE_R, 0, 0},     // 000000 ... 0000
-    {"or", TYPE_R, 0, 1},      // 000000 ... 0001
-    {"nor", TYPE_R, 0, 8},     // 000000 ... 1000
-    {"sr", TYPE_R, 1, 6},      // 000001 ... 0110
-    {"sl", TYPE_R, 1, 7},      // 000001 ... 0111
-    {"jr", TYPE_R, 2, 9},      // 000010 ... 1001
-    
-    {"andi", TYPE_I, 3, 0},    // 000011 ...
-    {"ori", TYPE_I, 4, 0},     // 000100 ...
-    {"addi", TYPE_I, 5, 0},    // 000101 ...
-    {"subi", TYPE_I, 6, 0},    // 000110 ...
-    {"li", TYPE_I, 7, 0},      // 000111 ...
-    {"lw", TYPE_I, 8, 0},      // 001000 ... (lw1)
-    {"lw2", TYPE_I, 9, 0},      // 001001 ... (lw2)
-    {"lw3", TYPE_I, 10, 0},     // 001010 ... (lw3) - endereçamentos
-    {"sw", TYPE_I, 11, 0},     // 001011 ...
-    {"beq", TYPE_I, 12, 0},    // 001100 ...
-    {"blt", TYPE_I, 13, 0},    // 001101 ...
-    {"bgt", TYPE_I, 14, 0},    // 001110 ...
-    {"bnq", TYPE_I, 15, 0},    // 001111 ... 
-    {"bge", TYPE_I, 23, 0},    // 010000 ... 
-    {"ble", TYPE_I, 24, 0},    // 010001 ... 
-    {"in", TYPE_I, 16, 0},     // 010000 ...
-    {"out", TYPE_I, 17, 0},    // 010001 ...
-    {"move", TYPE_I, 18, 0},   // 010010 ...
-    
-    
-    {"j", TYPE_J, 19, 0},      // 010011 ...
-    {"jal", TYPE_J, 20, 0},    // 010100 ...
-    {"nop", TYPE_J, 22, 0},    // 010110 ...
-    
-    {"halt", TYPE_MK, 21, 0},   // 010101 desligar SO
-    {"msgLcd",        TYPE_MK, 26, 0}, // opcode 011010
-    {"saltoUser",  TYPE_MK, 27, 0}, // opcode 011011
-    {"syscall",        TYPE_MU, 28, 9}, // opcode 011100
-    {"addil", TYPE_I, 25, 0}, // opcode 011001
-
-    // {"fbw", TYPE_COMM, 30, 0}, // opcode 011110
-    // {"rfbw", TYPE_COMM, 31, 0}, // opcode 011111
-    // {"voteHdw", TYPE_R, 32, 3}, // opcode 100000 
-    
-    {"", TYPE_INVALID, 0, 0}
-};
-
-int extractRegister(const char* regStr) {
-    if (regStr[0] == '$' && regStr[1] == 'r') {
-        return atoi(regStr + 2); 
-    }
-    return -1; 
+// Referências a rótulos ainda não definidos, corrigidas ao final da montagem
+static FixupList* activeFixups = NULL;
+
+// Relocações do objeto sendo montado (-c); NULL na montagem direta
+static RelocationList* activeRelocations = NULL;
+
+// Endereço de outra imagem: no objeto fica zerado e vira relocação para o ligador;
+// na montagem direta vem do layout padrão da memória
+static int resolveExternal(const char* image, int address, FixupKind kind) {
+    if (kind == FIX_REL14) {
+        printError("Erro: desvio relativo para a imagem '%s'.", image);
+        assemblerErrors++;
+        return 0;
+    }
+    if (activeRelocations != NULL) {
+        if (activeRelocations->count == activeRelocations->capacity) {
+            activeRelocations->capacity = activeRelocations->capacity ? activeRelocations->capacity * 2 : 16;
+            activeRelocations->items = realloc(activeRelocations->items,
+                                               activeRelocations->capacity * sizeof(Relocation));
+        }
+        Relocation* reloc = &activeRelocations->items[activeRelocations->count++];
+        reloc->symbol = strdup(image);
+        reloc->address = address;
+        reloc->kind = kind;
+        return 0;
+    }
+    int value = defaultImageAddress(image);
+    if (value == -1) {
+        printError("Erro: a imagem '%s' não tem endereço no layout padrão (gere objetos com -c e use --link).", image);
+        assemblerErrors++;
+        return 0;
+    }
+    return value;
 }
 
-InstructionInfo* findInstruction(const char* mnemonic) {
-    for (int i = 0; instructionTable[i].type != TYPE_INVALID; i++) {
-        if (strcasecmp(instructionTable[i].mnemonic, mnemonic) == 0) {
-            return &instructionTable[i];
+// Resolve o destino da instrução (rótulo mapeado ou endereço numérico). Um rótulo
+// à frente vira uma pendência e o campo fica zerado até o backpatching.
+static int resolveOperand(const MachineInstr* instr, int address, FixupKind kind) {
+    int value = instr->imm;
+    if (instr->symbol != NULL && instr->symbol[0] == EXTERNAL_SYMBOL_PREFIX) {
+        return resolveExternal(instr->symbol + 1, address, kind);
+    }
+    if (instr->symbol != NULL) {
+        value = lookupLabel(instr->symbol);
+        if (value == -1) {
+            if (activeFixups != NULL) {
+                if (activeFixups->count == activeFixups->capacity) {
+                    activeFixups->capacity = activeFixups->capacity ? activeFixups->capacity * 2 : 64;
+                    activeFixups->items = realloc(activeFixups->items, activeFixups->capacity * sizeof(Fixup));
+                }
+                Fixup* fixup = &activeFixups->items[activeFixups->count++];
+                fixup->label = instr->symbol;
+                fixup->address = address;
+                fixup->line = activeFixups->line;
+                fixup->kind = kind;
+            } else {
+                printError("Erro: rótulo '%s' não definido.", instr->symbol);
+                assemblerErrors++;
+            }
+            return 0;
         }
     }
-    return NULL; 
+    return kind == FIX_REL14 ? value - address : value;
 }
 
-void generateBinary(const char* instruction, char* binaryOutput, int index_atual) {
-    char instr_copy[MAX_LINE_LENGTH];
-    strcpy(instr_copy, instruction);
-    
-    char* mnemonic = strtok(instr_copy, " \t\n\r");
-    if (!mnemonic) {
-        strcpy(binaryOutput, "01011000000000000000000000000000"); // Default é o nop
-        return;
-    }
-    
-    InstructionInfo* info = findInstruction(mnemonic);
-    if (!info) {
-        sprintf(binaryOutput, "// Instrução desconhecida: %s", mnemonic);
-        return;
-    }
-    
+// Desvio condicional na forma relativa ao PC (beqr, bnqr, bltr, bgtr, bger, bler)
+int isRelativeBranch(const char* mnemonic) {
+    const InstructionInfo* info = findInstruction(mnemonic);
+    return info != NULL && info->format == FMT_BRANCH_REL;
+}
+
+// Codifica uma instrução decodificada; o formato decide o papel de cada operando
+static EncodeStatus encodeInstruction(const MachineInstr* instr, int index_atual, unsigned int* word) {
+    const InstructionInfo* info = instr->info;
+    const int* regs = instr->regs;
     unsigned int binary = 0;
-    
-    switch (info->type) {
-        case TYPE_R: {
-            // Formato: add $rd $rs $rt
-            char* rdStr = strtok(NULL, " ,\t\n\r");
-            char* rsStr = strtok(NULL, " ,\t\n\r");
-            char* rtStr = strtok(NULL, " ,\t\n\r");
-            
-            int rd = extractRegister(rdStr);
-            int rs = extractRegister(rsStr);
-            int rt = extractRegister(rtStr);
-            
-            if (rd == REG_RA){
-                rt = rd;
-                rs = 0;
-                rd = 0;
+    int rs = 0, rt = 0, rd = 0;
+    int immediate = 0;
 
+    switch (info->format) {
+        case FMT_RRR:
+            // Formato: add $rd $rs $rt
+            rd = regs[0];
+            rs = regs[1];
+            rt = regs[2];
+            if (rd < 0 || rs < 0 || rt < 0) {
+                return ENC_INVALID_R;
             }
-            else if (rd != REG_RA && (rd < 0 || rs < 0 || rt < 0)) {
-                sprintf(binaryOutput, "// Registrador inválido: %s", instruction);
-                return;
-            }
-            
             //opcode(6) rs(6) rt(6) rd(6) shamt(4) funct(4)
             binary = (info->opcode << 26) | (rs << 20) | (rt << 14) | (rd << 8) | (0 << 4) | info->funct;
             break;
-        }
-        
-        case TYPE_I: {
-            char* rsStr = strtok(NULL, " ,\t\n\r");
-            char* rtStr = NULL;
-            int immediate = 0;
-            int rs, rt;
-            
-            if (strcmp(mnemonic, "li") == 0) {
-                // li $rs, immediate
-                rs = 0;
-                rt = extractRegister(rsStr);
-                char* immStr = strtok(NULL, " ,\t\n\r");
-                immediate = atoi(immStr);
-            } 
-            else if (strcmp(mnemonic, "beq") == 0 || strcmp(mnemonic, "bnq") == 0 || 
-                     strcmp(mnemonic, "blt") == 0 || strcmp(mnemonic, "bgt") == 0 ||
-                     strcmp(mnemonic, "bge") == 0 || strcmp(mnemonic, "ble") == 0){
-                // beq $rs, $rt, label
-                rs = extractRegister(rsStr);
-                rtStr = strtok(NULL, " ,\t\n\r");
-                rt = extractRegister(rtStr);
-                
-                // pegar a posição da label
-                char* labelStr = strtok(NULL, " ,\t\n\r");
-                int targetIndex = -1;
-                for (int i = 0; i < labelCount; i++) {
-                    if (strcmp(mappingLabel[i].label, labelStr) == 0) {
-                        targetIndex = mappingLabel[i].index;
-                        break;
-                    }
-                }
-                
-                if (targetIndex != -1) {
-                    immediate = targetIndex;
-                } else {
-                    immediate = atoi(labelStr); 
-                }
-            }
-            else if (strcmp(mnemonic, "lw") == 0 || strcmp(mnemonic, "sw") == 0) {
-                // lw $rt, offset($rs) or sw $rt, offset($rs)
-                rt = extractRegister(rsStr);
-                
-                char* offsetBaseStr = strtok(NULL, " \t\n\r");
-                char offsetStr[32] = {0};
-                char baseRegStr[32] = {0};
-                
-                int i = 0;
-                while (offsetBaseStr[i] && offsetBaseStr[i] != '(') {
-                    offsetStr[i] = offsetBaseStr[i];
-                    i++;
-                }
-                offsetStr[i] = '\0';
-                
-                if (offsetBaseStr[i] == '(') {
-                    int j = 0;
-                    i++; // Skip '('
-                    while (offsetBaseStr[i] && offsetBaseStr[i] != ')') {
-                        baseRegStr[j++] = offsetBaseStr[i++];
-                    }
-                    baseRegStr[j] = '\0';
-                }
-                
-                rs = extractRegister(baseRegStr);
-                immediate = atoi(offsetStr)*2; // por algum motivo, o offset no addi e no subi é 8 ao invés de 4, então é necessário multiplicar por 2
-                
-                if (strcmp(mnemonic, "lw") == 0) {
-                    info->opcode = 8;      // LW1
-                    // else if (immediate > 0) info->opcode = 9;  // LW2
-                    // else info->opcode = 10;                    // LW3
-                }
-            }
-            else if (strcmp(mnemonic, "in") == 0 || strcmp(mnemonic, "out") == 0) {
-                // in $rd or out $rs
-                if (strcmp(mnemonic, "in") == 0) {
-                    rt = extractRegister(rsStr);
-                    rs = 0; // Not used
-                } else { // out
-                    rs = extractRegister(rsStr);
-                    rt = 0; // Not used
-                }
-                immediate = 0;
-            }
-            else if (strcmp(mnemonic, "move") == 0) {
-                // move $rd, $rs
-                rt = extractRegister(rsStr);
-                char* rsStr2 = strtok(NULL, " ,\t\n\r");
-                rs = extractRegister(rsStr2);
-                immediate = 0;
-            } else if (strcmp(mnemonic, "addil") == 0) {
-                rt = extractRegister(rsStr);
-                char* rsStr2 = strtok(NULL, " ,\t\n\r");
-                rs = extractRegister(rsStr2);
-                char* targetStr = strtok(NULL, " \t\n\r");
-                int targetAddr = -1;
-                
-                // Check if target is a label
-                for (int i = 0; i < labelCount; i++) {
-                    if (strcmp(mappingLabel[i].label, targetStr) == 0) {
-                        targetAddr = mappingLabel[i].index;
-                        break;
-                    }
-                }
-                
-                if (targetAddr == -1) {
-                    // Try to convert direct address
-                    targetAddr = atoi(targetStr);
-                }
-                immediate = targetAddr;
+
+        case FMT_JR:
+        case FMT_SYSCALL:
+            // jr $rt / syscall $rt
+            rt = regs[0];
+            if (rt < 0) {
+                return ENC_INVALID_R;
             }
-            else {
-                // addi, subi, andi, ori - format: op $rt, $rs, immediate
-                rt = extractRegister(rsStr);
-                char* rsStr2 = strtok(NULL, " ,\t\n\r");
-                rs = extractRegister(rsStr2);
-                char* immStr = strtok(NULL, " ,\t\n\r");
-                immediate = atoi(immStr);
+            binary = (info->opcode << 26) | (rs << 20) | (rt << 14) | (rd << 8) | (0 << 4) | info->funct;
+            break;
+
+        case FMT_RRI:   // addi, subi, andi, ori: op $rt, $rs, imediato
+        case FMT_LI:    // li $rt, imediato (aceita rótulo, ex.: retorno do dispatcher)
+        case FMT_MEM:   // lw/sw $rt, offset($rs)
+        case FMT_BRANCH:
+        case FMT_BRANCH_REL:
+        case FMT_IN:    // in $rt
+        case FMT_OUT:   // out $rs
+        case FMT_MOVE:  // move $rt, $rs
+        case FMT_ADDIL: // addil $rt, $rs, rótulo
+            switch (info->format) {
+                case FMT_RRI:
+                    rt = regs[0];
+                    rs = regs[1];
+                    immediate = instr->imm;
+                    break;
+                case FMT_LI:
+                    rt = regs[0];
+                    immediate = resolveOperand(instr, index_atual, FIX_IMM14);
+                    break;
+                case FMT_MEM:
+                    rt = regs[0];
+                    rs = regs[1];
+                    immediate = instr->imm * 2; // por algum motivo, o offset no addi e no subi é 8 ao invés de 4, então é necessário multiplicar por 2
+                    break;
+                case FMT_BRANCH:
+                    // beq $rs, $rt, rótulo
+                    rs = regs[0];
+                    rt = regs[1];
+                    immediate = resolveOperand(instr, index_atual, FIX_IMM14);
+                    break;
+                case FMT_BRANCH_REL:
+                    // beqr $rs, $rt, rótulo -> deslocamento relativo ao próprio desvio
+                    rs = regs[0];
+                    rt = regs[1];
+                    immediate = resolveOperand(instr, index_atual, FIX_REL14);
+                    break;
+                case FMT_IN:
+                    rt = regs[0];
+                    break;
+                case FMT_OUT:
+                    rs = regs[0];
+                    break;
+                case FMT_MOVE:
+                    rt = regs[0];
+                    rs = regs[1];
+                    break;
+                default: // FMT_ADDIL
+                    rt = regs[0];
+                    rs = regs[1];
+                    immediate = resolveOperand(instr, index_atual, FIX_IMM14);
+                    break;
             }
-            
-            // Check for valid registers
-            if ((rs < 0 && strcmp(mnemonic, "li") != 0) || 
-                (rt < 0 && strcmp(mnemonic, "out") != 0)) {
-                sprintf(binaryOutput, "// Invalid register in: %s", instruction);
-                return;
+            if (rs < 0 || rt < 0) {
+                return ENC_INVALID_I;
             }
-            
             // Build binary: opcode(6) rs(6) rt(6) immediate(14)
             binary = (info->opcode << 26) | (rs << 20) | (rt << 14) | (immediate & 0x3FFF); // 14-bit immediate
             break;
-        }
-        
-        case TYPE_J: {
-            int immediate = 0;
-            // Format: j target or jal target
-            if (strcmp(mnemonic, "j") == 0 || strcmp(mnemonic, "jal") == 0) {
-                char* targetStr = strtok(NULL, " \t\n\r");
-                int targetAddr = -1;
-                
-                // Check if target is a label
-                for (int i = 0; i < labelCount; i++) {
-                    if (strcmp(mappingLabel[i].label, targetStr) == 0) {
-                        targetAddr = mappingLabel[i].index;
-                        break;
-                    }
-                }
-                
-                if (targetAddr == -1) {
-                    // Try to convert direct address
-                    targetAddr = atoi(targetStr);
-                }
-                
-                // Build binary: opcode(6) target(26)
-                binary = (info->opcode << 26) | (targetAddr & 0x3FFFFFF); // 26-bit target
-            }
-            else if (strcmp(mnemonic, "nop") == 0){
-                char* immStr = strtok(NULL, " ,\t\n\r");
-                immediate = atoi(immStr);
-                binary = (info->opcode << 26) | (immediate & 0x3FFF);
-            }
+
+        case FMT_JUMP:
+            // j/jal target: opcode(6) target(26)
+            binary = (info->opcode << 26) | (resolveOperand(instr, index_atual, FIX_TARGET26) & 0x3FFFFFF);
             break;
-        }
 
-        case TYPE_MK: { //salto user e msgLcd halt 
-            // Formato: opcode immediate
-            char* rsStr = strtok(NULL, " ,\t\n\r");
-            int rs = extractRegister(rsStr);
+        case FMT_NOP:
+            binary = (info->opcode << 26) | (instr->imm & 0x3FFF);
+            break;
 
-            if(strcmp(mnemonic, "halt")==0){
-                binary = (info->opcode << 26) | (0 & 0x3FFFFFF); // opcode(6) | immediate(26)
-            } else{
-                // opcode(6) | immediate(26)
-                binary = (info->opcode << 26) | (rs << 20) | (0 & 0x3FFF); // 26-bit immediate
-            }
+        case FMT_HALT:
+            binary = info->opcode << 26; // opcode(6) | immediate(26)
             break;
-        }
 
-        case TYPE_MU: { // syscall
-                // syscall $rs
-                char* rtStr = strtok(NULL, " ,\t\n\r");
-                
-                int rt = extractRegister(rtStr);
-                
-                int rs = 0;
-                int rd = 0;
-                
-                binary = (info->opcode << 26) | (rs << 20) | (rt << 14) | (rd << 8) | (0 << 4) | info->funct;
-            
+        case FMT_REG:
+            // msgLcd/saltoUser $rs: opcode(6) | rs(6)
+            rs = regs[0];
+            binary = (info->opcode << 26) | (rs << 20);
             break;
-        }
-        
-        // case TYPE_COMM: { // fbw, rfbw
-        //     // Formato: opcode (6) flags (2) comando (8) value (8) checksum (8)
-            
-        //     char* flagsStr = strtok(NULL, " ,\t\n\r");
-        //     char* comandoStr = strtok(NULL, " ,\t\n\r");
-        //     char* valueStr = strtok(NULL, " ,\t\n\r");
-        //     char* checkStr = strtok(NULL, " ,\t\n\r");
-            
-        //     int flags = flagsStr ? atoi(flagsStr) : 0;
-        //     int comando = comandoStr ? atoi(comandoStr) : 0;
-        //     int value = valueStr ? atoi(valueStr) : 0;
-        //     int checksum = checkStr ? atoi(checkStr) : 0; // Checksum é o XOR de comando e valor, aqui só irá receber para avaliar será feito em hardware
-        
-        //     // Garantir que os valores estão dentro dos limites dos bits
-        //     flags &= 0x3;      // 2 bits (0-3)
-        //     comando &= 0xFF;   // 8 bits (0-255)
-        //     value &= 0xFF;     // 8 bits (0-255)
-        //     checksum &= 0xFF;  // 8 bits (0-255)
-        
-        //     binary = (info->opcode << 26) | (flags << 24) | (comando << 16) | (value << 8) | checksum;
-        //     break;
-        // }
-
-        case TYPE_INVALID:
-            sprintf(binaryOutput, "// Invalid instruction type for: %s", mnemonic);
-            return;
-    }
-    
-    // Convert binary to string representation (32-bit)
-    char binaryStr[33];
+    }
+
+    *word = binary;
+    return ENC_OK;
+}
+
+// Palavra de 32 bits em texto binário, terminada por '\n'
+static void formatWord(unsigned int binary, char* binaryStr) {
     for (int i = 31; i >= 0; i--) {
         binaryStr[31-i] = ((binary >> i) & 1) ? '1' : '0';
     }
-    binaryStr[32] = '\0';
-    
-    sprintf(binaryOutput, "%s\n", binaryStr);
+    binaryStr[32] = '\n';
+    binaryStr[33] = '\0';
 }
 
-int read_assembly_file(FILE* input_file) {
-    FILE* output = fopen("Output/binary.txt", "w");
-    if (output == NULL) {
-        printf("Erro: Não foi possível abrir o arquivo de saída.\n");
-        return -1;
+// Monta uma única instrução em texto; rótulos precisam já estar mapeados
+void generateBinary(const char* instruction, char* binaryOutput, int index_atual) {
+    char text[MAX_LINE_LENGTH];
+    MachineCode code;
+    unsigned int binary = 0;
+
+    snprintf(text, sizeof(text), "%s", instruction);
+    initMachineCode(&code, 0);
+    if (parseAssemblyText(text, &code) != 0 || code.count == 0 || code.items[code.count - 1].info == NULL) {
+        sprintf(binaryOutput, "// Instrução desconhecida: %s\n", instruction);
+    } else if (encodeInstruction(&code.items[code.count - 1], index_atual, &binary) != ENC_OK) {
+        sprintf(binaryOutput, "// Registrador inválido: %s\n", instruction);
+    } else {
+        formatWord(binary, binaryOutput);
     }
-    
-    // Primeira passagem: Construir o mapeamento de rótulos
-    char line[MAX_LINE_LENGTH];
-    char label[MAX_LINE_LENGTH];
-    int index;
-    
-    // Inicializar o array de mapeamento
+    freeMachineCode(&code);
+}
+
+// Palavra montada e o resultado da sua codificação
+typedef struct {
+    unsigned int bits;
+    EncodeStatus status;
+    int line;                     // instrução de origem, para as mensagens de erro
+} AsmWord;
+
+typedef struct {
+    AsmWord* words;
+    int count;
+    int capacity;
+} AsmWordList;
+
+static int fitsBranchOffset(int offset) {
+    return offset >= BRANCH_OFFSET_MIN && offset <= BRANCH_OFFSET_MAX;
+}
+
+static void emitWord(AsmWordList* out, unsigned int bits, EncodeStatus status, int line) {
+    if (out->count == out->capacity) {
+        out->capacity = out->capacity ? out->capacity * 2 : 256;
+        out->words = realloc(out->words, out->capacity * sizeof(AsmWord));
+    }
+    out->words[out->count].bits = bits;
+    out->words[out->count].status = status;
+    out->words[out->count].line = line;
+    out->count++;
+}
+
+static void encodeLine(AsmWordList* out, const MachineInstr* instr, int line) {
+    unsigned int bits = 0;
+    EncodeStatus status = encodeInstruction(instr, out->count, &bits);
+    emitWord(out, bits, status, line);
+}
+
+// Uma passagem sobre as instruções: cada rótulo é definido quando aparece e as
+// referências a rótulos à frente ficam pendentes até o fim, quando são corrigidas
+// (backpatching). Devolve quantos desvios relativos só descobriram no backpatching
+// que não cabem no imediato; nesse caso eles passam para a forma longa e a montagem
+// é refeita.
+static int assemblePass(const MachineCode* code, int* addresses, char* longForm,
+                        AsmWordList* out, FixupList* fixups, RelocationList* relocations) {
+    out->count = 0;
+    fixups->count = 0;
+    assemblerErrors = 0;
     freeLabelMappings();
-    
-    // Primeira passagem: extrair todos os rótulos e índices
-    while (fgets(line, MAX_LINE_LENGTH, input_file) != NULL) {
-        // Verificar se a linha contém um rótulo
-        char* colon_pos = strchr(line, ':');
-        if (colon_pos != NULL) {
-            // Extrair o rótulo e o índice
-            getLabelNumber(line, label, &index);
-            if (label[0] != '\0') {
-                addLabelMapping(label, index);
+    if (relocations != NULL) {
+        freeRelocations(relocations);
+    }
+
+    activeFixups = fixups;
+    activeRelocations = relocations;
+    for (int i = 0; i < code->count; i++) {
+        const MachineInstr* current = &code->items[i];
+        addresses[i] = out->count;
+        if (current->label != NULL) {
+            defineLabel(current->label, addresses[i]);
+        }
+        if (current->info == NULL) {
+            continue;
+        }
+        fixups->line = i;
+
+        // Desvio para trás: a distância já é conhecida
+        if (current->info->format == FMT_BRANCH_REL && !longForm[i] && current->symbol != NULL) {
+            int target = lookupLabel(current->symbol);
+            if (target != -1 && !fitsBranchOffset(target - addresses[i])) {
+                longForm[i] = 1;
             }
         }
+
+        if (longForm[i]) {
+            // addil $r43 $r44 destino + desvio absoluto (mnemônico sem o sufixo "r")
+            char absolute[16];
+            MachineInstr addil = *current;
+            MachineInstr branch = *current;
+            snprintf(absolute, sizeof(absolute), "%.*s", (int)strlen(current->info->mnemonic) - 1,
+                     current->info->mnemonic);
+            addil.info = findInstruction("addil");
+            addil.regs[0] = 43;
+            addil.regs[1] = 44;
+            branch.info = findInstruction(absolute);
+            encodeLine(out, &addil, i);
+            encodeLine(out, &branch, i);
+        } else {
+            encodeLine(out, current, i);
+        }
     }
-    
-
-    // Voltar ao início do arquivo para a segunda passagem
-    rewind(input_file);
-    int index_atual = 0;
-    // Processar o arquivo linha por linha
-    while (fgets(line, MAX_LINE_LENGTH, input_file) != NULL) {
-        char processed_line[MAX_LINE_LENGTH];
-        char comment[MAX_LINE_LENGTH] = ""; // Para armazenar comentários
-        
-        // Remover o índice no formato "0 - " do início da linha
-        char *current_pos = line;
-        
-        // Verificar se a linha começa com um número seguido de " - "
-        char *dash_pos = strstr(line, " - ");
-        if (dash_pos != NULL) {
-            // Verificar se todos os caracteres antes do " - " são dígitos
-            int is_index = 1;
-            for (char *p = line; p < dash_pos; p++) {
-                if (!isdigit(*p) && !isspace(*p)) {
-                    is_index = 0;
-                    break;
+    activeFixups = NULL;
+    activeRelocations = NULL;
+
+    int relaxed = 0;
+    for (int i = 0; i < fixups->count; i++) {
+        Fixup* fixup = &fixups->items[i];
+        AsmWord* word = &out->words[fixup->address];
+        int target = lookupLabel(fixup->label);
+        if (target == -1) {
+            printError("Erro: rótulo '%s' não definido.", fixup->label);
+            assemblerErrors++;
+            continue;
+        }
+        switch (fixup->kind) {
+            case FIX_REL14:
+                if (!fitsBranchOffset(target - fixup->address)) {
+                    longForm[fixup->line] = 1;
+                    relaxed++;
+                } else {
+                    word->bits |= (target - fixup->address) & 0x3FFF;
                 }
-            }
-            
-            // Se for um índice, pular para depois do " - "
-            if (is_index) {
-                current_pos = dash_pos + 3; // Pular o " - " (3 caracteres)
-            }
+                break;
+            case FIX_IMM14:
+                word->bits |= target & 0x3FFF;
+                break;
+            case FIX_TARGET26:
+                word->bits |= target & 0x3FFFFFF;
+                break;
         }
-        
-        // Verificar se a linha contém um rótulo (termina com ":")
-        char* colon_pos = strchr(current_pos, ':');
-        if (colon_pos != NULL) {
-            // Verificar se há comentário após o rótulo
-            char* comment_pos = strchr(colon_pos + 1, '#');
-            if (comment_pos != NULL) {
-                // Salvar o comentário para uso posterior
-                strcpy(comment, comment_pos);
-                *comment_pos = '\0'; // Corta a string no início do comentário
-            }
-            
-            // Remover o rótulo e os ":" e qualquer espaço após ele
-            char* after_colon = colon_pos + 1;
-            while (*after_colon && isspace(*after_colon)) {
-                after_colon++;
+    }
+    return relaxed;
+}
+
+// Grava a imagem como texto de bits, uma palavra por linha; palavras inválidas
+// viram comentários no lugar da instrução
+static void writeBitStrings(OutputBuffer* output, const MachineCode* code, const AsmWordList* words) {
+    char text[MAX_LINE_LENGTH];
+    for (int i = 0; i < words->count; i++) {
+        AsmWord* word = &words->words[i];
+        switch (word->status) {
+            case ENC_OK:
+                formatWord(word->bits, text);
+                bufferWrite(output, text, 33);
+                break;
+            case ENC_INVALID_R:
+                formatMachineInstr(&code->items[word->line], text, sizeof(text));
+                bufferPrintf(output, "// Registrador inválido: %s\n", text);
+                break;
+            case ENC_INVALID_I:
+                formatMachineInstr(&code->items[word->line], text, sizeof(text));
+                bufferPrintf(output, "// Invalid register in: %s\n", text);
+                break;
+        }
+    }
+}
+
+// Nos formatos de imagem e no objeto não há onde anotar a palavra inválida: vira erro
+static int checkWords(const MachineCode* code, const AsmWordList* words) {
+    char text[MAX_LINE_LENGTH];
+    int errors = 0;
+    for (int i = 0; i < words->count; i++) {
+        if (words->words[i].status != ENC_OK) {
+            formatMachineInstr(&code->items[words->words[i].line], text, sizeof(text));
+            printError("Erro: registrador inválido em '%s'.", text);
+            errors++;
+        }
+    }
+    return errors;
+}
+
+static unsigned int* wordBits(const AsmWordList* words) {
+    unsigned int* image = malloc((words->count + 1) * sizeof(unsigned int));
+    for (int i = 0; i < words->count; i++) {
+        image[i] = words->words[i].bits;
+    }
+    return image;
+}
+
+static int writeImage(OutputBuffer* output, const MachineCode* code, const AsmWordList* words) {
+    int errors = checkWords(code, words);
+    unsigned int* image = wordBits(words);
+    if (writeMemoryImage(output, formatoSaida, image, words->count) != 0) {
+        errors++;
+    }
+    free(image);
+    return errors;
+}
+
+// Tabela de linhas (-g): um registro "endereço<TAB>linha<TAB>função" a cada palavra
+// em que a linha do fonte ou a função muda; o registro vale até o endereço do
+// seguinte. Linha 0 e função "-" são palavras que não vieram do programa C-
+// (inicialização do BCP). No objeto (-c) os endereços são relativos ao objeto.
+static int writeLineTable(const MachineCode* code, const AsmWordList* words, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printError("Erro ao abrir %s.", path);
+        return -1;
+    }
+    fprintf(file, "# Tabela de linhas de %s: %d palavra(s)\n", arquivoFonte, words->count);
+    fprintf(file, "# endereço\tlinha\tfunção\n");
+
+    const char* function = "-";
+    int item = 0;
+    int records = 0;
+    int lastLine = -1;
+    const char* lastFunction = NULL;
+    for (int i = 0; i < words->count; i++) {
+        // Função da palavra: o último rótulo de função antes da instrução que a gerou
+        for (; item <= words->words[i].line; item++) {
+            if (code->items[item].isFunction) {
+                function = code->items[item].label;
             }
-            
-            // Se houver texto após o rótulo, copiar apenas essa parte
-            if (*after_colon) {
-                strcpy(processed_line, after_colon);
+        }
+        int line = code->items[words->words[i].line].sourceLine;
+        if (line != lastLine || function != lastFunction) {
+            fprintf(file, "%d\t%d\t%s\n", i, line, function);
+            lastLine = line;
+            lastFunction = function;
+            records++;
+        }
+    }
+    if (fclose(file) != 0) {
+        printError("Erro ao gravar %s.", path);
+        return -1;
+    }
+    printInfo("Tabela de linhas salva em %s (%d registro(s))", path, records);
+    return 0;
+}
+
+// Objeto relocável (-c): palavras, funções com seus deslocamentos e relocações
+static int writeObject(const MachineCode* code, const int* addresses, const AsmWordList* words,
+                       const RelocationList* relocations) {
+    int errors = checkWords(code, words);
+    if (errors > 0) {
+        return errors;
+    }
+
+    ObjectFile object = {0};
+    object.name = (char*)objectName(code);
+    object.words = wordBits(words);
+    object.count = words->count;
+    object.relocations = relocations->items;
+    object.relocationCount = relocations->count;
+    object.functions = malloc((code->count + 1) * sizeof(ObjectSymbol));
+    for (int i = 0; i < code->count; i++) {
+        if (code->items[i].isFunction) {
+            object.functions[object.functionCount].name = code->items[i].label;
+            object.functions[object.functionCount].offset = addresses[i];
+            object.functionCount++;
+        }
+    }
+
+    char file[MAX_LINE_LENGTH];
+    char path[OUTPUT_PATH_SIZE];
+    snprintf(file, sizeof(file), "%s.obj", object.name);
+    if (artefatos[ART_IMAGE].path != NULL) {
+        snprintf(path, sizeof(path), "%s", artefatos[ART_IMAGE].path);  // -o
+    } else {
+        outputPath(path, sizeof(path), file);
+    }
+    if (strcmp(path, OUTPUT_STDOUT) == 0) {
+        printError("Erro: o objeto (-c) não pode ir para a saída padrão; use -o arquivo.obj.");
+        errors++;
+    } else if (writeObjectFile(&object, path) != 0) {
+        printError("Erro ao gravar %s.", path);
+        errors++;
+    } else {
+        printInfo("Objeto salvo em %s (%d palavras, %d relocação(ões))", path, object.count,
+               object.relocationCount);
+    }
+    free(object.words);
+    free(object.functions);
+    return errors;
+}
+
+// Monta o programa já decodificado e grava a imagem no formato escolhido
+// (binary.txt no diretório de saída por padrão) ou, com -c, o objeto relocável
+int assembleMachineCode(const MachineCode* code) {
+    int* addresses = calloc(code->count + 1, sizeof(int));
+    char* longForm = calloc(code->count + 1, 1);
+    AsmWordList words = {NULL, 0, 0};
+    FixupList fixups = {NULL, 0, 0, 0};
+    RelocationList relocations = {NULL, 0, 0};
+
+    while (assemblePass(code, addresses, longForm, &words, &fixups,
+                        gerarObjeto ? &relocations : NULL) > 0 && assemblerErrors == 0) {
+        // algum desvio foi relaxado: endereços mudaram, monta de novo
+    }
+
+    int relativeBranches = 0;
+    int relaxed = 0;
+    for (int i = 0; i < code->count; i++) {
+        const MachineInstr* instr = &code->items[i];
+        if (instr->label != NULL && lookupLabel(instr->label) == addresses[i]) {
+            printInfo("Mapeamento: %s -> %d", instr->label, addresses[i]);
+        }
+        if (instr->info != NULL && instr->info->format == FMT_BRANCH_REL) {
+            relativeBranches++;
+        }
+        relaxed += longForm[i];
+    }
+    if (relativeBranches > 0) {
+        printInfo("Desvios relativos ao PC: %d (%d relaxado(s) para a forma longa)",
+               relativeBranches, relaxed);
+    }
+
+    int imageErrors = 0;
+    char path[OUTPUT_PATH_SIZE];
+    artifactPath(ART_IMAGE, path, sizeof(path));
+    if (gerarObjeto) {
+        if (assemblerErrors == 0) {
+            imageErrors = writeObject(code, addresses, &words, &relocations);
+        }
+    } else {
+        OutputBuffer* output = openOutputBuffer(path, formatoSaida != OUT_BITS);
+        if (output == NULL) {
+            printError("Erro: Não foi possível abrir o arquivo de saída.");
+            imageErrors++;
+        } else {
+            if (formatoSaida == OUT_BITS) {
+                writeBitStrings(output, code, &words);
             } else {
-                processed_line[0] = '\0'; // Linha vazia se não houver nada após o rótulo
+                imageErrors = writeImage(output, code, &words);
             }
-            
-            // Adicionar o comentário de volta, se existir
-            if (comment[0] != '\0') {
-                // Substituir '#' por '//'
-                comment[0] = '\0';
-                strcat(processed_line, "// ");
-                strcat(processed_line, comment + 1);
-            }
-        } else {
-            // Não é um rótulo, apenas processar comentários normalmente
-            strcpy(processed_line, current_pos);
-            
-            // Processar comentários: substituir '#' por '//'
-            char *comment_pos = strchr(processed_line, '#');
-            if (comment_pos != NULL) {
-                *comment_pos = '\0'; // Termina a string no marcador de comentário
-                
-                // Recria a linha com o novo marcador de comentário
-                char temp[MAX_LINE_LENGTH];
-                snprintf(temp, MAX_LINE_LENGTH, "%s// %s", processed_line, comment_pos + 1);
-                strcpy(processed_line, temp);
+            if (closeOutputBuffer(output) != 0) {
+                printError("Erro ao gravar %s.", path);
+                imageErrors++;
+            } else if (imageErrors > 0 && strcmp(path, OUTPUT_STDOUT) != 0) {
+                remove(path); // não deixa uma imagem incompleta para a placa
             }
         }
-            
-        // gera o binário apenas para linhas que não são vazias e não são rótulos
-        if (processed_line[0] != '\0' && processed_line[0] != '/') {
-            char binaryInstruction[MAX_LINE_LENGTH];
-            generateBinary(processed_line, binaryInstruction, index_atual);
-            fprintf(output, "%s", binaryInstruction);
-            index_atual++;
-        } else if (processed_line[0] != '\0') {
-            // fprintf(output, "%s", processed_line);
+    }
+
+    if (assemblerErrors == 0 && artifactPath(ART_LINES, path, sizeof(path)) &&
+        writeLineTable(code, &words, path) != 0) {
+        imageErrors++;
+    }
+    if (assemblerErrors == 0 && artifactPath(ART_MAP, path, sizeof(path)) &&
+        writeFunctionMap(code, addresses, words.count, path) != 0) {
+        imageErrors++;
+    }
+    if (assemblerErrors == 0) {
+        checkSlotSize(words.count);
+    }
+
+    free(words.words);
+    free(fixups.items);
+    freeRelocations(&relocations);
+    free(relocations.items);
+    free(addresses);
+    free(longForm);
+    if (assemblerErrors > 0) {
+        printError("Montagem concluída com %d erro(s) de rótulo.", assemblerErrors);
+        return -1;
+    }
+    return imageErrors > 0 ? -1 : 0;
+}
+
+// Monta o programa só em memória, sem gravar a imagem (usado pelo simulador).
+// O chamador libera *image.
+int assembleImage(const MachineCode* code, unsigned int** image, int* count) {
+    int* addresses = calloc(code->count + 1, sizeof(int));
+    char* longForm = calloc(code->count + 1, 1);
+    AsmWordList words = {NULL, 0, 0};
+    FixupList fixups = {NULL, 0, 0, 0};
+
+    while (assemblePass(code, addresses, longForm, &words, &fixups, NULL) > 0 && assemblerErrors == 0) {
+        // algum desvio foi relaxado: monta de novo
+    }
+    int errors = assemblerErrors + checkWords(code, &words);
+    *image = wordBits(&words);
+    *count = words.count;
+
+    free(words.words);
+    free(fixups.items);
+    free(addresses);
+    free(longForm);
+    return errors > 0 ? -1 : 0;
+}
+
+// Lê todo o arquivo para um único buffer terminado em '\0'
+static char* readWholeFile(FILE* input_file) {
+    size_t capacity = 1 << 16;
+    size_t used = 0;
+    size_t n;
+    char* buffer = malloc(capacity);
+
+    while ((n = fread(buffer + used, 1, capacity - used - 1, input_file)) > 0) {
+        used += n;
+        if (used + 1 == capacity) {
+            capacity *= 2;
+            buffer = realloc(buffer, capacity);
         }
     }
-    
-    fclose(output);
-    return 0;
-}
\ No newline at end of file
+    buffer[used] = '\0';
+    return buffer;
+}
+
+// Monta um assembly em texto (por exemplo, um assembly.asm gerado com -S)
+int read_assembly_file(FILE* input_file) {
+    char* buffer = readWholeFile(input_file);
+    MachineCode code;
+    initMachineCode(&code, 0);
+
+    int errors = parseAssemblyText(buffer, &code);
+    int result = assembleMachineCode(&code);
+
+    freeMachineCode(&code);
+    free(buffer);
+    return errors > 0 ? -1 : result;
+}
+
+// Monta um assembly em texto só em memória (entrada do simulador)
+int readAssemblyImage(FILE* input_file, unsigned int** image, int* count) {
+    char* buffer = readWholeFile(input_file);
+    MachineCode code;
+    initMachineCode(&code, 0);
+
+    int errors = parseAssemblyText(buffer, &code);
+    int result = assembleImage(&code, image, count);
+
+    freeMachineCode(&code);
+    free(buffer);
+    return errors > 0 ? -1 : result;
+}
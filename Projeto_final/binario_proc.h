@@ -2,38 +2,80 @@
 #define BINARIO_PROC_H
 
 #include "globals.h"
-#include "assembly_mips.h"
+#include "codigo_maquina.h"
+#include "formato_saida.h"
 
 #define MAX_LINE_LENGTH 1024
 
-#define MAX_LABELS 1000
+#define LABEL_MAP_INITIAL_CAPACITY 64 // potência de 2; dobra quando a carga passa de 3/4
 
-// Estrutura para armazenar mapeamentos de rótulos e índices
-typedef struct {
+// Alcance do imediato de 14 bits com sinal usado pelos desvios relativos ao PC
+#define BRANCH_OFFSET_MIN (-8192)
+#define BRANCH_OFFSET_MAX 8191
+
+// Estrutura para armazenar mapeamentos de rótulos e índices (entrada de um bucket)
+typedef struct LabelMapping {
     char* label;
     int index;
+    struct LabelMapping* next;
 } LabelMapping;
 
-//tipos das instruções
+// Tabela hash de rótulos com encadeamento, cresce conforme o programa
+typedef struct {
+    LabelMapping** buckets;
+    int capacity;
+    int count;
+} LabelMap;
+
+// Campo a corrigir quando o rótulo de uma referência à frente for definido
 typedef enum {
-    TYPE_R,
-    TYPE_I,
-    TYPE_J,
-    TYPE_MK, //KERNEL
-    TYPE_MU, //USER
-    TYPE_COMM, 
-    TYPE_INVALID
-} InstructionType;
-
-//detalhes das instruções
+    FIX_IMM14,      // imediato absoluto (li, addil, desvios absolutos)
+    FIX_REL14,      // imediato relativo ao endereço do desvio
+    FIX_TARGET26    // destino de j/jal
+} FixupKind;
+
+// Referência pendente a um rótulo ainda não definido
+typedef struct {
+    const char* label;
+    int address;    // endereço da palavra a corrigir
+    int line;       // linha de origem (para relaxar o desvio)
+    FixupKind kind;
+} Fixup;
+
 typedef struct {
-    char mnemonic[10];
-    InstructionType type;
-    unsigned int opcode;
-    unsigned int funct;
-} InstructionInfo;
+    Fixup* items;
+    int count;
+    int capacity;
+    int line;       // linha sendo montada
+} FixupList;
+
+// Referência a outra imagem (@imagem): o ligador soma o endereço de carga dela
+typedef struct {
+    char* symbol;   // nome da imagem, sem o '@'
+    int address;    // endereço da palavra no objeto
+    FixupKind kind;
+} Relocation;
+
+typedef struct {
+    Relocation* items;
+    int count;
+    int capacity;
+} RelocationList;
+
+// Resultado da codificação de uma instrução
+typedef enum {
+    ENC_OK,
+    ENC_INVALID_R,  // registrador inválido no formato R
+    ENC_INVALID_I   // registrador inválido no formato I
+} EncodeStatus;
 
-void getLabelNumber(char* line, char* label, int* index);
+int lookupLabel(const char* label);
+void freeLabelMappings(void);
+int isRelativeBranch(const char* mnemonic);
+void generateBinary(const char* instruction, char* binaryOutput, int index_atual);
+int assembleMachineCode(const MachineCode* code);
 int read_assembly_file(FILE* input_file);
+int assembleImage(const MachineCode* code, unsigned int** image, int* count);
+int readAssemblyImage(FILE* input_file, unsigned int** image, int* count);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "cache_funcoes.h"
+#include "formato_saida.h"
+#include <unistd.h>
+
+int cacheFuncoes = 0;
+
+static int cacheHits = 0;
+static int cacheMisses = 0;
+
+// Uma função guardada: as quádruplas e o código em texto, como no arquivo. O texto
+// só é interpretado quando a chave é encontrada.
+typedef struct {
+    unsigned long long key;
+    char* text;
+    size_t size;
+    int used;  // encontrada ou gerada nesta compilação
+} CachedFunction;
+
+static CachedFunction* cacheEntries = NULL;
+static int cacheCount = 0;
+static int cacheCapacity = 0;
+static int cacheSorted = 0;   // entradas [0, cacheSorted) vieram do arquivo, em ordem de chave
+static int cacheLoaded = 0;
+static int cacheChanged = 0;  // alguma função entrou: o arquivo é regravado
+
+unsigned long long hashString(unsigned long long hash, const char* text) {
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        hash ^= *p;
+        hash *= 1099511628211ULL;
+    }
+    hash ^= 0xFF; // separador: "ab" + "c" != "a" + "bc"
+    hash *= 1099511628211ULL;
+    return hash;
+}
+
+// Os quatro bytes do valor: largura fixa, sem separador
+unsigned long long hashInt(unsigned long long hash, int value) {
+    unsigned int bits = (unsigned int)value;
+    for (int i = 0; i < 4; i++) {
+        hash ^= (bits >> (8 * i)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/* ---------- chave ---------- */
+
+// O que o escopo global da tabela de símbolos diz de um nome usado pela função
+// (variável global, vetor, tipo de retorno e aridade das funções chamadas). Os nomes
+// locais vêm das declarações da própria subárvore.
+static unsigned long long symbolInfoHash(char* name) {
+    BucketList symbol = st_lookup_in_scope(name, "global");
+    if (symbol == NULL) {
+        return hashString(HASH_SEED, "?");
+    }
+    unsigned long long hash = hashString(HASH_SEED, symbol->idType ? symbol->idType : "-");
+    hash = hashString(hash, symbol->dataType ? symbol->dataType : "-");
+    hash = hashInt(hash, symbol->isArray);
+    hash = hashInt(hash, symbol->arraySize);
+    return hashInt(hash, symbol->paramCount);
+}
+
+// Os mesmos nomes (funções chamadas, globais, locais comuns como i) aparecem em
+// muitas funções, e cada busca no escopo global percorre a lista inteira do balde:
+// a informação de cada nome é calculada uma vez por compilação
+typedef struct {
+    const char* name;
+    unsigned long long info;
+} SymbolMemo;
+
+static SymbolMemo* symbolMemo = NULL;
+static int symbolMemoCount = 0;
+static int symbolMemoCapacity = 0;  // potência de 2
+
+static SymbolMemo* findSymbolMemo(SymbolMemo* table, int capacity, const char* name) {
+    unsigned int i = (unsigned int)hashString(HASH_SEED, name) & (capacity - 1);
+    while (table[i].name != NULL && strcmp(table[i].name, name) != 0) {
+        i = (i + 1) & (capacity - 1);
+    }
+    return &table[i];
+}
+
+static unsigned long long symbolInfo(char* name) {
+    if (2 * (symbolMemoCount + 1) > symbolMemoCapacity) {
+        int capacity = symbolMemoCapacity ? symbolMemoCapacity * 2 : 256;
+        SymbolMemo* table = calloc(capacity, sizeof(SymbolMemo));
+        for (int i = 0; i < symbolMemoCapacity; i++) {
+            if (symbolMemo[i].name != NULL) {
+                *findSymbolMemo(table, capacity, symbolMemo[i].name) = symbolMemo[i];
+            }
+        }
+        free(symbolMemo);
+        symbolMemo = table;
+        symbolMemoCapacity = capacity;
+    }
+    SymbolMemo* memo = findSymbolMemo(symbolMemo, symbolMemoCapacity, name);
+    if (memo->name == NULL) {
+        memo->name = name;  // nome da árvore sintática, vivo até o fim da compilação
+        memo->info = symbolInfoHash(name);
+        symbolMemoCount++;
+    }
+    return memo->info;
+}
+
+// Nomes usados pela função, cada um uma vez, na ordem em que aparecem
+typedef struct {
+    char** names;
+    int count;
+    int capacity;
+} NameList;
+
+static void addName(NameList* list, char* name) {
+    for (int i = 0; i < list->count; i++) {
+        if (strcmp(list->names[i], name) == 0) return;
+    }
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 32;
+        list->names = realloc(list->names, list->capacity * sizeof(char*));
+    }
+    list->names[list->count++] = name;
+}
+
+// Subárvore inteira, com a forma (filhos ausentes contam) e as linhas relativas
+static unsigned long long hashTree(unsigned long long hash, ASTNode* node, int linhaBase, NameList* names) {
+    if (node == NULL) {
+        return hashInt(hash, -1);
+    }
+    hash = hashInt(hash, node->type);
+    hash = hashInt(hash, node->lineno - linhaBase);
+    hash = hashInt(hash, node->isArray);
+    hash = hashInt(hash, node->arraySize);
+    hash = hashString(hash, node->idType ? node->idType : "");
+    hash = hashString(hash, node->scope ? node->scope : "");
+    hash = hashInt(hash, node->value != NULL);
+    if (node->value != NULL) {
+        hash = hashString(hash, node->value);
+        if (isalpha((unsigned char)node->value[0]) && node->type != NODE_SPEC_TYPE) {
+            addName(names, node->value);
+        }
+    }
+    hash = hashTree(hash, node->left, linhaBase, names);
+    return hashTree(hash, node->right, linhaBase, names);
+}
+
+unsigned long long functionCacheKey(ASTNode* funcDecl, const GlobalRegisterMap* globais, int primeiraFuncao,
+                                    int keepComments) {
+    unsigned long long hash = hashInt(HASH_SEED, FUNCTION_CACHE_VERSION);
+    hash = hashInt(hash, desvioLongo);
+    hash = hashInt(hash, divisaoPorDeslocamento);
+    hash = hashInt(hash, keepComments);
+    hash = hashInt(hash, primeiraFuncao);
+    for (int i = 0; i < GLOBAL_REGISTER_COUNT; i++) {
+        hash = hashString(hash, globais->nomes[i]);
+    }
+    NameList names = {NULL, 0, 0};
+    hash = hashTree(hash, funcDecl, functionSourceLine(funcDecl), &names);
+    for (int i = 0; i < names.count; i++) {
+        unsigned long long info = symbolInfo(names.names[i]);
+        hash = hashInt(hash, (int)info);
+        hash = hashInt(hash, (int)(info >> 32));
+    }
+    free(names.names);
+    return hash;
+}
+
+/* ---------- arquivo do cache ---------- */
+
+// FUNCOES versão quantidade
+// F chave bytes, seguido do texto da função: "R retornos quádruplas entradas",
+// as quádruplas (writeIRUnit) e o código (writeMachineCodeRange)
+
+static CachedFunction* addCacheEntry(unsigned long long key, char* text, size_t size) {
+    if (cacheCount == cacheCapacity) {
+        cacheCapacity = cacheCapacity ? cacheCapacity * 2 : 256;
+        cacheEntries = realloc(cacheEntries, cacheCapacity * sizeof(CachedFunction));
+    }
+    CachedFunction* entry = &cacheEntries[cacheCount++];
+    entry->key = key;
+    entry->text = text;
+    entry->size = size;
+    entry->used = 0;
+    return entry;
+}
+
+static int compareCacheEntries(const void* a, const void* b) {
+    unsigned long long ka = ((const CachedFunction*)a)->key;
+    unsigned long long kb = ((const CachedFunction*)b)->key;
+    return ka < kb ? -1 : ka > kb;
+}
+
+static void freeFunctionCache(void) {
+    for (int i = 0; i < cacheCount; i++) {
+        free(cacheEntries[i].text);
+    }
+    free(cacheEntries);
+    cacheEntries = NULL;
+    cacheCount = 0;
+    cacheCapacity = 0;
+    cacheSorted = 0;
+    cacheLoaded = 0;
+    cacheChanged = 0;
+    free(symbolMemo);
+    symbolMemo = NULL;
+    symbolMemoCount = 0;
+    symbolMemoCapacity = 0;
+}
+
+// Lê o arquivo inteiro de uma vez; um arquivo de outra versão ou truncado vale o
+// que foi lido até o problema
+static void loadFunctionCache(void) {
+    char path[OUTPUT_PATH_SIZE];
+    char line[128];
+    int version = 0;
+    int count = 0;
+
+    cacheLoaded = 1;
+    outputPath(path, sizeof(path), FUNCTION_CACHE_FILE);
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return;
+    }
+    if (fgets(line, sizeof(line), file) == NULL || sscanf(line, "FUNCOES %d %d", &version, &count) != 2 ||
+        version != FUNCTION_CACHE_VERSION) {
+        fclose(file);
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        unsigned long long key;
+        size_t size;
+        if (fgets(line, sizeof(line), file) == NULL || sscanf(line, "F %llx %zu", &key, &size) != 2) {
+            break;
+        }
+        char* text = malloc(size + 1);
+        if (fread(text, 1, size, file) != size) {
+            free(text);
+            break;
+        }
+        text[size] = '\0';
+        addCacheEntry(key, text, size);
+    }
+    fclose(file);
+    qsort(cacheEntries, cacheCount, sizeof(CachedFunction), compareCacheEntries);
+    cacheSorted = cacheCount;
+}
+
+int loadCachedFunction(unsigned long long key, IRCode* ir, MachineCode* code, int* retornos, int linhaBase) {
+    if (!cacheLoaded) {
+        loadFunctionCache();
+    }
+    CachedFunction wanted = {key, NULL, 0, 0};
+    CachedFunction* entry = cacheSorted > 0 ? bsearch(&wanted, cacheEntries, cacheSorted, sizeof(CachedFunction),
+                                                      compareCacheEntries)
+                                            : NULL;
+    if (entry == NULL) {
+        cacheMisses++;
+        return -1;
+    }
+
+    int quadruplas = 0;
+    int entradas = 0;
+    int start = code->count;
+    FILE* file = fmemopen(entry->text, entry->size, "r");
+    int ok = file != NULL && fscanf(file, "R %d %d %d\n", retornos, &quadruplas, &entradas) == 3 &&
+             readIRUnit(file, ir, quadruplas, linhaBase) == 0 &&
+             readMachineCodeRange(file, code, entradas, linhaBase) == 0;
+    if (file != NULL) {
+        fclose(file);
+    }
+    // Texto incompleto: descarta o que foi lido, e a função é gerada de novo
+    if (!ok) {
+        freeIRUnit(ir);
+        while (code->count > start) {
+            freeMachineInstr(&code->items[--code->count]);
+        }
+        cacheMisses++;
+        return -1;
+    }
+    entry->used = 1;
+    cacheHits++;
+    return 0;
+}
+
+void storeCachedFunction(unsigned long long key, const IRCode* ir, const MachineCode* code, int retornos,
+                         int linhaBase) {
+    char* text = NULL;
+    size_t size = 0;
+    FILE* file = open_memstream(&text, &size);
+    if (file == NULL) {
+        return;
+    }
+    int quadruplas = 0;
+    for (const Quadruple* q = ir->head; q != NULL; q = q->next) quadruplas++;
+    fprintf(file, "R %d %d %d\n", retornos, quadruplas, code->count);
+    writeIRUnit(file, ir, linhaBase);
+    writeMachineCodeRange(file, code, 0, code->count, linhaBase);
+    if (fclose(file) != 0) {
+        free(text);
+        return;
+    }
+    addCacheEntry(key, text, size)->used = 1;
+    cacheChanged = 1;
+}
+
+void saveFunctionCache(void) {
+    char path[OUTPUT_PATH_SIZE];
+    char temp[OUTPUT_PATH_SIZE + 16];
+
+    if (cacheChanged) {
+        outputPath(path, sizeof(path), FUNCTION_CACHE_FILE);
+        // processos do lote (-j) com o mesmo diretório não gravam pela metade o arquivo do outro
+        snprintf(temp, sizeof(temp), "%s.%d.tmp", path, (int)getpid());
+        FILE* file = fopen(temp, "wb");
+        if (file != NULL) {
+            int count = cacheCount < FUNCTION_CACHE_MAX_ENTRIES ? cacheCount : FUNCTION_CACHE_MAX_ENTRIES;
+            fprintf(file, "FUNCOES %d %d\n", FUNCTION_CACHE_VERSION, count);
+            // As usadas nesta compilação primeiro: são as que o limite não pode tirar
+            int written = 0;
+            for (int pass = 1; pass >= 0; pass--) {
+                for (int i = 0; i < cacheCount && written < count; i++) {
+                    if (cacheEntries[i].used == pass) {
+                        fprintf(file, "F %016llx %zu\n", cacheEntries[i].key, cacheEntries[i].size);
+                        fwrite(cacheEntries[i].text, 1, cacheEntries[i].size, file);
+                        written++;
+                    }
+                }
+            }
+            if (fclose(file) == 0) {
+                rename(temp, path);
+            } else {
+                remove(temp);
+            }
+        }
+    }
+    freeFunctionCache();
+}
+
+void resetFunctionCacheStats(void) {
+    cacheHits = 0;
+    cacheMisses = 0;
+    freeFunctionCache();  // o cache do programa anterior do lote é de outro diretório
+}
+
+void printFunctionCacheStats(void) {
+    printInfo("Cache de funções: %d reaproveitada(s), %d gerada(s)", cacheHits, cacheMisses);
+}
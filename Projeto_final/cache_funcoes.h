@@ -0,0 +1,41 @@
+#ifndef CACHE_FUNCOES_H
+#define CACHE_FUNCOES_H
+
+#include "globals.h"
+#include "asnt.h"
+#include "cinter.h"
+#include "assembly_mips.h"
+
+#define FUNCTION_CACHE_VERSION 5          // muda quando o código gerado ou o formato do arquivo mudam
+#define FUNCTION_CACHE_FILE "funcoes.cache"  // no diretório de saída, um por programa do lote
+#define FUNCTION_CACHE_MAX_ENTRIES 4096   // funções guardadas; as não usadas na compilação saem primeiro
+#define HASH_SEED 1469598103934665603ULL  // FNV-1a de 64 bits
+
+extern int cacheFuncoes;    // --cache: reaproveita o código de funções que não mudaram
+
+unsigned long long hashString(unsigned long long hash, const char* text);
+unsigned long long hashInt(unsigned long long hash, int value);
+
+// Chave de uma função: a subárvore dela com as linhas relativas ao cabeçalho, o que
+// a tabela de símbolos diz de cada nome usado (inclusive o tipo e a aridade das
+// funções chamadas), os registradores das globais na entrada, se é a primeira
+// função e as opções que mudam o código
+unsigned long long functionCacheKey(ASTNode* funcDecl, const GlobalRegisterMap* globais, int primeiraFuncao,
+                                    int keepComments);
+
+// Função guardada com a chave: as quádruplas vão para ir e as entradas para code,
+// com as linhas contadas a partir de linhaBase. O arquivo é lido na primeira busca.
+// Devolve 0 se encontrou.
+int loadCachedFunction(unsigned long long key, IRCode* ir, MachineCode* code, int* retornos, int linhaBase);
+
+// Guarda uma função gerada nesta compilação (ainda com os nomes a partir de zero)
+void storeCachedFunction(unsigned long long key, const IRCode* ir, const MachineCode* code, int retornos,
+                         int linhaBase);
+
+// Grava o arquivo, de uma vez, se alguma função entrou, e libera o cache da memória
+void saveFunctionCache(void);
+
+void resetFunctionCacheStats(void);
+void printFunctionCacheStats(void);
+
+#endif
@@ -1,16 +1,22 @@
 #include "cinter.h"
+#include "inliner.h"
+#include "perfil.h"
+#include "formato_saida.h"
+#include "tempo_fases.h"
 
 static IRCode irCode;
 
+// Variável global para rastrear a linha atual do código fonte
+static int currentSourceLine = 0;
+
 // Função para gerar um novo nome de variável temporária para chamadas void, apenas para manipulação
-static int voidTempCount = 0;
 char* newVoidTemp(void) {
-    char* temp = (char*)malloc(12);
+    char* temp = (char*)memAlloc(12);
     if (temp == NULL) {
         fprintf(stderr, "Erro: Falha ao alocar memória para variável temporária void.\n");
         exit(EXIT_FAILURE);
     }
-    sprintf(temp, "tv%d", voidTempCount++);
+    sprintf(temp, "tv%d", irCode.void_temp_count++);
     return temp;
 }
 
@@ -41,6 +47,7 @@ const char* getOpName(OperationType op) {
         case OP_ALLOC: return "ALLOC";
         case OP_FUNCTION: return "FUNCTION";
         case OP_END: return "END";
+        case OP_COUNT: return "COUNT";
         default: return "UNKNOWN";
     }
 }
@@ -88,26 +95,47 @@ void initIRCode(void) {
     irCode.tail = NULL;
     irCode.temp_count = 0;
     irCode.label_count = 0;
+    irCode.void_temp_count = 0;
+    irCode.quad_count = 0;
+    currentSourceLine = 0;
+}
+
+// Acesso à lista de quádruplas para as passagens que a transformam (inliner)
+IRCode* getIRCode(void) {
+    return &irCode;
+}
+
+// Verifica se a função é um dos pontos de entrada dos dispatchers
+int isDispatcherEntry(const char* name) {
+    return name != NULL && (strcmp(name, "dispatcherloadnpremp") == 0 ||
+                            strcmp(name, "dispatchersavenpremp") == 0 ||
+                            strcmp(name, "dispatchersavepprog") == 0 ||
+                            strcmp(name, "dispatchersavepremp") == 0);
 }
 
 // Libera a memória alocada para o código intermediário
 void freeIRCode(void) {
-    Quadruple* current = irCode.head;
+    freeIRUnit(&irCode);
+}
+
+// Libera as quádruplas de uma declaração ainda não ligada ao programa
+void freeIRUnit(IRCode* unit) {
+    Quadruple* current = unit->head;
     while (current != NULL) {
         Quadruple* temp = current;
         current = current->next;
-        if (temp->arg1) free(temp->arg1);
-        if (temp->arg2) free(temp->arg2);
-        if (temp->result) free(temp->result);
-        free(temp);
+        if (temp->arg1) memFree(temp->arg1);
+        if (temp->arg2) memFree(temp->arg2);
+        if (temp->result) memFree(temp->result);
+        memFree(temp);
     }
-    irCode.head = NULL;
-    irCode.tail = NULL;
+    unit->head = NULL;
+    unit->tail = NULL;
 }
 
 // Gera um novo nome de variável temporária t_
 char* newTemp(void) {
-    char* temp = (char*)malloc(12);
+    char* temp = (char*)memAlloc(12);
     if (temp == NULL) {
         fprintf(stderr, "Erro: Falha ao alocar memória para variável temporária.\n");
         exit(EXIT_FAILURE);
@@ -118,7 +146,7 @@ char* newTemp(void) {
 
 // Gera um novo rótulo para desvios (label L_)
 char* newLabel(void) {
-    char* label = (char*)malloc(12);
+    char* label = (char*)memAlloc(12);
     if (label == NULL) {
         fprintf(stderr, "Erro: Falha ao alocar memória para rótulo.\n");
         exit(EXIT_FAILURE);
@@ -127,24 +155,20 @@ char* newLabel(void) {
     return label;
 }
 
-// Variável global para rastrear a linha atual do código fonte
-static int currentSourceLine = 0;
-
 // Adiciona uma nova quadrupla à lista de código intermediário
 void genQuad(OperationType op, char* arg1, char* arg2, char* result) {
-    static int currentLine = 1;
-    Quadruple* quad = (Quadruple*)malloc(sizeof(Quadruple));
+    Quadruple* quad = (Quadruple*)memAlloc(sizeof(Quadruple));
     if (quad == NULL) {
         fprintf(stderr, "Erro: Falha ao alocar memória para quadrupla.\n");
         exit(EXIT_FAILURE);
     }
     
     quad->op = op;
-    quad->arg1 = arg1 ? strdup(arg1) : NULL;
-    quad->arg2 = arg2 ? strdup(arg2) : NULL;
-    quad->result = result ? strdup(result) : NULL;
+    quad->arg1 = arg1 ? memStrdup(arg1) : NULL;
+    quad->arg2 = arg2 ? memStrdup(arg2) : NULL;
+    quad->result = result ? memStrdup(result) : NULL;
     quad->next = NULL;
-    quad->line = currentLine++;
+    quad->line = ++irCode.quad_count;
     quad->sourceLine = currentSourceLine;  // Usa a linha atual do código fonte
     
     DEBUG_IR("Gerando quadrupla: %s %s %s %s (quad: %d, fonte: %d)", 
@@ -161,18 +185,12 @@ void genQuad(OperationType op, char* arg1, char* arg2, char* result) {
     }
 }
 
-// Imprime o código intermediário gerado em quádruplas
-void printIRCode(FILE* listing) {
-    // Cria arquivo de saída para as quádruplas
-    FILE* outfile = fopen("Output/quadruples.txt", "w");
-    if (outfile == NULL) {
-        fprintf(stderr, "Erro: Não foi possível criar o arquivo de saída para quádruplas.\n");
-    } else {
-        fprintf(outfile, "Código Intermediário (Quadruplas):\n");
-        fprintf(outfile, "------------------------------------------------------------\n");
-        fprintf(outfile, "Quad  Fonte  Operação    Arg1        Arg2        Resultado\n");
-        fprintf(outfile, "------------------------------------------------------------\n");
-    }
+// Imprime o código intermediário gerado em quádruplas (quadruples.txt)
+void printIRCode(FILE* outfile) {
+    fprintf(outfile, "Código Intermediário (Quadruplas):\n");
+    fprintf(outfile, "------------------------------------------------------------\n");
+    fprintf(outfile, "Quad  Fonte  Operação    Arg1        Arg2        Resultado\n");
+    fprintf(outfile, "------------------------------------------------------------\n");
     
     Quadruple* current = irCode.head;
     while (current != NULL) {
@@ -203,34 +221,32 @@ void printIRCode(FILE* listing) {
             case OP_ALLOC: strcpy(op_str, "ALLOC"); break;
             case OP_FUNCTION: strcpy(op_str, "FUNCTION"); break;
             case OP_END: strcpy(op_str, "END"); break;
+            case OP_COUNT: strcpy(op_str, "COUNT"); break;
             default: strcpy(op_str, "UNKNOWN"); break;
         }
         
-        // Escreve também no arquivo de saída
-        if (outfile != NULL) {
-            fprintf(outfile, "%-6d %-6d %-12s %-12s %-12s %-12s\n",
-                    current->line,
-                    current->sourceLine,
-                    op_str,
-                    current->arg1 ? current->arg1 : "-",
-                    current->arg2 ? current->arg2 : "-",
-                    current->result ? current->result : "-");
-        }
+        fprintf(outfile, "%-6d %-6d %-12s %-12s %-12s %-12s\n",
+                current->line,
+                current->sourceLine,
+                op_str,
+                current->arg1 ? current->arg1 : "-",
+                current->arg2 ? current->arg2 : "-",
+                current->result ? current->result : "-");
         
         current = current->next;
     }
     
-    if (outfile != NULL) {
-        fprintf(outfile, "------------------------------------------------------------\n");
-        fclose(outfile);
-        printf("Código intermediário (quádruplas) salvo em 'Projeto_final/Output/quadruples.txt'\n");
-    }
+    fprintf(outfile, "------------------------------------------------------------\n");
 }
 
 // Função para imprimir as quadruplas como código intermediário de 3 endereços
 void printThreeAddressCode(FILE* listing) {
     // Cria arquivo de saída para o código de 3 endereços
-    FILE* outfile = fopen("Output/three_address_code.txt", "w");
+    char path[OUTPUT_PATH_SIZE];
+    if (!artifactPath(ART_TAC, path, sizeof(path))) {
+        return;  // só com --emit-tac ou --save-temps
+    }
+    FILE* outfile = fopen(path, "w");
     if (outfile == NULL) {
         fprintf(stderr, "Erro: Não foi possível criar o arquivo de saída para código de 3 endereços.\n");
     } else {
@@ -325,6 +341,9 @@ void printThreeAddressCode(FILE* listing) {
             case OP_END:
                 sprintf(line, "end %s", current->arg1);
                 break;
+            case OP_COUNT:
+                sprintf(line, "count [%s]", current->arg1);
+                break;
             default:
                 sprintf(line, "unknown operation");
                 break;
@@ -341,7 +360,7 @@ void printThreeAddressCode(FILE* listing) {
     if (outfile != NULL) {
         fprintf(outfile, "-------------------------------------\n");
         fclose(outfile);
-        printf("Código de 3 endereços salvo em 'Projeto_final/Output/three_address_code.txt'\n");
+        printInfo("Código de 3 endereços salvo em '%s'", path);
     }
 }
 
@@ -686,10 +705,15 @@ void processParamDeclarations(ASTNode* params) {
     }
 }
 
+// A linha do nó é a do fim da função; a do tipo de retorno é a do cabeçalho
+int functionSourceLine(const ASTNode* funcDecl) {
+    return funcDecl->left != NULL && funcDecl->left->left != NULL ? funcDecl->left->left->lineno : funcDecl->lineno;
+}
+
 // Gera código para declaração de função
 void genFunctionCode(ASTNode* funcDecl) {
     if (funcDecl == NULL || funcDecl->value == NULL) return;
-    currentSourceLine = funcDecl->lineno;  // Atualiza com a linha da declaração
+    currentSourceLine = functionSourceLine(funcDecl);
     DEBUG_IR("Gerando código para função %s na linha %d", funcDecl->value, currentSourceLine);
     
     // Marca o início da função
@@ -904,6 +928,7 @@ void processArguments(ASTNode* argNode, int* argCount) {
 void genCallCode(ASTNode* call, char* target) {
     if (call == NULL || call->left == NULL || call->left->value == NULL) return;
     
+    currentSourceLine = call->lineno;  // Chamadas soltas não passam por genExprCode
     DEBUG_IR("Gerando código para chamada de função '%s' (tipo nó: %s) na linha %d", 
              call->left->value, getNodeTypeName(call->type), call->lineno);
     DEBUG_IR("  Target da chamada: %s", target ? target : "void (usando tv)");
@@ -1186,16 +1211,17 @@ void optimizeIRCode(void) {
     int mappingCapacity = 0;
     int mappingCount = 0;
 
+    Quadruple* prev = NULL;  // quádrupla antes de current, para desligá-la sem percorrer a lista
     Quadruple* current = irCode.head;
     while (current) {
         // Quando encontra o início de uma função, reinicia o mapeamento
         if (current->op == OP_FUNCTION) {
             // Limpa o mapeamento anterior
             for (int i = 0; i < mappingCount; i++) {
-                free(tempMappings[i].original);
-                free(tempMappings[i].renamed);
+                memFree(tempMappings[i].original);
+                memFree(tempMappings[i].renamed);
             }
-            free(tempMappings);
+            memFree(tempMappings);
             tempMappings = NULL;
             mappingCapacity = 0;
             mappingCount = 0;
@@ -1212,8 +1238,8 @@ void optimizeIRCode(void) {
                     for (int i = 0; i < mappingCount; i++) {
                         if (strcmp(funcPtr->arg1, tempMappings[i].original) == 0) {
                             char* oldValue = funcPtr->arg1;
-                            funcPtr->arg1 = strdup(tempMappings[i].renamed);
-                            free(oldValue);
+                            funcPtr->arg1 = memStrdup(tempMappings[i].renamed);
+                            memFree(oldValue);
                             found = 1;
                             break;
                         }
@@ -1224,18 +1250,18 @@ void optimizeIRCode(void) {
                         // Verifica se precisamos realocar
                         if (mappingCount >= mappingCapacity) {
                             mappingCapacity = mappingCapacity == 0 ? 8 : mappingCapacity * 2;
-                            tempMappings = realloc(tempMappings, mappingCapacity * sizeof(TempMapping));
+                            tempMappings = memRealloc(tempMappings, mappingCapacity * sizeof(TempMapping));
                         }
                         
                         char newTemp[12];
                         sprintf(newTemp, "t%d", nextTempIndex++);
                         
-                        tempMappings[mappingCount].original = strdup(funcPtr->arg1);
-                        tempMappings[mappingCount].renamed = strdup(newTemp);
+                        tempMappings[mappingCount].original = memStrdup(funcPtr->arg1);
+                        tempMappings[mappingCount].renamed = memStrdup(newTemp);
                         
                         char* oldValue = funcPtr->arg1;
-                        funcPtr->arg1 = strdup(newTemp);
-                        free(oldValue);
+                        funcPtr->arg1 = memStrdup(newTemp);
+                        memFree(oldValue);
                         
                         mappingCount++;
                     }
@@ -1247,8 +1273,8 @@ void optimizeIRCode(void) {
                     for (int i = 0; i < mappingCount; i++) {
                         if (strcmp(funcPtr->arg2, tempMappings[i].original) == 0) {
                             char* oldValue = funcPtr->arg2;
-                            funcPtr->arg2 = strdup(tempMappings[i].renamed);
-                            free(oldValue);
+                            funcPtr->arg2 = memStrdup(tempMappings[i].renamed);
+                            memFree(oldValue);
                             found = 1;
                             break;
                         }
@@ -1257,18 +1283,18 @@ void optimizeIRCode(void) {
                     if (!found) {
                         if (mappingCount >= mappingCapacity) {
                             mappingCapacity = mappingCapacity == 0 ? 8 : mappingCapacity * 2;
-                            tempMappings = realloc(tempMappings, mappingCapacity * sizeof(TempMapping));
+                            tempMappings = memRealloc(tempMappings, mappingCapacity * sizeof(TempMapping));
                         }
                         
                         char newTemp[12];
                         sprintf(newTemp, "t%d", nextTempIndex++);
                         
-                        tempMappings[mappingCount].original = strdup(funcPtr->arg2);
-                        tempMappings[mappingCount].renamed = strdup(newTemp);
+                        tempMappings[mappingCount].original = memStrdup(funcPtr->arg2);
+                        tempMappings[mappingCount].renamed = memStrdup(newTemp);
                         
                         char* oldValue = funcPtr->arg2;
-                        funcPtr->arg2 = strdup(newTemp);
-                        free(oldValue);
+                        funcPtr->arg2 = memStrdup(newTemp);
+                        memFree(oldValue);
                         
                         mappingCount++;
                     }
@@ -1280,8 +1306,8 @@ void optimizeIRCode(void) {
                     for (int i = 0; i < mappingCount; i++) {
                         if (strcmp(funcPtr->result, tempMappings[i].original) == 0) {
                             char* oldValue = funcPtr->result;
-                            funcPtr->result = strdup(tempMappings[i].renamed);
-                            free(oldValue);
+                            funcPtr->result = memStrdup(tempMappings[i].renamed);
+                            memFree(oldValue);
                             found = 1;
                             break;
                         }
@@ -1290,18 +1316,18 @@ void optimizeIRCode(void) {
                     if (!found) {
                         if (mappingCount >= mappingCapacity) {
                             mappingCapacity = mappingCapacity == 0 ? 8 : mappingCapacity * 2;
-                            tempMappings = realloc(tempMappings, mappingCapacity * sizeof(TempMapping));
+                            tempMappings = memRealloc(tempMappings, mappingCapacity * sizeof(TempMapping));
                         }
                         
                         char newTemp[12];
                         sprintf(newTemp, "t%d", nextTempIndex++);
                         
-                        tempMappings[mappingCount].original = strdup(funcPtr->result);
-                        tempMappings[mappingCount].renamed = strdup(newTemp);
+                        tempMappings[mappingCount].original = memStrdup(funcPtr->result);
+                        tempMappings[mappingCount].renamed = memStrdup(newTemp);
                         
                         char* oldValue = funcPtr->result;
-                        funcPtr->result = strdup(newTemp);
-                        free(oldValue);
+                        funcPtr->result = memStrdup(newTemp);
+                        memFree(oldValue);
                         
                         mappingCount++;
                     }
@@ -1324,23 +1350,21 @@ void optimizeIRCode(void) {
                 strcmp(current->result, next->arg1) == 0) {
                 
                 // Substitui o argumento do PARAM pelo argumento do ASSIGN
-                free(next->arg1);
-                next->arg1 = strdup(current->arg1);
+                memFree(next->arg1);
+                next->arg1 = memStrdup(current->arg1);
                 
                 // Desconecta a quadrupla atual
-                if (current == irCode.head) {
+                if (prev == NULL) {
                     irCode.head = next;
                 } else {
-                    Quadruple* prev = irCode.head;
-                    while (prev->next != current) prev = prev->next;
                     prev->next = next;
                 }
                 
                 // Libera a quadrupla redundante
-                free(current->arg1);
-                if (current->arg2) free(current->arg2);
-                free(current->result);
-                free(current);
+                memFree(current->arg1);
+                if (current->arg2) memFree(current->arg2);
+                memFree(current->result);
+                memFree(current);
                 
                 current = next;
                 continue;
@@ -1349,22 +1373,166 @@ void optimizeIRCode(void) {
             
         }
         
+        prev = current;
         current = current->next;
     }
     
     // Libera memória do último mapeamento, se houver
     for (int i = 0; i < mappingCount; i++) {
-        free(tempMappings[i].original);
-        free(tempMappings[i].renamed);
+        memFree(tempMappings[i].original);
+        memFree(tempMappings[i].renamed);
     }
-    free(tempMappings);
+    memFree(tempMappings);
 }
 
-// Função de entrada para gerar o código intermediário
-void ircode_generate(ASTNode* syntaxTree) {
+// Gera uma declaração de nível do programa com os contadores zerados, sem mexer
+// no que já foi ligado: irCode guarda a declaração enquanto ela é gerada.
+IRCode generateDeclIR(ASTNode* decl, int otimizar) {
+    IRCode programa = irCode;
     initIRCode();
-    generateIRCode(syntaxTree);
+    phaseBegin("geracao do codigo intermediario");
+    generateIRCode(decl);
+    phaseEnd();
+    if (otimizar) {
+        phaseBegin("otimizacao do codigo intermediario");
+        optimizeIRCode();
+        phaseEnd();
+    }
+    IRCode unit = irCode;
+    irCode = programa;
+    return unit;
+}
+
+// Soma base ao número de um nome gerado (prefixo seguido só de dígitos)
+static void renumberName(char** name, const char* prefix, int base) {
+    size_t length = strlen(prefix);
+    if (base == 0 || *name == NULL || strncmp(*name, prefix, length) != 0 || (*name)[length] == '\0') return;
+    for (const char* p = *name + length; *p; p++) {
+        if (!isdigit((unsigned char)*p)) return;
+    }
+    char renamed[16];
+    snprintf(renamed, sizeof(renamed), "%s%d", prefix, atoi(*name + length) + base);
+    memFree(*name);
+    *name = memStrdup(renamed);
+}
+
+void linkIRCode(IRCode* unit, int renomearTemporarios) {
+    int tempBase = renomearTemporarios ? irCode.temp_count : 0;
+    for (Quadruple* q = unit->head; q != NULL; q = q->next) {
+        char** args[3] = {&q->arg1, &q->arg2, &q->result};
+        for (int i = 0; i < 3; i++) {
+            renumberName(args[i], "L", irCode.label_count);
+            renumberName(args[i], "tv", irCode.void_temp_count);
+            renumberName(args[i], "t", tempBase);
+        }
+        q->line += irCode.quad_count;
+    }
+    if (unit->head != NULL) {
+        if (irCode.head == NULL) irCode.head = unit->head;
+        else irCode.tail->next = unit->head;
+        irCode.tail = unit->tail;
+    }
+    irCode.temp_count += unit->temp_count;
+    irCode.label_count += unit->label_count;
+    irCode.void_temp_count += unit->void_temp_count;
+    irCode.quad_count += unit->quad_count;
+    unit->head = unit->tail = NULL;
+}
+
+int needsProgramIRPasses(void) {
+    return instrumentarBlocos || inlineOptions.enabled || profileLoaded();
+}
+
+// Sobre o programa já ligado, na ordem de sempre: os blocos do perfil e os contadores
+// são os do código antes do inline, e a disposição pelo perfil vem depois da renomeação
+void optimizeProgramIR(void) {
+    checkProfileMatches();
+    if (instrumentarBlocos) {
+        phaseBegin("instrumentacao");
+        if (instrumentIRCode() != 0) {
+            instrumentarBlocos = 0;  // sem contadores; o programa segue compilado sem eles
+        }
+        phaseEnd();
+    }
+    if (inlineOptions.enabled) {
+        phaseBegin("inline");
+        inlineIRCode();  // expande chamadas a funções pequenas antes de renomear os temporários
+        phaseEnd();
+    }
+    phaseBegin("otimizacao do codigo intermediario");
     optimizeIRCode();  //  otimização do código intermediário
-    printIRCode(stdout);
+    phaseEnd();
+    if (profileLoaded()) {
+        phaseBegin("disposicao pelo perfil");
+        layoutIRCode();  // só muda a ordem dos blocos
+        phaseEnd();
+    }
+}
+
+void writeIRListings(void) {
+    phaseBegin("impressao do codigo intermediario");
+    // O backend recebe a lista de quádruplas; a listagem só é gravada se pedida
+    char path[OUTPUT_PATH_SIZE];
+    if (artifactPath(ART_IR, path, sizeof(path))) {
+        FILE* outfile = fopen(path, "w");
+        if (outfile == NULL) {
+            printError("Erro ao gravar %s.", path);
+        } else {
+            printIRCode(outfile);
+            fclose(outfile);
+            printInfo("Código intermediário (quádruplas) salvo em '%s'", path);
+        }
+    }
     printThreeAddressCode(stdout);  // Adiciona impressão do código de 3 endereços
-}
\ No newline at end of file
+    phaseEnd();
+}
+
+// Uma linha "Q op arg1 arg2 resultado quádrupla linha" separada por tab; "-" marca
+// argumento ausente (nunca é um nome) e linha do fonte 0
+void writeIRUnit(FILE* file, const IRCode* unit, int linhaBase) {
+    fprintf(file, "IR %d %d %d %d\n", unit->temp_count, unit->label_count, unit->void_temp_count, unit->quad_count);
+    for (const Quadruple* q = unit->head; q != NULL; q = q->next) {
+        fprintf(file, "Q\t%d\t%s\t%s\t%s\t%d\t", (int)q->op, q->arg1 ? q->arg1 : "-", q->arg2 ? q->arg2 : "-",
+                q->result ? q->result : "-", q->line);
+        if (q->sourceLine != 0) {
+            fprintf(file, "%d\n", q->sourceLine - linhaBase);
+        } else {
+            fprintf(file, "-\n");
+        }
+    }
+}
+
+int readIRUnit(FILE* file, IRCode* unit, int count, int linhaBase) {
+    char line[512];  // os nomes têm no máximo 49 caracteres (QuadrupleInfo)
+    unit->head = unit->tail = NULL;
+    if (fscanf(file, "IR %d %d %d %d\n", &unit->temp_count, &unit->label_count, &unit->void_temp_count,
+               &unit->quad_count) != 4) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        char* fields[7];
+        int fieldCount = 0;
+        if (fgets(line, sizeof(line), file) == NULL || line[0] != 'Q') {
+            return -1;
+        }
+        line[strcspn(line, "\n")] = '\0';
+        for (char* p = strtok(line, "\t"); p != NULL && fieldCount < 7; p = strtok(NULL, "\t")) {
+            fields[fieldCount++] = p;
+        }
+        if (fieldCount != 7) {
+            return -1;
+        }
+        Quadruple* quad = (Quadruple*)memAlloc(sizeof(Quadruple));
+        quad->op = (OperationType)atoi(fields[1]);
+        quad->arg1 = strcmp(fields[2], "-") != 0 ? memStrdup(fields[2]) : NULL;
+        quad->arg2 = strcmp(fields[3], "-") != 0 ? memStrdup(fields[3]) : NULL;
+        quad->result = strcmp(fields[4], "-") != 0 ? memStrdup(fields[4]) : NULL;
+        quad->line = atoi(fields[5]);
+        quad->sourceLine = strcmp(fields[6], "-") != 0 ? linhaBase + atoi(fields[6]) : 0;
+        quad->next = NULL;
+        if (unit->head == NULL) unit->head = quad;
+        else unit->tail->next = quad;
+        unit->tail = quad;
+    }
+    return 0;
+}
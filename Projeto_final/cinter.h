@@ -30,7 +30,8 @@ typedef enum {
     OP_ARGUMENT,    // Argumento para chamada função 
     OP_ALLOC,       // Aloca memória para variáveis
     OP_FUNCTION,    // Definição de função
-    OP_END          // Fim de função
+    OP_END,         // Fim de função
+    OP_COUNT        // Soma 1 ao contador de um bloco (--instrument; arg1 = endereço)
 } OperationType;
 
 // Estrutura para representar uma quadrupla
@@ -50,15 +51,19 @@ typedef struct {
     Quadruple* tail;
     int temp_count;
     int label_count;
+    int void_temp_count;  // temporários tvN das chamadas void
+    int quad_count;       // quádruplas geradas (número da última)
 } IRCode;
 
 // Funções para gerenciamento do código intermediário
 void initIRCode(void);
+IRCode* getIRCode(void);
 void freeIRCode(void);
+void freeIRUnit(IRCode* unit);
 char* newTemp(void);
 char* newLabel(void);
 void genQuad(OperationType op, char* arg1, char* arg2, char* result);
-void printIRCode(FILE* listing);
+void printIRCode(FILE* outfile);
 
 // Funções para geração de código específico
 void genExprCode(ASTNode* expr, char* target);
@@ -67,14 +72,42 @@ void genIfCode(ASTNode* ifStmt);
 void genWhileCode(ASTNode* whileStmt);
 void genReturnCode(ASTNode* returnStmt);
 void genFunctionCode(ASTNode* funcDecl);
+int functionSourceLine(const ASTNode* funcDecl);  // linha do cabeçalho (a da quádrupla FUNCTION)
 void genCallCode(ASTNode* call, char* target);
 void genArrayAccessCode(ASTNode* arrayAccess, char* target);
 void genArrayAssignCode(ASTNode* arrayAssign);
 
 // Função principal para geração de código
-void ircode_generate(ASTNode* syntaxTree);
 void generateIRCode(ASTNode* syntaxTree);
+
+// Código de uma declaração do programa (função ou variável global), com rótulos,
+// temporários e quádruplas numerados a partir de zero. Com otimizar, a função já sai
+// com os temporários renomeados (optimizeIRCode só olha dentro de cada função).
+IRCode generateDeclIR(ASTNode* decl, int otimizar);
+
+// Acrescenta ao programa uma declaração gerada por generateDeclIR, somando aos nomes
+// dela os contadores do que já foi ligado; a lista fica igual à de gerar o programa
+// inteiro de uma vez. renomearTemporarios: a declaração ainda não foi otimizada.
+void linkIRCode(IRCode* unit, int renomearTemporarios);
+
+// Passagens que enxergam o programa inteiro: --instrument, --profile e --inline
+int needsProgramIRPasses(void);
+void optimizeProgramIR(void);
+void optimizeIRCode(void);
+
+// Grava quadruples.txt e three_address_code.txt, se pedidos
+void writeIRListings(void);
+
+// Quádruplas de uma declaração em texto, uma por linha, para passá-las entre processos
+// (-j) ou guardá-las (--cache). Linhas do fonte relativas a linhaBase.
+void writeIRUnit(FILE* file, const IRCode* unit, int linhaBase);
+// Lê count quádruplas gravadas por writeIRUnit; -1 se o texto está incompleto (o
+// que já foi lido fica em unit, para freeIRUnit)
+int readIRUnit(FILE* file, IRCode* unit, int count, int linhaBase);
 const char* getOpName(OperationType op);
 const char* getNodeTypeName(NodeType type);
 
+// Funções de entrada dos dispatchers: não recebem frame e devem permanecer fora de linha
+int isDispatcherEntry(const char* name);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,565 @@
+#include "codigo_maquina.h"
+
+static const InstructionInfo instructionTable[] = {
+    {"add", TYPE_R, 0, 2, FMT_RRR},     // 000000 ... 0010
+    {"sub", TYPE_R, 0, 3, FMT_RRR},     // 000000 ... 0011
+    {"mul", TYPE_R, 0, 4, FMT_RRR},     // 000000 ... 0100
+    {"div", TYPE_R, 0, 5, FMT_RRR},     // 000000 ... 0101
+    {"and", TYPE_R, 0, 0, FMT_RRR},     // 000000 ... 0000
+    {"or", TYPE_R, 0, 1, FMT_RRR},      // 000000 ... 0001
+    {"nor", TYPE_R, 0, 8, FMT_RRR},     // 000000 ... 1000
+    {"sr", TYPE_R, 1, 6, FMT_RRR},      // 000001 ... 0110
+    {"sl", TYPE_R, 1, 7, FMT_RRR},      // 000001 ... 0111
+    {"jr", TYPE_R, 2, 9, FMT_JR},       // 000010 ... 1001
+    
+    {"andi", TYPE_I, 3, 0, FMT_RRI},    // 000011 ...
+    {"ori", TYPE_I, 4, 0, FMT_RRI},     // 000100 ...
+    {"addi", TYPE_I, 5, 0, FMT_RRI},    // 000101 ...
+    {"subi", TYPE_I, 6, 0, FMT_RRI},    // 000110 ...
+    {"li", TYPE_I, 7, 0, FMT_LI},       // 000111 ...
+    {"lw", TYPE_I, 8, 0, FMT_MEM},      // 001000 ... (lw1)
+    {"lw2", TYPE_I, 9, 0, FMT_MEM},     // 001001 ... (lw2)
+    {"lw3", TYPE_I, 10, 0, FMT_MEM},    // 001010 ... (lw3) - endereçamentos
+    {"sw", TYPE_I, 11, 0, FMT_MEM},     // 001011 ...
+    {"beq", TYPE_I, 12, 0, FMT_BRANCH}, // 001100 ...
+    {"blt", TYPE_I, 13, 0, FMT_BRANCH}, // 001101 ...
+    {"bgt", TYPE_I, 14, 0, FMT_BRANCH}, // 001110 ...
+    {"bnq", TYPE_I, 15, 0, FMT_BRANCH}, // 001111 ... 
+    {"bge", TYPE_I, 23, 0, FMT_BRANCH}, // 010000 ... 
+    {"ble", TYPE_I, 24, 0, FMT_BRANCH}, // 010001 ... 
+    {"in", TYPE_I, 16, 0, FMT_IN},      // 010000 ...
+    {"out", TYPE_I, 17, 0, FMT_OUT},    // 010001 ...
+    {"move", TYPE_I, 18, 0, FMT_MOVE},  // 010010 ...
+    
+    
+    {"j", TYPE_J, 19, 0, FMT_JUMP},     // 010011 ...
+    {"jal", TYPE_J, 20, 0, FMT_JUMP},   // 010100 ...
+    {"nop", TYPE_J, 22, 0, FMT_NOP},    // 010110 ...
+    
+    {"halt", TYPE_MK, 21, 0, FMT_HALT},     // 010101 desligar SO
+    {"msgLcd", TYPE_MK, 26, 0, FMT_REG},    // opcode 011010
+    {"saltoUser", TYPE_MK, 27, 0, FMT_REG}, // opcode 011011
+    {"syscall", TYPE_MU, 28, 9, FMT_SYSCALL}, // opcode 011100
+    {"addil", TYPE_I, 25, 0, FMT_ADDIL},    // opcode 011001
+
+    // desvios relativos ao PC: o imediato guarda (destino - endereço do desvio)
+    {"beqr", TYPE_I, 29, 0, FMT_BRANCH_REL}, // 011101 ...
+    {"bnqr", TYPE_I, 33, 0, FMT_BRANCH_REL}, // 100001 ...
+    {"bltr", TYPE_I, 34, 0, FMT_BRANCH_REL}, // 100010 ...
+    {"bgtr", TYPE_I, 35, 0, FMT_BRANCH_REL}, // 100011 ...
+    {"bger", TYPE_I, 36, 0, FMT_BRANCH_REL}, // 100100 ...
+    {"bler", TYPE_I, 37, 0, FMT_BRANCH_REL}, // 100101 ...
+
+    // {"fbw", TYPE_COMM, 30, 0}, // opcode 011110
+    // {"rfbw", TYPE_COMM, 31, 0}, // opcode 011111
+    // {"voteHdw", TYPE_R, 32, 3}, // opcode 100000 
+    
+    {"", TYPE_INVALID, 0, 0, FMT_RRR}
+};
+
+// Índice hash dos mnemônicos (endereçamento aberto), montado uma única vez
+static const InstructionInfo* mnemonicIndex[MNEMONIC_HASH_SIZE];
+static int mnemonicIndexReady = 0;
+
+// Hash do mnemônico sem diferenciar maiúsculas (o montador aceita "msglcd" e "msgLcd")
+static unsigned int hashMnemonic(const char* mnemonic) {
+    unsigned int hash = 0;
+    for (const unsigned char* p = (const unsigned char*)mnemonic; *p; p++) {
+        hash = hash * 31 + tolower(*p);
+    }
+    return hash & (MNEMONIC_HASH_SIZE - 1);
+}
+
+static void buildMnemonicIndex(void) {
+    for (int i = 0; instructionTable[i].type != TYPE_INVALID; i++) {
+        unsigned int slot = hashMnemonic(instructionTable[i].mnemonic);
+        while (mnemonicIndex[slot] != NULL) {
+            slot = (slot + 1) & (MNEMONIC_HASH_SIZE - 1);
+        }
+        mnemonicIndex[slot] = &instructionTable[i];
+    }
+    mnemonicIndexReady = 1;
+}
+
+// Opcode, funct e formato dos operandos em uma única consulta
+const InstructionInfo* findInstruction(const char* mnemonic) {
+    if (!mnemonicIndexReady) {
+        buildMnemonicIndex();
+    }
+    unsigned int slot = hashMnemonic(mnemonic);
+    while (mnemonicIndex[slot] != NULL) {
+        if (strcasecmp(mnemonicIndex[slot]->mnemonic, mnemonic) == 0) {
+            return mnemonicIndex[slot];
+        }
+        slot = (slot + 1) & (MNEMONIC_HASH_SIZE - 1);
+    }
+    return NULL; 
+}
+
+// Instrução de uma palavra já montada; no formato R (opcodes 0 e 1) o funct desempata
+const InstructionInfo* findInstructionByOpcode(unsigned int opcode, unsigned int funct) {
+    for (int i = 0; instructionTable[i].type != TYPE_INVALID; i++) {
+        const InstructionInfo* info = &instructionTable[i];
+        if (info->opcode == opcode && (info->type != TYPE_R || info->funct == funct)) {
+            return info;
+        }
+    }
+    return NULL;
+}
+
+// Percorre a tabela de instruções; NULL depois da última
+const InstructionInfo* instructionAt(int index) {
+    if (index < 0 || instructionTable[index].type == TYPE_INVALID) {
+        return NULL;
+    }
+    return &instructionTable[index];
+}
+
+int instructionIndex(const InstructionInfo* info) {
+    return (int)(info - instructionTable);
+}
+
+// Custo estimado (ciclos) de cada instrução no processador; mul e div são multiciclo.
+// A seleção de instruções compara sequências por ele e o simulador parte dele.
+static const InstructionCost instructionCosts[] = {
+    {"mul", 4},
+    {"div", 8},
+    {"sl", 1},
+    {"sr", 1},
+    {"add", 1},
+    {"sub", 1},
+    {"li", 1},
+    {"move", 1},
+    {NULL, 1}
+};
+
+// Ciclos da instrução; 1 para as que não estão na tabela
+int instructionCost(const char* mnemonic) {
+    int i = 0;
+    while (instructionCosts[i].mnemonic != NULL && strcmp(instructionCosts[i].mnemonic, mnemonic) != 0) {
+        i++;
+    }
+    return instructionCosts[i].cycles;
+}
+
+int extractRegister(const char* regStr) {
+    if (regStr != NULL && regStr[0] == '$' && regStr[1] == 'r') {
+        return atoi(regStr + 2); 
+    }
+    return -1; 
+}
+
+// Quantos dos operandos de cada formato são registradores (sempre os primeiros)
+int formatRegisterCount(OperandFormat format) {
+    switch (format) {
+        case FMT_RRR:
+            return 3;
+        case FMT_RRI:
+        case FMT_MEM:
+        case FMT_BRANCH:
+        case FMT_BRANCH_REL:
+        case FMT_MOVE:
+        case FMT_ADDIL:
+            return 2;
+        case FMT_JR:
+        case FMT_LI:
+        case FMT_IN:
+        case FMT_OUT:
+        case FMT_REG:
+        case FMT_SYSCALL:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+// Instruções cujo primeiro registrador é o destino
+int writesFirstRegister(const InstructionInfo* info) {
+    switch (info->format) {
+        case FMT_RRR:
+        case FMT_RRI:
+        case FMT_LI:
+        case FMT_MOVE:
+        case FMT_ADDIL:
+        case FMT_IN:
+            return 1;
+        case FMT_MEM:
+            return strcmp(info->mnemonic, "sw") != 0;
+        default:
+            return 0;
+    }
+}
+
+/* ---------- sequência de instruções ---------- */
+
+void initMachineCode(MachineCode* code, int keepComments) {
+    code->items = NULL;
+    code->count = 0;
+    code->capacity = 0;
+    code->keepComments = keepComments;
+    code->sourceLine = 0;
+}
+
+void freeMachineInstr(MachineInstr* instr) {
+    free(instr->label);
+    free(instr->symbol);
+    free(instr->comment);
+    instr->label = NULL;
+    instr->symbol = NULL;
+    instr->comment = NULL;
+}
+
+void freeMachineCode(MachineCode* code) {
+    for (int i = 0; i < code->count; i++) {
+        freeMachineInstr(&code->items[i]);
+    }
+    free(code->items);
+    code->items = NULL;
+    code->count = 0;
+    code->capacity = 0;
+}
+
+// Acrescenta uma entrada zerada; info NULL cria um rótulo ou comentário
+MachineInstr* appendMachineInstr(MachineCode* code, const InstructionInfo* info) {
+    if (code->count == code->capacity) {
+        code->capacity = code->capacity ? code->capacity * 2 : 256;
+        code->items = realloc(code->items, code->capacity * sizeof(MachineInstr));
+    }
+    MachineInstr* instr = &code->items[code->count++];
+    memset(instr, 0, sizeof(MachineInstr));
+    instr->info = info;
+    instr->sourceLine = code->sourceLine;
+    return instr;
+}
+
+// Destino de li/addil/desvios/saltos: endereço numérico ou rótulo a relocar
+void setInstrTarget(MachineInstr* instr, const char* target) {
+    free(instr->symbol);
+    instr->symbol = NULL;
+    instr->imm = 0;
+    if (isdigit((unsigned char)target[0]) || (target[0] == '-' && isdigit((unsigned char)target[1]))) {
+        instr->imm = atoi(target);
+    } else {
+        instr->symbol = strdup(target);
+    }
+}
+
+void setInstrComment(MachineCode* code, MachineInstr* instr, const char* format, va_list args) {
+    if (!code->keepComments || format == NULL) {
+        return;
+    }
+    char text[256];
+    vsnprintf(text, sizeof(text), format, args);
+    free(instr->comment);
+    instr->comment = strdup(text);
+}
+
+/* ---------- visão textual ---------- */
+
+static int formatRegister(char* text, size_t size, int reg) {
+    return reg >= 0 ? snprintf(text, size, " $r%d", reg) : snprintf(text, size, " ?");
+}
+
+static int formatTarget(char* text, size_t size, const MachineInstr* instr) {
+    return instr->symbol ? snprintf(text, size, " %s", instr->symbol) : snprintf(text, size, " %d", instr->imm);
+}
+
+// Texto da instrução (sem índice e sem comentário), como no assembly.asm
+int formatMachineInstr(const MachineInstr* instr, char* text, size_t size) {
+    const InstructionInfo* info = instr->info;
+    int len = snprintf(text, size, "%s", info->mnemonic);
+
+    switch (info->format) {
+        case FMT_MEM:
+            len += formatRegister(text + len, size - len, instr->regs[0]);
+            len += snprintf(text + len, size - len, " %d($r%d)", instr->imm, instr->regs[1]);
+            return len;
+        case FMT_NOP:
+            return len + snprintf(text + len, size - len, " %d", instr->imm);
+        default:
+            break;
+    }
+    for (int i = 0; i < formatRegisterCount(info->format); i++) {
+        len += formatRegister(text + len, size - len, instr->regs[i]);
+    }
+    switch (info->format) {
+        case FMT_RRI:
+            len += snprintf(text + len, size - len, " %d", instr->imm);
+            break;
+        case FMT_LI:
+        case FMT_BRANCH:
+        case FMT_BRANCH_REL:
+        case FMT_ADDIL:
+        case FMT_JUMP:
+            len += formatTarget(text + len, size - len, instr);
+            break;
+        default:
+            break;
+    }
+    return len;
+}
+
+/* ---------- entradas em texto ---------- */
+
+// Uma entrada por linha, campos separados por tab:
+//   tipo(I/L/F/C) rótulo mnemônico r0 r1 r2 imediato símbolo linha comentário
+// "-" marca campo vazio; o comentário vem prefixado por '#'.
+void writeMachineCodeRange(FILE* file, const MachineCode* code, int start, int end, int linhaBase) {
+    for (int i = start; i < end; i++) {
+        const MachineInstr* instr = &code->items[i];
+        char kind = instr->info != NULL ? 'I' : instr->label == NULL ? 'C' : instr->isFunction ? 'F' : 'L';
+        fprintf(file, "%c\t%s\t%s\t%d\t%d\t%d\t%d\t%s\t", kind, instr->label != NULL ? instr->label : "-",
+                instr->info != NULL ? instr->info->mnemonic : "-", instr->regs[0], instr->regs[1], instr->regs[2],
+                instr->imm, instr->symbol != NULL ? instr->symbol : "-");
+        if (instr->sourceLine != 0) {
+            fprintf(file, "%d\t", instr->sourceLine - linhaBase);
+        } else {
+            fprintf(file, "-\t");
+        }
+        fprintf(file, "%s%s\n", instr->comment != NULL ? "#" : "-", instr->comment != NULL ? instr->comment : "");
+    }
+}
+
+// Separa uma linha em campos separados por tab, no lugar
+static int splitFields(char* line, char** fields, int max) {
+    int count = 0;
+    fields[count++] = line;
+    for (char* p = line; *p && count < max; p++) {
+        if (*p == '\t') {
+            *p = '\0';
+            fields[count++] = p + 1;
+        }
+    }
+    fields[count - 1][strcspn(fields[count - 1], "\n")] = '\0';
+    return count;
+}
+
+int readMachineCodeRange(FILE* file, MachineCode* code, int count, int linhaBase) {
+    char line[MAX_ASM_TEXT * 3];
+    for (int i = 0; i < count; i++) {
+        char* fields[10];
+        if (fgets(line, sizeof(line), file) == NULL || splitFields(line, fields, 10) != 10) {
+            return -1;
+        }
+        const InstructionInfo* info = NULL;
+        if (fields[0][0] == 'I' && (info = findInstruction(fields[2])) == NULL) {
+            return -1;
+        }
+        MachineInstr* instr = appendMachineInstr(code, info);
+        instr->isFunction = fields[0][0] == 'F';
+        instr->regs[0] = atoi(fields[3]);
+        instr->regs[1] = atoi(fields[4]);
+        instr->regs[2] = atoi(fields[5]);
+        instr->imm = atoi(fields[6]);
+        instr->sourceLine = strcmp(fields[8], "-") != 0 ? linhaBase + atoi(fields[8]) : 0;
+        if (strcmp(fields[1], "-") != 0) {
+            instr->label = strdup(fields[1]);
+        }
+        if (strcmp(fields[7], "-") != 0) {
+            instr->symbol = strdup(fields[7]);
+        }
+        if (fields[9][0] == '#' && code->keepComments) {
+            instr->comment = strdup(fields[9] + 1);
+        }
+    }
+    return 0;
+}
+
+// Escreve o programa no formato "N - [rótulo:] [instrução] [# comentário]"
+void writeAssemblyText(const MachineCode* code, FILE* output) {
+    char text[MAX_ASM_TEXT];
+    for (int i = 0; i < code->count; i++) {
+        const MachineInstr* instr = &code->items[i];
+        if (instr->label != NULL) {
+            snprintf(text, sizeof(text), "%s:", instr->label);
+        } else if (instr->info != NULL) {
+            formatMachineInstr(instr, text, sizeof(text));
+        } else {
+            text[0] = '\0';
+        }
+        if (instr->comment != NULL) {
+            fprintf(output, "%d - %s%s# %s\n", i, text, text[0] ? " " : "", instr->comment);
+        } else {
+            fprintf(output, "%d - %s\n", i, text);
+        }
+    }
+}
+
+/* ---------- leitura do assembly em texto ---------- */
+
+static char* trimRight(char* text) {
+    int len = strlen(text);
+    while (len > 0 && isspace((unsigned char)text[len-1])) text[--len] = '\0';
+    return text;
+}
+
+static char* skipSpaces(char* text) {
+    while (*text && isspace((unsigned char)*text)) text++;
+    return text;
+}
+
+// Separa uma linha "N - [rótulo:] [instrução] [# comentário]" em rótulo, instrução e
+// comentário, sem o índice. Trabalha sobre a própria linha (sem cópias): os ponteiros
+// devolvidos apontam para dentro dela e ficam NULL quando ausentes.
+void splitAssemblyLine(char* line, char** label, char** instr, char** comment) {
+    char* current = line;
+    *label = NULL;
+    *instr = NULL;
+    *comment = NULL;
+
+    // Remove o índice no formato "0 - " do início da linha
+    char* dash_pos = strstr(line, " - ");
+    if (dash_pos != NULL) {
+        int is_index = 1;
+        for (char* p = line; p < dash_pos; p++) {
+            if (!isdigit((unsigned char)*p) && !isspace((unsigned char)*p)) {
+                is_index = 0;
+                break;
+            }
+        }
+        if (is_index) {
+            current = dash_pos + 3;
+        }
+    }
+
+    // Separa o comentário
+    char* comment_pos = strchr(current, '#');
+    if (comment_pos != NULL) {
+        *comment_pos = '\0';
+        char* text = trimRight(skipSpaces(comment_pos + 1));
+        if (*text) *comment = text;
+    }
+
+    // Rótulo terminado por ':'
+    char* colon_pos = strchr(current, ':');
+    if (colon_pos != NULL) {
+        *colon_pos = '\0';
+        current = trimRight(skipSpaces(current));
+        if (*current) *label = current;
+        current = colon_pos + 1;
+    }
+
+    current = trimRight(skipSpaces(current));
+    if (*current) *instr = current;
+}
+
+// Separa "offset($rs)" em deslocamento e registrador base
+static void splitMemOperand(const char* operand, int* offset, int* base) {
+    char offsetStr[32] = {0};
+    char baseRegStr[32] = {0};
+    int i = 0;
+
+    if (operand == NULL) {
+        *offset = 0;
+        *base = -1;
+        return;
+    }
+    while (operand[i] && operand[i] != '(' && i < 31) {
+        offsetStr[i] = operand[i];
+        i++;
+    }
+    if (operand[i] == '(') {
+        int j = 0;
+        i++; // Skip '('
+        while (operand[i] && operand[i] != ')' && j < 31) {
+            baseRegStr[j++] = operand[i++];
+        }
+    }
+    *offset = atoi(offsetStr);
+    *base = extractRegister(baseRegStr);
+}
+
+// Decodifica "mnemônico op1 op2 op3" nos campos da instrução; -1 se faltar o destino
+static int parseInstruction(char* text, MachineInstr* instr) {
+    char* ops[3];
+    strtok(text, " \t\r");
+    for (int i = 0; i < 3; i++) {
+        ops[i] = strtok(NULL, " ,\t\r");
+    }
+
+    switch (instr->info->format) {
+        case FMT_MEM:
+            instr->regs[0] = extractRegister(ops[0]);
+            splitMemOperand(ops[1], &instr->imm, &instr->regs[1]);
+            return 0;
+        case FMT_NOP:
+            instr->imm = ops[0] ? atoi(ops[0]) : 0;
+            return 0;
+        default:
+            break;
+    }
+
+    int regCount = formatRegisterCount(instr->info->format);
+    for (int i = 0; i < regCount; i++) {
+        instr->regs[i] = extractRegister(ops[i]);
+    }
+    switch (instr->info->format) {
+        case FMT_RRI:
+            instr->imm = ops[2] ? atoi(ops[2]) : 0;
+            break;
+        case FMT_LI:
+        case FMT_BRANCH:
+        case FMT_BRANCH_REL:
+        case FMT_ADDIL:
+        case FMT_JUMP:
+            if (ops[regCount] == NULL) {
+                return -1;
+            }
+            setInstrTarget(instr, ops[regCount]);
+            break;
+        default:
+            break;
+    }
+    return 0;
+}
+
+// Lê um assembly textual (buffer terminado em '\0', alterado no lugar) para a
+// sequência de instruções. Devolve o número de erros encontrados.
+int parseAssemblyText(char* buffer, MachineCode* code) {
+    int errors = 0;
+    char* line = buffer;
+
+    while (*line) {
+        char* end = strchr(line, '\n');
+        char* label;
+        char* text;
+        char* comment;
+        if (end != NULL) {
+            *end = '\0';
+        }
+        splitAssemblyLine(line, &label, &text, &comment);
+
+        MachineInstr* last = NULL;
+        if (label != NULL) {
+            last = appendMachineInstr(code, NULL);
+            last->label = strdup(label);
+        }
+        if (text != NULL) {
+            char mnemonic[32];
+            snprintf(mnemonic, sizeof(mnemonic), "%.*s", (int)strcspn(text, " \t\r"), text);
+            const InstructionInfo* info = findInstruction(mnemonic);
+            if (info == NULL) {
+                printError("Erro: instrução desconhecida '%s'.", mnemonic);
+                errors++;
+            } else {
+                last = appendMachineInstr(code, info);
+                if (parseInstruction(text, last) != 0) {
+                    printError("Erro: '%s' sem o operando de destino.", mnemonic);
+                    errors++;
+                }
+            }
+        }
+        if (comment != NULL && code->keepComments) {
+            if (last == NULL) {
+                last = appendMachineInstr(code, NULL);
+            }
+            last->comment = strdup(comment);
+        }
+
+        if (end == NULL) {
+            break;
+        }
+        line = end + 1;
+    }
+    return errors;
+}
@@ -0,0 +1,109 @@
+#ifndef CODIGO_MAQUINA_H
+#define CODIGO_MAQUINA_H
+
+#include "globals.h"
+
+#define MNEMONIC_HASH_SIZE 128 // potência de 2, bem maior que o número de instruções
+#define MAX_ASM_TEXT 1024      // tamanho máximo de uma linha do assembly textual
+
+// "@imagem" referencia o endereço de carga de outra imagem (ex.: um dispatcher);
+// vira relocação no objeto (-c) ou usa o layout padrão na montagem direta
+#define EXTERNAL_SYMBOL_PREFIX '@'
+
+//tipos das instruções
+typedef enum {
+    TYPE_R,
+    TYPE_I,
+    TYPE_J,
+    TYPE_MK, //KERNEL
+    TYPE_MU, //USER
+    TYPE_COMM,
+    TYPE_INVALID
+} InstructionType;
+
+//formato dos operandos, escolhe como a instrução é codificada
+typedef enum {
+    FMT_RRR,        // add $rd $rs $rt
+    FMT_JR,         // jr $rt
+    FMT_RRI,        // addi $rt $rs imediato
+    FMT_LI,         // li $rt imediato|rótulo
+    FMT_MEM,        // lw/sw $rt offset($rs)
+    FMT_BRANCH,     // beq $rs $rt rótulo (endereço absoluto)
+    FMT_BRANCH_REL, // beqr $rs $rt rótulo (deslocamento relativo ao PC)
+    FMT_IN,         // in $rt
+    FMT_OUT,        // out $rs
+    FMT_MOVE,       // move $rt $rs
+    FMT_ADDIL,      // addil $rt $rs rótulo
+    FMT_JUMP,       // j/jal rótulo
+    FMT_NOP,        // nop imediato
+    FMT_HALT,       // halt
+    FMT_REG,        // msgLcd/saltoUser $rs
+    FMT_SYSCALL     // syscall $rt
+} OperandFormat;
+
+//detalhes das instruções
+typedef struct {
+    char mnemonic[10];
+    InstructionType type;
+    unsigned int opcode;
+    unsigned int funct;
+    OperandFormat format;
+} InstructionInfo;
+
+// Custo de uma instrução, usado pela seleção de instruções e pelo simulador
+typedef struct {
+    const char* mnemonic;
+    int cycles;
+} InstructionCost;
+
+// Instrução já decodificada, como o backend a emite. Os campos seguem a ordem dos
+// operandos no texto do assembly; o formato da instrução diz o papel de cada um.
+typedef struct {
+    char* label;                 // rótulo definido nesta posição (entrada sem instrução)
+    const InstructionInfo* info; // NULL em rótulos e comentários
+    int regs[3];                 // registradores, na ordem em que aparecem no texto
+    int imm;                     // imediato, deslocamento do lw/sw ou destino numérico
+    char* symbol;                // rótulo referenciado (relocação); NULL se o destino é numérico
+    char* comment;               // comentário da visão textual (NULL se não houver)
+    int isFunction;              // o rótulo inicia uma função
+    int sourceLine;              // linha do programa C- que gerou a instrução (0 = nenhuma)
+} MachineInstr;
+
+// Sequência de instruções de um programa
+typedef struct {
+    MachineInstr* items;
+    int count;
+    int capacity;
+    int keepComments;            // comentários só são guardados quando o assembly textual foi pedido
+    int sourceLine;              // linha dada às próximas entradas acrescentadas
+} MachineCode;
+
+const InstructionInfo* findInstruction(const char* mnemonic);
+const InstructionInfo* findInstructionByOpcode(unsigned int opcode, unsigned int funct);
+const InstructionInfo* instructionAt(int index);
+int instructionIndex(const InstructionInfo* info);
+int instructionCost(const char* mnemonic);
+int extractRegister(const char* regStr);
+int formatRegisterCount(OperandFormat format);
+int writesFirstRegister(const InstructionInfo* info);
+
+void initMachineCode(MachineCode* code, int keepComments);
+void freeMachineCode(MachineCode* code);
+MachineInstr* appendMachineInstr(MachineCode* code, const InstructionInfo* info);
+void freeMachineInstr(MachineInstr* instr);
+void setInstrTarget(MachineInstr* instr, const char* target);
+void setInstrComment(MachineCode* code, MachineInstr* instr, const char* format, va_list args);
+
+// Entradas [start, end) em texto, uma por linha, para passá-las entre processos (-j)
+// ou guardá-las (--cache). Linhas do fonte relativas a linhaBase.
+void writeMachineCodeRange(FILE* file, const MachineCode* code, int start, int end, int linhaBase);
+// Acrescenta count entradas gravadas por writeMachineCodeRange; -1 se o texto está incompleto
+int readMachineCodeRange(FILE* file, MachineCode* code, int count, int linhaBase);
+
+// Visão textual (disassembly) e leitura de assembly em texto
+int formatMachineInstr(const MachineInstr* instr, char* text, size_t size);
+void writeAssemblyText(const MachineCode* code, FILE* output);
+void splitAssemblyLine(char* line, char** label, char** instr, char** comment);
+int parseAssemblyText(char* buffer, MachineCode* code);
+
+#endif
@@ -0,0 +1,335 @@
+#include "formato_saida.h"
+#include <sys/stat.h>
+#include <errno.h>
+#include <unistd.h>
+
+OutputFormat formatoSaida = OUT_BITS;
+unsigned int enderecoBase = 0;
+unsigned int profundidadeMif = 0;
+const char* diretorioSaida = OUTPUT_DEFAULT_DIR;
+
+ArtifactOutput artefatos[ART_COUNT] = {
+    {"symtab", "symtab.txt", 0, NULL},
+    {"ir", "quadruples.txt", 0, NULL},
+    {"tac", "three_address_code.txt", 0, NULL},
+    {"asm", "assembly.asm", 0, NULL},
+    {"lines", "linhas.txt", 0, NULL},
+    {"map", "programa.map", 0, NULL},
+    {"link-map", "memoria.map", 0, NULL},
+    {"counters", "contadores.txt", 0, NULL},
+    {NULL, NULL, 1, NULL},  // imagem: nome pelo formato (outputFileName)
+};
+
+static FILE* imageStream = NULL;  // a saída padrão original, com -o -
+
+static const struct {
+    const char* name;
+    OutputFormat format;
+    const char* file;
+} outputFormats[] = {
+    {"bits",   OUT_BITS,   "binary.txt"},
+    {"bin",    OUT_BIN_LE, "binary.bin"},
+    {"bin-be", OUT_BIN_BE, "binary.bin"},
+    {"hex",    OUT_HEX,    "binary.hex"},
+    {"mif",    OUT_MIF,    "binary.mif"},
+    {NULL,     OUT_BITS,   NULL}
+};
+
+int parseOutputFormat(const char* name, OutputFormat* format) {
+    for (int i = 0; outputFormats[i].name != NULL; i++) {
+        if (strcmp(outputFormats[i].name, name) == 0) {
+            *format = outputFormats[i].format;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+const char* outputFileName(OutputFormat format) {
+    for (int i = 0; outputFormats[i].name != NULL; i++) {
+        if (outputFormats[i].format == format) {
+            return outputFormats[i].file;
+        }
+    }
+    return outputFormats[0].file;
+}
+
+/* ---------- diretório de saída ---------- */
+
+void outputPath(char* path, size_t size, const char* file) {
+    snprintf(path, size, "%s/%s", diretorioSaida, file);
+}
+
+// Cria o diretório e os que faltarem no caminho até ele (como mkdir -p)
+int createOutputDirectory(const char* dir) {
+    char path[OUTPUT_PATH_SIZE];
+    snprintf(path, sizeof(path), "%s", dir);
+    for (char* p = path + 1; ; p++) {
+        if (*p != '/' && *p != '\0') continue;
+        char saved = *p;
+        *p = '\0';
+        if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+            return -1;
+        }
+        *p = saved;
+        if (saved == '\0') break;
+    }
+    return 0;
+}
+
+/* ---------- arquivos gerados ---------- */
+
+int parseArtifactOptions(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0) {
+            if (i + 1 >= argc) {
+                printError("Erro: -o precisa de um arquivo (ou '-' para a saída padrão).");
+                return -1;
+            }
+            artefatos[ART_IMAGE].path = argv[++i];
+        } else if (strcmp(argv[i], "-S") == 0) {
+            artefatos[ART_ASM].requested = 1;
+        } else if (strcmp(argv[i], "-g") == 0) {
+            artefatos[ART_LINES].requested = 1;
+        } else if (strcmp(argv[i], "--save-temps") == 0) {
+            for (int a = 0; a < ART_COUNT; a++) {
+                artefatos[a].requested = 1;
+            }
+        } else if (strncmp(argv[i], "--emit-", 7) == 0) {
+            const char* name = argv[i] + 7;
+            int a;
+            for (a = 0; a < ART_IMAGE; a++) {
+                size_t length = strlen(artefatos[a].option);
+                if (strncmp(name, artefatos[a].option, length) == 0 &&
+                    (name[length] == '\0' || name[length] == '=')) {
+                    artefatos[a].requested = 1;
+                    if (name[length] == '=') {
+                        artefatos[a].path = name + length + 1;
+                    }
+                    break;
+                }
+            }
+            if (a == ART_IMAGE) {
+                printError("Opção desconhecida: '%s' (use --emit-symtab, --emit-ir, --emit-tac, --emit-asm, "
+                           "--emit-lines, --emit-map, --emit-link-map ou --emit-counters).", argv[i]);
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+void resetArtifactOptions(void) {
+    for (int a = 0; a < ART_COUNT; a++) {
+        artefatos[a].requested = a == ART_IMAGE;
+        artefatos[a].path = NULL;
+    }
+}
+
+int artifactPath(Artifact artifact, char* path, size_t size) {
+    const ArtifactOutput* output = &artefatos[artifact];
+    if (!output->requested) {
+        return 0;
+    }
+    if (output->path != NULL) {
+        snprintf(path, size, "%s", output->path);
+    } else {
+        outputPath(path, size, artifact == ART_IMAGE ? outputFileName(formatoSaida) : output->file);
+    }
+    return 1;
+}
+
+int reserveStdoutForImage(void) {
+    fflush(stdout);
+    int fd = dup(STDOUT_FILENO);
+    if (fd < 0 || (imageStream = fdopen(fd, "wb")) == NULL) {
+        return -1;
+    }
+    // Daqui em diante tudo que é impresso em stdout (mensagens e relatórios) vai para stderr
+    return dup2(STDERR_FILENO, STDOUT_FILENO) < 0 ? -1 : 0;
+}
+
+/* ---------- escrita com buffer ---------- */
+
+OutputBuffer* openOutputBuffer(const char* path, int binaryMode) {
+    int stream = strcmp(path, OUTPUT_STDOUT) == 0;
+    if (stream && imageStream == NULL) {
+        return NULL;
+    }
+    FILE* file = stream ? imageStream : fopen(path, binaryMode ? "wb" : "w");
+    if (file == NULL) {
+        return NULL;
+    }
+    OutputBuffer* out = malloc(sizeof(OutputBuffer));
+    out->file = file;
+    out->data = malloc(OUTPUT_BLOCK_SIZE);
+    out->used = 0;
+    out->stream = stream;
+    return out;
+}
+
+static void flushOutputBuffer(OutputBuffer* out) {
+    if (out->used > 0) {
+        fwrite(out->data, 1, out->used, out->file);
+        out->used = 0;
+    }
+}
+
+void bufferWrite(OutputBuffer* out, const void* bytes, size_t size) {
+    const unsigned char* src = bytes;
+    while (size > 0) {
+        if (out->used == OUTPUT_BLOCK_SIZE) {
+            flushOutputBuffer(out);
+        }
+        size_t chunk = OUTPUT_BLOCK_SIZE - out->used;
+        if (chunk > size) chunk = size;
+        memcpy(out->data + out->used, src, chunk);
+        out->used += chunk;
+        src += chunk;
+        size -= chunk;
+    }
+}
+
+// Linhas curtas (cabeçalhos e registros): formata direto no bloco
+void bufferPrintf(OutputBuffer* out, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t room = OUTPUT_BLOCK_SIZE - out->used;
+    int n = vsnprintf((char*)out->data + out->used, room, format, args);
+    va_end(args);
+    if (n < 0) {
+        return;
+    }
+    if ((size_t)n >= room) {
+        char* text = malloc(n + 1);
+        va_start(args, format);
+        vsnprintf(text, n + 1, format, args);
+        va_end(args);
+        bufferWrite(out, text, n);
+        free(text);
+        return;
+    }
+    out->used += n;
+}
+
+int closeOutputBuffer(OutputBuffer* out) {
+    flushOutputBuffer(out);
+    int result = ferror(out->file) ? -1 : 0;
+    if ((out->stream ? fflush(out->file) : fclose(out->file)) != 0) {
+        result = -1;
+    }
+    free(out->data);
+    free(out);
+    return result;
+}
+
+/* ---------- formatos ---------- */
+
+static void writeBitLines(OutputBuffer* out, const unsigned int* words, int count) {
+    char line[33];
+    line[32] = '\n';
+    for (int i = 0; i < count; i++) {
+        for (int b = 0; b < 32; b++) {
+            line[31 - b] = ((words[i] >> b) & 1) ? '1' : '0';
+        }
+        bufferWrite(out, line, 33);
+    }
+}
+
+static void writeRawBinary(OutputBuffer* out, const unsigned int* words, int count, int bigEndian) {
+    unsigned char bytes[4];
+    for (int i = 0; i < count; i++) {
+        for (int b = 0; b < 4; b++) {
+            int shift = bigEndian ? 24 - 8 * b : 8 * b;
+            bytes[b] = (words[i] >> shift) & 0xFF;
+        }
+        bufferWrite(out, bytes, 4);
+    }
+}
+
+// Registro ":LLAAAATT<dados>CC" com checksum em complemento de dois
+static void writeHexRecord(OutputBuffer* out, unsigned int address, int type,
+                           const unsigned char* data, int size) {
+    unsigned int sum = size + ((address >> 8) & 0xFF) + (address & 0xFF) + type;
+    char line[64];
+    int n = sprintf(line, ":%02X%04X%02X", size, address & 0xFFFF, type);
+    for (int i = 0; i < size; i++) {
+        n += sprintf(line + n, "%02X", data[i]);
+        sum += data[i];
+    }
+    sprintf(line + n, "%02X\n", (-sum) & 0xFF);
+    bufferWrite(out, line, n + 3);
+}
+
+// Cada endereço do registro é uma palavra de 32 bits, com os bytes em big-endian,
+// como o Quartus lê memórias com WIDTH = 32. Os 16 bits altos do endereço vão em
+// registros de endereço linear estendido (tipo 04).
+static void writeIntelHex(OutputBuffer* out, const unsigned int* words, int count) {
+    unsigned int upper = 0;
+    int i = 0;
+    while (i < count) {
+        unsigned int address = enderecoBase + i;
+        if ((address >> 16) != upper) {
+            unsigned char ext[2] = {(address >> 24) & 0xFF, (address >> 16) & 0xFF};
+            upper = address >> 16;
+            writeHexRecord(out, 0, 4, ext, 2);
+        }
+        // o registro não atravessa a fronteira de 64K palavras
+        int n = count - i;
+        if (n > HEX_RECORD_WORDS) n = HEX_RECORD_WORDS;
+        if ((address & 0xFFFF) + n > 0x10000) n = 0x10000 - (address & 0xFFFF);
+
+        unsigned char data[HEX_RECORD_WORDS * 4];
+        for (int w = 0; w < n; w++) {
+            for (int b = 0; b < 4; b++) {
+                data[w * 4 + b] = (words[i + w] >> (24 - 8 * b)) & 0xFF;
+            }
+        }
+        writeHexRecord(out, address, 0, data, n * 4);
+        i += n;
+    }
+    writeHexRecord(out, 0, 1, NULL, 0);
+}
+
+// Sem --mif-depth o DEPTH é o mínimo que cobre a base mais o programa
+static int writeMif(OutputBuffer* out, const unsigned int* words, int count) {
+    unsigned int needed = enderecoBase + count;
+    unsigned int depth = profundidadeMif ? profundidadeMif : needed;
+    if (depth < needed) {
+        printError("Erro: o programa (%d palavras a partir de %u) não cabe em DEPTH = %u.",
+                   count, enderecoBase, depth);
+        return -1;
+    }
+
+    bufferPrintf(out, "DEPTH = %u;\nWIDTH = 32;\nADDRESS_RADIX = DEC;\nDATA_RADIX = HEX;\n", depth);
+    bufferPrintf(out, "CONTENT\nBEGIN\n");
+    if (enderecoBase > 0) {
+        bufferPrintf(out, "[0..%u] : 00000000;\n", enderecoBase - 1);
+    }
+    for (int i = 0; i < count; i++) {
+        bufferPrintf(out, "%u : %08X;\n", enderecoBase + i, words[i]);
+    }
+    if (needed < depth) {
+        bufferPrintf(out, "[%u..%u] : 00000000;\n", needed, depth - 1);
+    }
+    bufferPrintf(out, "END;\n");
+    return 0;
+}
+
+int writeMemoryImage(OutputBuffer* out, OutputFormat format, const unsigned int* words, int count) {
+    switch (format) {
+        case OUT_BIN_LE:
+        case OUT_BIN_BE:
+            writeRawBinary(out, words, count, format == OUT_BIN_BE);
+            return 0;
+        case OUT_HEX:
+            writeIntelHex(out, words, count);
+            return 0;
+        case OUT_MIF:
+            return writeMif(out, words, count);
+        case OUT_BITS:
+            writeBitLines(out, words, count);
+            return 0;
+    }
+    return -1;
+}
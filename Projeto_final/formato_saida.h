@@ -0,0 +1,83 @@
+#ifndef FORMATO_SAIDA_H
+#define FORMATO_SAIDA_H
+
+#include "globals.h"
+
+#define OUTPUT_BLOCK_SIZE (64 * 1024) // escrita em blocos grandes, um fwrite por bloco
+#define HEX_RECORD_WORDS 4            // palavras por registro de dados do Intel HEX (16 bytes)
+#define OUTPUT_DEFAULT_DIR "Output"
+#define OUTPUT_PATH_SIZE 512
+
+// Formatos da imagem do programa montado
+typedef enum {
+    OUT_BITS,       // binary.txt: uma palavra por linha em '0'/'1' (padrão)
+    OUT_BIN_LE,     // binary.bin: palavras de 32 bits little-endian
+    OUT_BIN_BE,     // binary.bin: palavras de 32 bits big-endian
+    OUT_HEX,        // binary.hex: Intel HEX, endereços em palavras (convenção do Quartus)
+    OUT_MIF         // binary.mif: Memory Initialization File do Quartus
+} OutputFormat;
+
+#define OUTPUT_STDOUT "-"   // -o -: a imagem vai para a saída padrão
+
+// Arquivos que a compilação pode gravar. Só a imagem é gravada sempre; os
+// outros só quando pedidos (--emit-*, -S, -g ou --save-temps).
+typedef enum {
+    ART_SYMTAB,     // symtab.txt
+    ART_IR,         // quadruples.txt
+    ART_TAC,        // three_address_code.txt
+    ART_ASM,        // assembly.asm
+    ART_LINES,      // linhas.txt: endereço -> linha do fonte e função (-g)
+    ART_MAP,        // programa.map: tamanho e pilha de cada função
+    ART_LINK_MAP,   // memoria.map: slots e funções da imagem ligada (--link)
+    ART_COUNTERS,   // contadores.txt: endereço de cada contador -> função e bloco (--instrument)
+    ART_IMAGE,      // binary.* (ou o objeto, com -c)
+    ART_COUNT
+} Artifact;
+
+typedef struct {
+    const char* option;     // --emit-<option>[=arquivo]
+    const char* file;       // nome padrão, no diretório de saída
+    int requested;
+    const char* path;       // caminho pedido; NULL = diretório de saída
+} ArtifactOutput;
+
+// Arquivo de saída com buffer próprio
+typedef struct {
+    FILE* file;
+    unsigned char* data;
+    size_t used;
+    int stream;             // saída padrão: no fim só esvazia, não fecha
+} OutputBuffer;
+
+extern OutputFormat formatoSaida;  // --format=bits|bin|bin-be|hex|mif
+extern unsigned int enderecoBase;  // --base=N: endereço (em palavras) da primeira instrução no hex/mif
+extern unsigned int profundidadeMif; // --mif-depth=N: DEPTH do .mif (0 = só o necessário)
+extern const char* diretorioSaida; // onde os arquivos gerados são gravados (Output, ou o do lote)
+
+int parseOutputFormat(const char* name, OutputFormat* format);
+const char* outputFileName(OutputFormat format);  // nome do arquivo da imagem, sem diretório
+
+extern ArtifactOutput artefatos[ART_COUNT];
+
+// Caminho de um arquivo gerado dentro do diretório de saída
+void outputPath(char* path, size_t size, const char* file);
+int createOutputDirectory(const char* dir);
+
+// -o arquivo, --emit-symtab|ir|tac|asm|lines|map|link-map|counters[=arquivo], -S, -g e --save-temps. Devolve -1 com opção inválida
+int parseArtifactOptions(int argc, char* argv[]);
+void resetArtifactOptions(void);
+// Caminho onde o arquivo é gravado; devolve 0 se ele não foi pedido
+int artifactPath(Artifact artifact, char* path, size_t size);
+
+// -o -: guarda a saída padrão para a imagem e manda as mensagens para stderr
+int reserveStdoutForImage(void);
+
+OutputBuffer* openOutputBuffer(const char* path, int binaryMode);
+void bufferWrite(OutputBuffer* out, const void* bytes, size_t size);
+void bufferPrintf(OutputBuffer* out, const char* format, ...);
+int closeOutputBuffer(OutputBuffer* out);
+
+// Grava a imagem no formato pedido; devolve -1 se ela não cabe no formato
+int writeMemoryImage(OutputBuffer* out, OutputFormat format, const unsigned int* words, int count);
+
+#endif
@@ -1,13 +1,95 @@
 #include "globals.h"
+#include <unistd.h>
 
-// função de print de debug
-void debugPrint(const char* format, ...) {
-    #ifdef DEBUG
+#define TRACE_BUFFER_SIZE 65536
+
+unsigned int categoriasTrace = 0;
+
+static FILE* traceSink = NULL;      // stderr duplicado ou o arquivo de --trace-file
+static int traceColor = 0;          // amarelo só no terminal
+static char traceBuffer[TRACE_BUFFER_SIZE];
+static int flushRegistered = 0;
+
+static const struct {
+    const char* name;
+    unsigned int category;
+} traceNames[] = {
+    {"ast", TRACE_AST},
+    {"symtab", TRACE_SYMTAB},
+    {"sem", TRACE_SEM},
+    {"ir", TRACE_IR},
+    {"asm", TRACE_ASSEMBLY},
+    {"all", TRACE_ALL},
+};
+
+int parseTraceCategories(const char* list) {
+    const char* start = list;
+    while (*start != '\0') {
+        size_t length = strcspn(start, ",");
+        size_t i;
+        for (i = 0; i < sizeof(traceNames) / sizeof(traceNames[0]); i++) {
+            if (strlen(traceNames[i].name) == length && strncmp(start, traceNames[i].name, length) == 0) {
+                categoriasTrace |= traceNames[i].category;
+                break;
+            }
+        }
+        if (i == sizeof(traceNames) / sizeof(traceNames[0])) {
+            printError("Categoria de trace desconhecida: '%.*s' (use ast, symtab, sem, ir, asm ou all).",
+                       (int)length, start);
+            return -1;
+        }
+        start += length + (start[length] == ',');
+    }
+    return 0;
+}
+
+// O buffer só vai para o destino quando enche ou no flushTrace
+static void attachSink(FILE* sink, int color) {
+    traceSink = sink;
+    traceColor = color;
+    setvbuf(traceSink, traceBuffer, _IOFBF, sizeof(traceBuffer));
+    if (!flushRegistered) {
+        atexit(flushTrace);
+        flushRegistered = 1;
+    }
+}
+
+int openTraceFile(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printError("Erro ao abrir %s.", path);
+        return -1;
+    }
+    if (traceSink != NULL) {
+        flushTrace();
+        fclose(traceSink);
+        traceSink = NULL;
+    }
+    attachSink(file, 0);
+    return 0;
+}
+
+void tracePrint(const char* format, ...) {
+    if (traceSink == NULL) {
+        // Um FILE próprio sobre o stderr, para não mudar o buffer das mensagens de erro
+        FILE* sink = fdopen(dup(STDERR_FILENO), "w");
+        if (sink == NULL) {
+            return;
+        }
+        attachSink(sink, isatty(STDERR_FILENO));
+    }
     va_list args;
     va_start(args, format);
-    fprintf(stderr, "\033[33m"); // Amarelo para debug
-    vfprintf(stderr, format, args);
-    fprintf(stderr, "\033[0m\n");
+    if (traceColor) {
+        fputs("\033[33m", traceSink); // Amarelo para debug
+    }
+    vfprintf(traceSink, format, args);
+    fputs(traceColor ? "\033[0m\n" : "\n", traceSink);
     va_end(args);
-    #endif
-}
\ No newline at end of file
+}
+
+void flushTrace(void) {
+    if (traceSink != NULL) {
+        fflush(traceSink);
+    }
+}
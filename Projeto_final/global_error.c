@@ -1,12 +1,137 @@
 #include "globals.h"
+#include "tempo_fases.h"
+
+#define OUTPUT_BUFFER_SIZE 65536
+
+int modoSilencioso = 0;
+int diagnosticosJson = 0;
+const char* arquivoFonte = DIAG_STDIN_NAME;
+
+static char outputBuffer[OUTPUT_BUFFER_SIZE];
+static char errorBuffer[OUTPUT_BUFFER_SIZE];
+
+static const char* severityJsonNames[] = {"info", "warning", "error"};
+static const char* severityColors[] = {"", "\033[33m", "\033[31m"};
+
+// Depois de ler --diagnostics: com JSON, stderr também ganha um buffer e recebe linhas inteiras
+void initDiagnostics(void) {
+    setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+    if (diagnosticosJson) {
+        setvbuf(stderr, errorBuffer, _IOFBF, sizeof(errorBuffer));
+    }
+}
+
+// Linha JSON montada em memória antes de ir para o stream
+typedef struct {
+    char text[8192];
+    size_t length;
+} JsonLine;
+
+static void appendRaw(JsonLine* line, const char* text) {
+    size_t size = strlen(text);
+    if (line->length + size >= sizeof(line->text)) {
+        size = sizeof(line->text) - 1 - line->length;
+    }
+    memcpy(line->text + line->length, text, size);
+    line->length += size;
+    line->text[line->length] = '\0';
+}
+
+// Texto como string JSON, sem as quebras de linha das pontas; NULL vira null
+static void appendString(JsonLine* line, const char* text) {
+    if (text == NULL) {
+        appendRaw(line, "null");
+        return;
+    }
+    while (*text == '\n') {
+        text++;
+    }
+    size_t length = strlen(text);
+    while (length > 0 && text[length - 1] == '\n') {
+        length--;
+    }
+    appendRaw(line, "\"");
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)text[i];
+        char escaped[8];
+        if (c == '"' || c == '\\') {
+            snprintf(escaped, sizeof(escaped), "\\%c", c);
+        } else if (c == '\n') {
+            snprintf(escaped, sizeof(escaped), "\\n");
+        } else if (c < 0x20) {
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        } else {
+            escaped[0] = (char)c;
+            escaped[1] = '\0';
+        }
+        appendRaw(line, escaped);
+    }
+    appendRaw(line, "\"");
+}
+
+static void report(DiagnosticSeverity severity, int line, const char* code, const char* format, va_list args) {
+    if (severity == DIAG_INFO && modoSilencioso) {
+        return;
+    }
+    if (diagnosticosJson) {
+        char message[1024];
+        char number[32];
+        JsonLine json = {.length = 0};
+        vsnprintf(message, sizeof(message), format, args);
+        appendRaw(&json, "{\"file\": ");
+        appendString(&json, arquivoFonte);
+        snprintf(number, sizeof(number), ", \"line\": %d, \"phase\": ", line);
+        appendRaw(&json, number);
+        appendString(&json, currentPhase());
+        appendRaw(&json, ", \"code\": ");
+        appendString(&json, code);
+        appendRaw(&json, ", \"severity\": ");
+        appendString(&json, severityJsonNames[severity]);
+        appendRaw(&json, ", \"message\": ");
+        appendString(&json, message);
+        appendRaw(&json, "}\n");
+        fflush(stdout);
+        fwrite(json.text, 1, json.length, stderr);
+        return;
+    }
+    if (severity == DIAG_INFO) {
+        vfprintf(stdout, format, args);
+        fputc('\n', stdout);
+        return;
+    }
+    // Avisos e erros vão direto para stderr, depois do que já estava no buffer
+    fflush(stdout);
+    fputs(severityColors[severity], stderr);
+    vfprintf(stderr, format, args);
+    fprintf(stderr, "\033[0m\n");
+}
+
+void diagnostic(DiagnosticSeverity severity, int line, const char* code, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    report(severity, line, code, format, args);
+    va_end(args);
+}
+
+void printInfo(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    report(DIAG_INFO, 0, NULL, format, args);
+    va_end(args);
+}
+
+void printWarning(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    report(DIAG_WARNING, 0, NULL, format, args);
+    va_end(args);
+}
 
 // print com cor vermelha
 void printError(const char* format, ...) {
     va_list args;
     va_start(args, format);
-    fprintf(stderr, "\033[31m"); // Vermelho para erro
-    vfprintf(stderr, format, args);
-    fprintf(stderr, "\033[0m\n");
+    report(DIAG_ERROR, 0, NULL, format, args);
     va_end(args);
 }
 
@@ -14,8 +139,12 @@ void printError(const char* format, ...) {
 void printSuccess(const char* format, ...) {
     va_list args;
     va_start(args, format);
-    fprintf(stdout, "\033[32m"); // Verde para sucesso
-    vfprintf(stdout, format, args);
-    fprintf(stdout, "\033[0m\n");
+    if (diagnosticosJson || modoSilencioso) {
+        report(DIAG_INFO, 0, NULL, format, args);
+    } else {
+        fprintf(stdout, "\033[32m"); // Verde para sucesso
+        vfprintf(stdout, format, args);
+        fprintf(stdout, "\033[0m\n");
+    }
     va_end(args);
-}
\ No newline at end of file
+}
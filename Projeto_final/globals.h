@@ -7,20 +7,71 @@
 #include <stdarg.h> 
 #include <ctype.h>
 
+// Diagnósticos: toda mensagem tem uma severidade. As informativas vão para stdout,
+// que é bufferizado (initDiagnostics); avisos e erros vão para stderr. Com -q as
+// informativas somem; com --diagnostics=json cada mensagem vira uma linha JSON no stderr,
+// também bufferizado.
+typedef enum { DIAG_INFO, DIAG_WARNING, DIAG_ERROR } DiagnosticSeverity;
+
+#define DIAG_STDIN_NAME "<stdin>"
+
+extern int modoSilencioso;        // -q
+extern int diagnosticosJson;      // --diagnostics=json
+extern const char* arquivoFonte;  // programa sendo compilado, para os diagnósticos
+
+void initDiagnostics(void);
+
+// line 0 quando a mensagem não é de uma linha do fonte; code pode ser NULL
+void diagnostic(DiagnosticSeverity severity, int line, const char* code, const char* format, ...);
+
+void printInfo(const char* format, ...);
+
+void printWarning(const char* format, ...);
+
 void printError(const char* format, ...);
 
 void printSuccess(const char* format, ...);
 
-void debugPrint(const char* format, ...);
-
 /* Variáveis Globais */
 extern int yylineno; // Número da linha para mensagens de erro
 
-// função e definições de debug
-#define DEBUG_AST(fmt, ...) debugPrint("AST Debug [%s:%d]: " fmt, __FILE__, __LINE__, ##__VA_ARGS__)
-#define DEBUG_SYMTAB(fmt, ...) debugPrint("Symtab Debug [%s:%d]: " fmt, __FILE__, __LINE__, ##__VA_ARGS__)
-#define DEBUG_SEM(fmt, ...) debugPrint("Semantic Debug [%s:%d]: " fmt, __FILE__, __LINE__, ##__VA_ARGS__)
-#define DEBUG_IR(fmt, ...) debugPrint("IR Debug [%s:%d]: " fmt, __FILE__, __LINE__, ##__VA_ARGS__)
-#define DEBUG_ASSEMBLY(fmt, ...) debugPrint("Assembly Debug [%s:%d]: " fmt, __FILE__, __LINE__, ##__VA_ARGS__)
+// Categorias de trace, ligadas em tempo de execução com --trace=ast,symtab,... (só em make debug)
+#define TRACE_AST      0x01
+#define TRACE_SYMTAB   0x02
+#define TRACE_SEM      0x04
+#define TRACE_IR       0x08
+#define TRACE_ASSEMBLY 0x10
+#define TRACE_ALL      0x1f
+
+#ifdef DEBUG
+#define TRACE_BUILD 1
+#else
+#define TRACE_BUILD 0
+#endif
+
+extern unsigned int categoriasTrace; // categorias ligadas por --trace=
+
+// Escreve no destino do trace (bufferizado; ver flushTrace)
+void tracePrint(const char* format, ...);
+// Esvazia o buffer do trace; chamado antes de fork e no fim do programa
+void flushTrace(void);
+// Liga as categorias de uma lista "ir,asm" ou "all". Devolve -1 com nome desconhecido
+int parseTraceCategories(const char* list);
+// Manda o trace para um arquivo em vez de stderr
+int openTraceFile(const char* path);
+
+// Fora do make debug o if (0 && ...) some na compilação: os argumentos nem são avaliados,
+// mas continuam sendo verificados pelo compilador
+#define TRACE(category, prefix, fmt, ...) \
+    do { \
+        if (TRACE_BUILD && (categoriasTrace & (category))) \
+            tracePrint(prefix " [%s:%d]: " fmt, __FILE__, __LINE__, ##__VA_ARGS__); \
+    } while (0)
+
+#define DEBUG_AST(fmt, ...) TRACE(TRACE_AST, "AST Debug", fmt, ##__VA_ARGS__)
+#define DEBUG_SYMTAB(fmt, ...) TRACE(TRACE_SYMTAB, "Symtab Debug", fmt, ##__VA_ARGS__)
+#define DEBUG_SEM(fmt, ...) TRACE(TRACE_SEM, "Semantic Debug", fmt, ##__VA_ARGS__)
+#define DEBUG_IR(fmt, ...) TRACE(TRACE_IR, "IR Debug", fmt, ##__VA_ARGS__)
+#define DEBUG_ASSEMBLY(fmt, ...) TRACE(TRACE_ASSEMBLY, "Assembly Debug", fmt, ##__VA_ARGS__)
 
 #endif /* _GLOBALS_H_ */
\ No newline at end of file
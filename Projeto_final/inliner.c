@@ -0,0 +1,646 @@
+#include "inliner.h"
+#include "tempo_fases.h"
+#include "perfil.h"
+
+// Opções padrão do inliner (desligado até ser pedido com --inline)
+InlineOptions inlineOptions = {
+    0,
+    INLINE_DEFAULT_THRESHOLD,
+    INLINE_DEFAULT_SINGLE_THRESHOLD,
+    INLINE_DEFAULT_MAX_LOCALS,
+    0
+};
+
+#define MAX_INLINE_ARGS 16
+
+// Informações de uma função do código intermediário, usadas para montar o grafo de chamadas
+typedef struct {
+    char* name;
+    Quadruple* start;     // quádrupla FUNCTION
+    Quadruple* end;       // quádrupla END
+    int size;             // quádruplas do corpo (sem PARAM e ALLOC)
+    char** params;        // nomes dos parâmetros, na ordem
+    int paramCount;
+    char** locals;        // variáveis locais (ALLOC)
+    int localCount;
+    int hasArray;         // usa vetor local ou recebe vetor como parâmetro
+    int recursive;        // participa de um ciclo no grafo de chamadas
+    int callSites;        // chamadas restantes no programa
+    int inlinedSites;     // chamadas expandidas
+    int visitState;       // 0 = não visitada, 1 = em visita, 2 = concluída
+} FunctionInfo;
+
+// Argumentos (quádruplas ARGUMENT) que pertencem a uma mesma chamada
+typedef struct {
+    Quadruple* args[MAX_INLINE_ARGS];
+    int count;
+    int valid;
+} ArgFrame;
+
+// Mapeamento simples de nomes usado para renomear temporários, rótulos e variáveis
+typedef struct {
+    char** from;
+    char** to;
+    int count;
+    int capacity;
+} RenameMap;
+
+static FunctionInfo* functions = NULL;
+static int functionCount = 0;
+static int inlineCounter = 0;
+
+// Índice das funções por nome (endereçamento aberto; -1 marca posição vazia)
+static int* functionIndex = NULL;
+static int functionIndexSize = 0;
+
+static int isTempName(const char* name) {
+    return name != NULL && name[0] == 't' && isdigit(name[1]);
+}
+
+static int isConstantName(const char* name) {
+    return name != NULL && (isdigit(name[0]) || (name[0] == '-' && isdigit(name[1])));
+}
+
+// Hash FNV-1a do nome da função
+static unsigned int hashFunctionName(const char* name) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)name; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Monta o índice depois de collectFunctions (o vetor de funções não muda mais)
+static void buildFunctionIndex(void) {
+    functionIndexSize = 16;
+    while (functionIndexSize < functionCount * 2) functionIndexSize *= 2;
+    functionIndex = memAlloc(functionIndexSize * sizeof(int));
+    for (int i = 0; i < functionIndexSize; i++) functionIndex[i] = -1;
+    for (int i = 0; i < functionCount; i++) {
+        unsigned int slot = hashFunctionName(functions[i].name) & (functionIndexSize - 1);
+        while (functionIndex[slot] != -1) slot = (slot + 1) & (functionIndexSize - 1);
+        functionIndex[slot] = i;
+    }
+}
+
+static FunctionInfo* findFunction(const char* name) {
+    if (name == NULL || functionIndex == NULL) return NULL;
+    unsigned int slot = hashFunctionName(name) & (functionIndexSize - 1);
+    while (functionIndex[slot] != -1) {
+        if (strcmp(functions[functionIndex[slot]].name, name) == 0) {
+            return &functions[functionIndex[slot]];
+        }
+        slot = (slot + 1) & (functionIndexSize - 1);
+    }
+    return NULL;
+}
+
+static void addName(char*** list, int* count, const char* name) {
+    *list = memRealloc(*list, (*count + 1) * sizeof(char*));
+    (*list)[(*count)++] = memStrdup(name);
+}
+
+static void freeNames(char** list, int count) {
+    for (int i = 0; i < count; i++) memFree(list[i]);
+    memFree(list);
+}
+
+static const char* mapLookup(RenameMap* map, const char* from) {
+    for (int i = 0; i < map->count; i++) {
+        if (strcmp(map->from[i], from) == 0) return map->to[i];
+    }
+    return NULL;
+}
+
+static const char* mapInsert(RenameMap* map, const char* from, const char* to) {
+    if (map->count >= map->capacity) {
+        map->capacity = map->capacity == 0 ? 16 : map->capacity * 2;
+        map->from = memRealloc(map->from, map->capacity * sizeof(char*));
+        map->to = memRealloc(map->to, map->capacity * sizeof(char*));
+    }
+    map->from[map->count] = memStrdup(from);
+    map->to[map->count] = memStrdup(to);
+    return map->to[map->count++];
+}
+
+static void mapFree(RenameMap* map) {
+    freeNames(map->from, map->count);
+    freeNames(map->to, map->count);
+    map->from = map->to = NULL;
+    map->count = map->capacity = 0;
+}
+
+// Cria uma quádrupla fora da lista principal (genQuad sempre insere no final)
+static Quadruple* newQuadruple(OperationType op, const char* arg1, const char* arg2, const char* result, int sourceLine) {
+    Quadruple* quad = (Quadruple*)memAlloc(sizeof(Quadruple));
+    if (quad == NULL) {
+        fprintf(stderr, "Erro: Falha ao alocar memória para quadrupla.\n");
+        exit(EXIT_FAILURE);
+    }
+    quad->op = op;
+    quad->arg1 = arg1 ? memStrdup(arg1) : NULL;
+    quad->arg2 = arg2 ? memStrdup(arg2) : NULL;
+    quad->result = result ? memStrdup(result) : NULL;
+    quad->line = 0;
+    quad->sourceLine = sourceLine;
+    quad->next = NULL;
+    return quad;
+}
+
+static void freeQuadruple(Quadruple* quad) {
+    if (quad->arg1) memFree(quad->arg1);
+    if (quad->arg2) memFree(quad->arg2);
+    if (quad->result) memFree(quad->result);
+    memFree(quad);
+}
+
+// Recalcula tamanho, parâmetros e variáveis locais de uma função
+static void analyzeFunction(FunctionInfo* f) {
+    freeNames(f->params, f->paramCount);
+    freeNames(f->locals, f->localCount);
+    f->params = NULL;
+    f->locals = NULL;
+    f->paramCount = 0;
+    f->localCount = 0;
+    f->size = 0;
+    f->hasArray = 0;
+
+    int leading = 1;
+    for (Quadruple* q = f->start->next; q != NULL && q != f->end; q = q->next) {
+        if (q->op == OP_PARAM && leading) {
+            addName(&f->params, &f->paramCount, q->arg1);
+            BucketList symbol = st_lookup_in_scope(q->arg1, f->name);
+            if (symbol != NULL && symbol->isArray) f->hasArray = 1;
+            continue;
+        }
+        leading = 0;
+        if (q->op == OP_ALLOC) {
+            if (q->arg2 && strcmp(q->arg2, "array") == 0) f->hasArray = 1;
+            addName(&f->locals, &f->localCount, q->result);
+            continue;
+        }
+        if (q->op == OP_COUNT) continue;  // contadores do --instrument não mudam a decisão
+        f->size++;
+    }
+}
+
+// Monta a tabela de funções percorrendo as quádruplas FUNCTION ... END
+static void collectFunctions(Quadruple* head) {
+    for (Quadruple* q = head; q != NULL; q = q->next) {
+        if (q->op != OP_FUNCTION) continue;
+
+        Quadruple* end = q->next;
+        while (end != NULL && end->op != OP_END) end = end->next;
+        if (end == NULL) break;
+
+        functions = memRealloc(functions, (functionCount + 1) * sizeof(FunctionInfo));
+        FunctionInfo* f = &functions[functionCount++];
+        memset(f, 0, sizeof(FunctionInfo));
+        f->name = memStrdup(q->arg1);
+        f->start = q;
+        f->end = end;
+        analyzeFunction(f);
+        q = end;
+    }
+}
+
+// Conta as chamadas a funções do programa (funções pré-definidas não entram no grafo)
+static void countCallSites(void) {
+    for (int i = 0; i < functionCount; i++) functions[i].callSites = 0;
+    for (int i = 0; i < functionCount; i++) {
+        for (Quadruple* q = functions[i].start; q != functions[i].end; q = q->next) {
+            if (q->op != OP_CALL) continue;
+            FunctionInfo* callee = findFunction(q->arg1);
+            if (callee != NULL) callee->callSites++;
+        }
+    }
+}
+
+// Verifica se 'target' é alcançável a partir das chamadas feitas por 'from'
+static int reaches(FunctionInfo* from, FunctionInfo* target, int* visited) {
+    int index = (int)(from - functions);
+    if (visited[index]) return 0;
+    visited[index] = 1;
+
+    for (Quadruple* q = from->start; q != from->end; q = q->next) {
+        if (q->op != OP_CALL) continue;
+        FunctionInfo* callee = findFunction(q->arg1);
+        if (callee == NULL) continue;
+        if (callee == target || reaches(callee, target, visited)) return 1;
+    }
+    return 0;
+}
+
+static void markRecursiveFunctions(void) {
+    int* visited = memAlloc(functionCount * sizeof(int));
+    for (int i = 0; i < functionCount; i++) {
+        memset(visited, 0, functionCount * sizeof(int));
+        functions[i].recursive = reaches(&functions[i], &functions[i], visited);
+    }
+    memFree(visited);
+}
+
+// Ordem pós-fixada do grafo de chamadas: as funções chamadas são processadas antes de quem as chama
+static void postOrder(FunctionInfo* f, int* order, int* orderCount) {
+    if (f->visitState != 0) return;
+    f->visitState = 1;
+    for (Quadruple* q = f->start; q != f->end; q = q->next) {
+        if (q->op != OP_CALL) continue;
+        FunctionInfo* callee = findFunction(q->arg1);
+        if (callee != NULL) postOrder(callee, order, orderCount);
+    }
+    f->visitState = 2;
+    order[(*orderCount)++] = (int)(f - functions);
+}
+
+// Procura uma variável global usada pela função chamada que o chamador esconde com uma variável local
+static const char* findShadowedGlobal(FunctionInfo* caller, FunctionInfo* callee) {
+    for (Quadruple* q = callee->start->next; q != callee->end; q = q->next) {
+        int hasLabel = q->op == OP_LABEL || q->op == OP_JUMP || q->op == OP_JUMPFALSE || q->op == OP_JUMPTRUE;
+        char* fields[3] = { q->arg1, q->arg2, q->result };
+        for (int i = 0; i < 3; i++) {
+            char* name = fields[i];
+            if (name == NULL || isTempName(name) || isConstantName(name)) continue;
+            if (hasLabel && i == 2) continue;
+            if (q->op == OP_CALL && i < 2) continue;
+            if (q->op == OP_ARGUMENT && i == 1) continue;
+            if (q->op == OP_ALLOC && i < 2) continue;
+
+            int own = 0;
+            for (int j = 0; j < callee->paramCount && !own; j++) own = strcmp(callee->params[j], name) == 0;
+            for (int j = 0; j < callee->localCount && !own; j++) own = strcmp(callee->locals[j], name) == 0;
+            if (own) continue;
+
+            BucketList symbol = st_lookup_in_scope(name, caller->name);
+            if (symbol != NULL && (strcmp(symbol->idType, "var") == 0 || strcmp(symbol->idType, "param") == 0)) {
+                return name;
+            }
+        }
+    }
+    return NULL;
+}
+
+// Decide se a chamada deve ser expandida e descreve o motivo em 'why'.
+// 'count' é quantas vezes o bloco da chamada executou segundo o --profile (-1 sem perfil).
+static int shouldInline(FunctionInfo* caller, FunctionInfo* callee, ArgFrame* frame, int argc,
+                        int addedLocals, long long count, char* why, size_t whyLen) {
+    int callCost = INLINE_CALL_OVERHEAD + INLINE_ARG_OVERHEAD * argc;
+
+    if (isDispatcherEntry(callee->name) || strcmp(callee->name, "main") == 0) {
+        snprintf(why, whyLen, "ponto de entrada, deve permanecer fora de linha");
+        return 0;
+    }
+    if (callee->recursive) {
+        snprintf(why, whyLen, "função recursiva");
+        return 0;
+    }
+    if (callee->hasArray) {
+        snprintf(why, whyLen, "usa vetor local ou parâmetro vetor");
+        return 0;
+    }
+    if (argc != callee->paramCount || argc > MAX_INLINE_ARGS ||
+        (argc > 0 && (frame == NULL || !frame->valid || frame->count != argc))) {
+        snprintf(why, whyLen, "argumentos em formato não suportado");
+        return 0;
+    }
+    const char* shadowed = findShadowedGlobal(caller, callee);
+    if (shadowed != NULL) {
+        snprintf(why, whyLen, "variável global '%s' escondida por variável local do chamador", shadowed);
+        return 0;
+    }
+    // Chamada que nunca executou só aumentaria o código (a não ser a única, que remove a função)
+    if (count == 0 && callee->callSites > 1) {
+        snprintf(why, whyLen, "bloco nunca executado no perfil");
+        return 0;
+    }
+    int locals = caller->localCount + addedLocals + callee->paramCount + callee->localCount;
+    if (locals > inlineOptions.maxLocals) {
+        snprintf(why, whyLen, "pressão de registradores: %d variáveis locais > limite %d",
+                 locals, inlineOptions.maxLocals);
+        return 0;
+    }
+    // Chamada quente: o limite de tamanho cresce, o custo da chamada se repete a cada execução
+    int sizeThreshold = inlineOptions.sizeThreshold;
+    char heat[64] = "";
+    if (profileIsHot(count)) {
+        sizeThreshold *= PROFILE_HOT_INLINE_FACTOR;
+        snprintf(heat, sizeof(heat), " (bloco quente, %lld execuções)", count);
+    }
+    if (callee->size <= sizeThreshold) {
+        snprintf(why, whyLen, "corpo de %d quádruplas <= limite %d%s, economiza ~%d instruções de chamada",
+                 callee->size, sizeThreshold, heat, callCost);
+        return 1;
+    }
+    if (callee->callSites == 1 && callee->size <= inlineOptions.singleThreshold) {
+        snprintf(why, whyLen, "chamada única, corpo de %d quádruplas <= limite %d, economiza ~%d instruções de chamada",
+                 callee->size, inlineOptions.singleThreshold, callCost);
+        return 1;
+    }
+    snprintf(why, whyLen, "corpo de %d quádruplas > limite %d%s (custo da chamada ~%d instruções)",
+             callee->size, callee->callSites == 1 ? inlineOptions.singleThreshold : sizeThreshold, heat,
+             callCost);
+    return 0;
+}
+
+// Renomeia um campo de uma quádrupla copiada do corpo da função chamada
+static char* renameField(OperationType op, int field, const char* value,
+                         RenameMap* temps, RenameMap* labels, RenameMap* vars) {
+    if (value == NULL) return NULL;
+
+    int isLabelField = field == 2 && (op == OP_LABEL || op == OP_JUMP || op == OP_JUMPFALSE || op == OP_JUMPTRUE);
+    if (isLabelField) {
+        const char* mapped = mapLookup(labels, value);
+        if (mapped == NULL) {
+            char* label = newLabel();
+            mapped = mapInsert(labels, value, label);
+            memFree(label);
+        }
+        return memStrdup(mapped);
+    }
+    if ((op == OP_CALL && field < 2) || (op == OP_ARGUMENT && field == 1)) {
+        return memStrdup(value);
+    }
+    if (isTempName(value)) {
+        const char* mapped = mapLookup(temps, value);
+        if (mapped == NULL) {
+            char* temp = newTemp();
+            mapped = mapInsert(temps, value, temp);
+            memFree(temp);
+        }
+        return memStrdup(mapped);
+    }
+    const char* mapped = mapLookup(vars, value);
+    return memStrdup(mapped ? mapped : value);
+}
+
+// Copia o corpo da função chamada no lugar da quádrupla CALL.
+// Parâmetros e variáveis locais viram variáveis locais do chamador (com ALLOC em 'allocs'),
+// os argumentos viram atribuições a essas variáveis e cada RETURN grava direto no resultado da chamada.
+static Quadruple* expandCall(FunctionInfo* caller, FunctionInfo* callee, Quadruple* call, ArgFrame* frame,
+                             Quadruple** tail, Quadruple** allocs) {
+    RenameMap temps = {0}, labels = {0}, vars = {0};
+    int id = ++inlineCounter;
+    char newName[64];
+
+    for (int i = 0; i < callee->paramCount + callee->localCount; i++) {
+        char* original = i < callee->paramCount ? callee->params[i] : callee->locals[i - callee->paramCount];
+        snprintf(newName, sizeof(newName), "%.30s_in%d", original, id);
+        mapInsert(&vars, original, newName);
+        st_insert(newName, call->sourceLine, 0, caller->name, "var", "int", 0, 0);
+
+        Quadruple* alloc = newQuadruple(OP_ALLOC, "4", "var", newName, call->sourceLine);
+        alloc->next = *allocs;
+        *allocs = alloc;
+    }
+
+    // Os argumentos passam a ser atribuições às cópias dos parâmetros
+    for (int i = 0; i < callee->paramCount; i++) {
+        Quadruple* arg = frame->args[i];
+        arg->op = OP_ASSIGN;
+        memFree(arg->arg2);
+        arg->arg2 = NULL;
+        if (arg->result) memFree(arg->result);
+        arg->result = memStrdup(mapLookup(&vars, callee->params[i]));
+    }
+
+    // O valor de cada RETURN é calculado direto no temporário que recebe o resultado da chamada
+    int hasResult = call->result != NULL && isTempName(call->result);
+    for (Quadruple* q = callee->start->next; q != callee->end; q = q->next) {
+        if (q->op == OP_RETURN && isTempName(q->arg1) && mapLookup(&temps, q->arg1) == NULL) {
+            if (hasResult) {
+                mapInsert(&temps, q->arg1, call->result);
+            } else {
+                char* temp = newTemp();
+                mapInsert(&temps, q->arg1, temp);
+                memFree(temp);
+            }
+        }
+    }
+
+    Quadruple* last = callee->start;
+    for (Quadruple* q = callee->start->next; q != callee->end; q = q->next) last = q;
+
+    char* endLabel = newLabel();
+    int endUsed = 0;
+    Quadruple* head = NULL;
+    *tail = NULL;
+    int leading = 1;
+
+    for (Quadruple* q = callee->start->next; q != callee->end; q = q->next) {
+        if (q->op == OP_PARAM && leading) continue;
+        leading = 0;
+        if (q->op == OP_ALLOC) continue;
+
+        Quadruple* copy;
+        if (q->op == OP_RETURN) {
+            if (q == last) continue;
+            copy = newQuadruple(OP_JUMP, NULL, NULL, endLabel, q->sourceLine);
+            endUsed = 1;
+        } else {
+            copy = newQuadruple(q->op, NULL, NULL, NULL, q->sourceLine);
+            copy->arg1 = renameField(q->op, 0, q->arg1, &temps, &labels, &vars);
+            copy->arg2 = renameField(q->op, 1, q->arg2, &temps, &labels, &vars);
+            copy->result = renameField(q->op, 2, q->result, &temps, &labels, &vars);
+
+            // As chamadas copiadas passam a contar como chamadas feitas pelo chamador
+            FunctionInfo* target = copy->op == OP_CALL ? findFunction(copy->arg1) : NULL;
+            if (target != NULL) target->callSites++;
+        }
+
+        if (head == NULL) head = copy;
+        else (*tail)->next = copy;
+        *tail = copy;
+    }
+
+    if (endUsed) {
+        Quadruple* label = newQuadruple(OP_LABEL, NULL, NULL, endLabel, call->sourceLine);
+        if (head == NULL) head = label;
+        else (*tail)->next = label;
+        *tail = label;
+    }
+
+    for (int i = 0; i < labels.count; i++) {
+        profileAliasLabel(labels.to[i], callee->name, labels.from[i]);
+    }
+    memFree(endLabel);
+    mapFree(&temps);
+    mapFree(&labels);
+    mapFree(&vars);
+    return head;
+}
+
+// Expande as chamadas feitas por 'caller' que passarem pelas heurísticas
+static void inlineCallsIn(FunctionInfo* caller) {
+    ArgFrame frames[64];
+    int frameCount = 0;
+    int addedLocals = 0;
+    Quadruple* allocs = NULL;
+
+    char block[PROFILE_MAX_BLOCK];  // bloco do perfil em que está a quádrupla q
+    profileNextBlock(caller->start, block, sizeof(block));
+
+    Quadruple* prev = caller->start;
+    Quadruple* q = caller->start->next;
+    while (q != NULL && q->op == OP_PARAM) {
+        prev = q;
+        q = q->next;
+    }
+
+    while (q != NULL && q != caller->end) {
+        if (q->op == OP_ARGUMENT) {
+            int index = atoi(q->arg2);
+            if (index == 0 && frameCount < 64) {
+                frames[frameCount].count = 0;
+                frames[frameCount].valid = 1;
+                frameCount++;
+            }
+            if (frameCount > 0) {
+                ArgFrame* top = &frames[frameCount - 1];
+                if (top->count != index || top->count >= MAX_INLINE_ARGS) top->valid = 0;
+                else top->args[top->count] = q;
+                top->count++;
+            }
+        } else if (q->op == OP_PARAM && frameCount < 64) {
+            // PARAM usado como argumento único de uma chamada: não é expandido
+            frames[frameCount].count = 1;
+            frames[frameCount].valid = 0;
+            frameCount++;
+        } else if (q->op == OP_CALL) {
+            int argc = atoi(q->arg2);
+            ArgFrame* frame = NULL;
+            if (argc > 0 && frameCount > 0) frame = &frames[--frameCount];
+
+            FunctionInfo* callee = findFunction(q->arg1);
+            if (callee != NULL) {
+                char why[256];
+                int expand = shouldInline(caller, callee, frame, argc, addedLocals,
+                                          profileCount(caller->name, block), why, sizeof(why));
+                if (inlineOptions.report) {
+                    printInfo("Inline: %s -> %s (linha %d): %s; %s", callee->name, caller->name, q->sourceLine,
+                              expand ? "expandida" : "mantida fora de linha", why);
+                }
+                if (expand) {
+                    Quadruple* tail = NULL;
+                    Quadruple* body = expandCall(caller, callee, q, frame, &tail, &allocs);
+                    Quadruple* after = q->next;
+                    if (body != NULL) {
+                        prev->next = body;
+                        tail->next = after;
+                    } else {
+                        prev->next = after;
+                        tail = prev;
+                    }
+                    freeQuadruple(q);
+
+                    addedLocals += callee->paramCount + callee->localCount;
+                    callee->callSites--;
+                    callee->inlinedSites++;
+
+                    // O corpo copiado já foi processado quando a função chamada foi visitada
+                    prev = tail;
+                    q = tail->next;
+                    continue;
+                }
+            }
+        }
+        profileNextBlock(q, block, sizeof(block));
+        prev = q;
+        q = q->next;
+    }
+
+    // Reserva as variáveis das funções expandidas no início do chamador
+    if (allocs != NULL) {
+        Quadruple* point = caller->start;
+        while (point->next != caller->end && (point->next->op == OP_PARAM || point->next->op == OP_ALLOC)) {
+            point = point->next;
+        }
+        Quadruple* allocTail = allocs;
+        while (allocTail->next != NULL) allocTail = allocTail->next;
+        allocTail->next = point->next;
+        point->next = allocs;
+    }
+
+    analyzeFunction(caller);
+}
+
+// Remove funções que não são mais chamadas depois de terem todas as chamadas expandidas
+static void removeDeadFunctions(IRCode* ir) {
+    countCallSites();
+    for (int i = 0; i < functionCount; i++) {
+        FunctionInfo* f = &functions[i];
+        if (f->inlinedSites == 0 || f->callSites > 0) continue;
+        if (strcmp(f->name, "main") == 0 || isDispatcherEntry(f->name)) continue;
+
+        Quadruple* prev = NULL;
+        for (Quadruple* q = ir->head; q != NULL && q != f->start; q = q->next) prev = q;
+
+        Quadruple* after = f->end->next;
+        if (prev == NULL) ir->head = after;
+        else prev->next = after;
+        if (ir->tail == f->end) ir->tail = prev;
+
+        Quadruple* q = f->start;
+        while (q != after) {
+            Quadruple* next = q->next;
+            freeQuadruple(q);
+            q = next;
+        }
+        f->start = f->end = NULL;
+
+        if (inlineOptions.report) {
+            printInfo("Inline: %s removida (todas as %d chamadas foram expandidas)", f->name, f->inlinedSites);
+        }
+    }
+}
+
+void inlineIRCode(void) {
+    IRCode* ir = getIRCode();
+    if (ir->head == NULL) return;
+
+    functions = NULL;
+    functionCount = 0;
+    inlineCounter = 0;
+    collectFunctions(ir->head);
+    buildFunctionIndex();
+    countCallSites();
+    markRecursiveFunctions();
+
+    int* order = memAlloc((functionCount > 0 ? functionCount : 1) * sizeof(int));
+    int orderCount = 0;
+    for (int i = 0; i < functionCount; i++) {
+        postOrder(&functions[i], order, &orderCount);
+    }
+
+    int expanded = 0;
+    for (int i = 0; i < orderCount; i++) {
+        inlineCallsIn(&functions[order[i]]);
+    }
+    for (int i = 0; i < functionCount; i++) expanded += functions[i].inlinedSites;
+    memFree(order);
+
+    removeDeadFunctions(ir);
+
+    // Renumera as quádruplas e atualiza o fim da lista
+    int line = 1;
+    for (Quadruple* q = ir->head; q != NULL; q = q->next) {
+        q->line = line++;
+        if (q->next == NULL) ir->tail = q;
+    }
+
+    if (inlineOptions.report) {
+        printInfo("Inline: %d chamada(s) expandida(s)", expanded);
+    }
+
+    for (int i = 0; i < functionCount; i++) {
+        memFree(functions[i].name);
+        freeNames(functions[i].params, functions[i].paramCount);
+        freeNames(functions[i].locals, functions[i].localCount);
+    }
+    memFree(functions);
+    functions = NULL;
+    functionCount = 0;
+    memFree(functionIndex);
+    functionIndex = NULL;
+    functionIndexSize = 0;
+}
@@ -0,0 +1,28 @@
+#ifndef _INLINER_H_
+#define _INLINER_H_
+
+#include "globals.h"
+#include "cinter.h"
+#include "symtab.h"
+
+#define INLINE_DEFAULT_THRESHOLD 15        // tamanho máximo (em quádruplas) do corpo de uma função pequena
+#define INLINE_DEFAULT_SINGLE_THRESHOLD 60 // tamanho máximo para funções chamadas uma única vez
+#define INLINE_DEFAULT_MAX_LOCALS 10       // variáveis locais que o chamador pode ter depois do inlining
+#define INLINE_CALL_OVERHEAD 15            // instruções gastas em prólogo, epílogo e jal de uma chamada
+#define INLINE_ARG_OVERHEAD 3              // instruções gastas por argumento (carga, sw na pilha, lw do param)
+
+// Opções do inliner, preenchidas pelo main a partir da linha de comando
+typedef struct {
+    int enabled;          // --inline
+    int sizeThreshold;    // --inline-threshold=N
+    int singleThreshold;  // --inline-single-threshold=N
+    int maxLocals;        // --inline-max-locals=N
+    int report;           // --inline-report
+} InlineOptions;
+
+extern InlineOptions inlineOptions;
+
+// Substitui chamadas a funções pequenas pelo corpo da função no código intermediário
+void inlineIRCode(void);
+
+#endif
@@ -938,7 +938,7 @@ case 32:
 YY_RULE_SETUP
 #line 81 "lex.flex"
 {
-    printError("Erro léxico: Numero float malformado '%s' na linha %d\n", yytext, yylineno);
+    diagnostic(DIAG_ERROR, yylineno, "L01", "Erro léxico: Numero float malformado '%s' na linha %d\n", yytext, yylineno);
     // exit(1); 
     lexErrorCount++;
 };
@@ -947,7 +947,7 @@ case 33:
 YY_RULE_SETUP
 #line 87 "lex.flex"
 {
-    printError("Erro léxico: Caractere invalido '%s' na linha %d\n", yytext, yylineno);
+    diagnostic(DIAG_ERROR, yylineno, "L02", "Erro léxico: Caractere invalido '%s' na linha %d\n", yytext, yylineno);
     // exit(1);
     lexErrorCount++;
 }
@@ -957,7 +957,7 @@ case 34:
 YY_RULE_SETUP
 #line 93 "lex.flex"
 {
-    printError("Erro léxico: Comentario nao encerrado iniciado na linha %d\n", yylineno);
+    diagnostic(DIAG_ERROR, yylineno, "L03", "Erro léxico: Comentario nao encerrado iniciado na linha %d\n", yylineno);
     // exit(1);
     lexErrorCount++;
 }
@@ -966,7 +966,7 @@ case 35:
 YY_RULE_SETUP
 #line 99 "lex.flex"
 {
-    printError("Erro léxico: Variavel '%s' no formato inválido na linha %d\n", yytext, yylineno);
+    diagnostic(DIAG_ERROR, yylineno, "L04", "Erro léxico: Variavel '%s' no formato inválido na linha %d\n", yytext, yylineno);
     // exit(1);
     lexErrorCount++;
 } 
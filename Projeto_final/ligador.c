@@ -0,0 +1,389 @@
+#include "ligador.h"
+#include "cinter.h"
+#include "formato_saida.h"
+
+int gerarObjeto = 0;
+const char* nomeObjeto = NULL;
+
+// Layout fixo usado pelo marcOS quando cada programa é montado sozinho
+static const struct {
+    const char* image;
+    int address;
+} defaultLayout[] = {
+    {"dispatchersavenpremp", 1001},
+    {"dispatcherloadnpremp", 1201},
+    {"dispatchersavepprog",  1401},
+    {"dispatchersavepremp",  1601},
+    {NULL, 0}
+};
+
+int defaultImageAddress(const char* image) {
+    for (int i = 0; defaultLayout[i].image != NULL; i++) {
+        if (strcmp(defaultLayout[i].image, image) == 0) {
+            return defaultLayout[i].address;
+        }
+    }
+    return -1;
+}
+
+// Nome do objeto: --obj-name, o ponto de entrada do dispatcher ou "programa"
+const char* objectName(const MachineCode* code) {
+    if (nomeObjeto != NULL) {
+        return nomeObjeto;
+    }
+    for (int i = 0; i < code->count; i++) {
+        if (code->items[i].isFunction && isDispatcherEntry(code->items[i].label)) {
+            return code->items[i].label;
+        }
+    }
+    return "programa";
+}
+
+void freeRelocations(RelocationList* relocations) {
+    for (int i = 0; i < relocations->count; i++) {
+        free(relocations->items[i].symbol);
+    }
+    relocations->count = 0;
+}
+
+/* ---------- arquivo objeto ---------- */
+
+static const char* fixupKindName(FixupKind kind) {
+    switch (kind) {
+        case FIX_IMM14: return "IMM14";
+        case FIX_REL14: return "REL14";
+        case FIX_TARGET26: return "TARGET26";
+    }
+    return "?";
+}
+
+static int parseFixupKind(const char* name, FixupKind* kind) {
+    if (strcmp(name, "IMM14") == 0) *kind = FIX_IMM14;
+    else if (strcmp(name, "TARGET26") == 0) *kind = FIX_TARGET26;
+    else return -1;
+    return 0;
+}
+
+// Formato textual, uma entrada por linha:
+//   OBJETO nome / PALAVRAS n / FUNCAO nome deslocamento / RELOC endereço tipo imagem
+//   CODIGO seguido de n palavras em hexadecimal / FIM
+int writeObjectFile(const ObjectFile* object, const char* path) {
+    OutputBuffer* out = openOutputBuffer(path, 0);
+    if (out == NULL) {
+        return -1;
+    }
+    bufferPrintf(out, "OBJETO %s\nPALAVRAS %d\n", object->name, object->count);
+    for (int i = 0; i < object->functionCount; i++) {
+        bufferPrintf(out, "FUNCAO %s %d\n", object->functions[i].name, object->functions[i].offset);
+    }
+    for (int i = 0; i < object->relocationCount; i++) {
+        const Relocation* reloc = &object->relocations[i];
+        bufferPrintf(out, "RELOC %d %s %s\n", reloc->address, fixupKindName(reloc->kind), reloc->symbol);
+    }
+    bufferPrintf(out, "CODIGO\n");
+    for (int i = 0; i < object->count; i++) {
+        bufferPrintf(out, "%08X\n", object->words[i]);
+    }
+    bufferPrintf(out, "FIM\n");
+    return closeOutputBuffer(out);
+}
+
+int readObjectFile(const char* path, ObjectFile* object) {
+    FILE* input = fopen(path, "r");
+    memset(object, 0, sizeof(ObjectFile));
+    if (input == NULL) {
+        printError("Erro: não foi possível abrir o objeto '%s'.", path);
+        return -1;
+    }
+
+    char line[MAX_LINE_LENGTH];
+    char name[MAX_LINE_LENGTH];
+    char kind[32];
+    int value;
+    int capacity = 0;
+    int inCode = 0;
+    int errors = 0;
+    int relocCapacity = 0;
+    int functionCapacity = 0;
+
+    while (fgets(line, sizeof(line), input) != NULL && errors == 0) {
+        if (inCode) {
+            unsigned int word;
+            if (strncmp(line, "FIM", 3) == 0) {
+                inCode = 0;
+            } else if (object->count < capacity && sscanf(line, "%x", &word) == 1) {
+                object->words[object->count++] = word;
+            } else {
+                errors++;
+            }
+        } else if (sscanf(line, "OBJETO %s", name) == 1) {
+            object->name = strdup(name);
+        } else if (sscanf(line, "PALAVRAS %d", &value) == 1 && value >= 0) {
+            capacity = value;
+            object->words = calloc(capacity + 1, sizeof(unsigned int));
+        } else if (sscanf(line, "FUNCAO %s %d", name, &value) == 2) {
+            if (object->functionCount == functionCapacity) {
+                functionCapacity = functionCapacity ? functionCapacity * 2 : 16;
+                object->functions = realloc(object->functions, functionCapacity * sizeof(ObjectSymbol));
+            }
+            object->functions[object->functionCount].name = strdup(name);
+            object->functions[object->functionCount].offset = value;
+            object->functionCount++;
+        } else if (sscanf(line, "RELOC %d %31s %s", &value, kind, name) == 3) {
+            if (object->relocationCount == relocCapacity) {
+                relocCapacity = relocCapacity ? relocCapacity * 2 : 16;
+                object->relocations = realloc(object->relocations, relocCapacity * sizeof(Relocation));
+            }
+            Relocation* reloc = &object->relocations[object->relocationCount++];
+            reloc->symbol = strdup(name);
+            reloc->address = value;
+            if (parseFixupKind(kind, &reloc->kind) != 0 || value < 0) {
+                errors++;
+            }
+        } else if (strncmp(line, "CODIGO", 6) == 0 && object->words != NULL) {
+            inCode = 1;
+        } else if (line[0] != '\n') {
+            errors++;
+        }
+    }
+    fclose(input);
+
+    if (errors > 0 || inCode || object->name == NULL || object->words == NULL || object->count != capacity) {
+        printError("Erro: objeto '%s' inválido.", path);
+        return -1;
+    }
+    for (int i = 0; i < object->relocationCount; i++) {
+        if (object->relocations[i].address >= object->count) {
+            printError("Erro: relocação fora do objeto '%s'.", path);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void freeObjectFile(ObjectFile* object) {
+    free(object->name);
+    free(object->words);
+    for (int i = 0; i < object->functionCount; i++) {
+        free(object->functions[i].name);
+    }
+    free(object->functions);
+    for (int i = 0; i < object->relocationCount; i++) {
+        free(object->relocations[i].symbol);
+    }
+    free(object->relocations);
+    memset(object, 0, sizeof(ObjectFile));
+}
+
+/* ---------- ligação ---------- */
+
+// Script de ligação, uma imagem por linha ('#' inicia comentário):
+//   arquivo.obj  endereço|auto  tamanho|auto
+// "auto" no endereço coloca o slot logo depois do anterior; no tamanho, usa
+// exatamente o tamanho do objeto (sem sobra no slot).
+static int readLinkScript(const char* scriptPath, LinkSlot* slots, int* slotCount) {
+    FILE* script = fopen(scriptPath, "r");
+    if (script == NULL) {
+        printError("Erro: não foi possível abrir o script de ligação '%s'.", scriptPath);
+        return -1;
+    }
+
+    char line[MAX_LINE_LENGTH];
+    char path[MAX_LINE_LENGTH];
+    char address[32];
+    char size[32];
+    int errors = 0;
+    int lineNumber = 0;
+    int nextAddress = 0;
+    *slotCount = 0;
+
+    while (fgets(line, sizeof(line), script) != NULL) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment != NULL) *comment = '\0';
+        int fields = sscanf(line, "%s %31s %31s", path, address, size);
+        if (fields <= 0) continue;
+        if (fields != 3) {
+            printError("Erro: %s:%d: esperado 'arquivo endereço tamanho'.", scriptPath, lineNumber);
+            errors++;
+            continue;
+        }
+        if (*slotCount == MAX_LINK_OBJECTS) {
+            printError("Erro: mais de %d imagens no script de ligação.", MAX_LINK_OBJECTS);
+            errors++;
+            break;
+        }
+
+        LinkSlot* slot = &slots[*slotCount];
+        if (readObjectFile(path, &slot->object) != 0) {
+            freeObjectFile(&slot->object);
+            errors++;
+            continue;
+        }
+        slot->address = strcmp(address, "auto") == 0 ? nextAddress : (int)strtol(address, NULL, 0);
+        slot->size = strcmp(size, "auto") == 0 ? slot->object.count : (int)strtol(size, NULL, 0);
+        nextAddress = slot->address + slot->size;
+        (*slotCount)++;
+    }
+    fclose(script);
+    return errors > 0 ? -1 : 0;
+}
+
+static int checkSlots(const LinkSlot* slots, int slotCount) {
+    int errors = 0;
+    for (int i = 0; i < slotCount; i++) {
+        const LinkSlot* slot = &slots[i];
+        if (slot->address < 0 || slot->size < 0) {
+            printError("Erro: slot de '%s' com endereço ou tamanho negativo.", slot->object.name);
+            errors++;
+        }
+        if (slot->object.count > slot->size) {
+            printError("Erro: '%s' tem %d palavras e não cabe no slot de %d palavras em %d.",
+                       slot->object.name, slot->object.count, slot->size, slot->address);
+            errors++;
+        }
+        for (int j = 0; j < i; j++) {
+            const LinkSlot* other = &slots[j];
+            if (slot->address < other->address + other->size && other->address < slot->address + slot->size) {
+                printError("Erro: os slots de '%s' e '%s' se sobrepõem.", other->object.name, slot->object.name);
+                errors++;
+            }
+            if (strcmp(slot->object.name, other->object.name) == 0) {
+                printError("Erro: imagem '%s' definida duas vezes.", slot->object.name);
+                errors++;
+            }
+        }
+    }
+    return errors;
+}
+
+static const LinkSlot* findSlot(const LinkSlot* slots, int slotCount, const char* image) {
+    for (int i = 0; i < slotCount; i++) {
+        if (strcmp(slots[i].object.name, image) == 0) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Copia cada objeto para o seu slot e corrige as referências @imagem
+static int placeObjects(const LinkSlot* slots, int slotCount, unsigned int* image) {
+    int errors = 0;
+    for (int i = 0; i < slotCount; i++) {
+        const ObjectFile* object = &slots[i].object;
+        unsigned int* words = image + slots[i].address;
+        memcpy(words, object->words, object->count * sizeof(unsigned int));
+
+        for (int r = 0; r < object->relocationCount; r++) {
+            const Relocation* reloc = &object->relocations[r];
+            const LinkSlot* target = findSlot(slots, slotCount, reloc->symbol);
+            unsigned int mask = reloc->kind == FIX_TARGET26 ? 0x3FFFFFF : 0x3FFF;
+            if (target == NULL) {
+                // li + j de uma mesma chamada: avisa uma vez por imagem
+                int reported = 0;
+                for (int k = 0; k < r && !reported; k++) {
+                    reported = strcmp(object->relocations[k].symbol, reloc->symbol) == 0;
+                }
+                if (!reported) {
+                    printError("Erro: '%s' referencia a imagem '%s', que não está no script.",
+                               object->name, reloc->symbol);
+                }
+                errors++;
+            } else if ((unsigned int)target->address > mask) {
+                printError("Erro: o endereço %d de '%s' não cabe no campo %s (referência em '%s').",
+                           target->address, reloc->symbol, fixupKindName(reloc->kind), object->name);
+                errors++;
+            } else {
+                words[reloc->address] = (words[reloc->address] & ~mask) | target->address;
+            }
+        }
+    }
+    return errors;
+}
+
+static void writeMemoryMap(const LinkSlot* slots, int slotCount, int imageSize) {
+    char path[OUTPUT_PATH_SIZE];
+    if (!artifactPath(ART_LINK_MAP, path, sizeof(path))) {
+        return;
+    }
+    OutputBuffer* out = openOutputBuffer(path, 0);
+    if (out == NULL) {
+        printError("Erro ao gravar %s.", path);
+        return;
+    }
+
+    int used = 0;
+    int reserved = 0;
+    bufferPrintf(out, "Mapa de memória de instruções (%d palavras)\n\n", imageSize);
+    bufferPrintf(out, "%-24s %8s %8s %8s %8s %8s\n", "Imagem", "Início", "Fim", "Slot", "Usado", "Livre");
+    for (int i = 0; i < slotCount; i++) {
+        const LinkSlot* slot = &slots[i];
+        bufferPrintf(out, "%-24s %8d %8d %8d %8d %8d\n", slot->object.name, slot->address,
+                     slot->address + slot->size - 1, slot->size, slot->object.count,
+                     slot->size - slot->object.count);
+        used += slot->object.count;
+        reserved += slot->size;
+    }
+    bufferPrintf(out, "\nTotal: %d palavras usadas de %d reservadas (%d livres nos slots)\n",
+                 used, reserved, reserved - used);
+
+    bufferPrintf(out, "\nFunções\n");
+    for (int i = 0; i < slotCount; i++) {
+        const ObjectFile* object = &slots[i].object;
+        for (int f = 0; f < object->functionCount; f++) {
+            bufferPrintf(out, "%8d  %s.%s\n", slots[i].address + object->functions[f].offset,
+                         object->name, object->functions[f].name);
+        }
+    }
+    closeOutputBuffer(out);
+    printInfo("Mapa de memória salvo em %s", path);
+}
+
+int linkObjects(const char* scriptPath) {
+    LinkSlot* slots = calloc(MAX_LINK_OBJECTS, sizeof(LinkSlot));
+    int slotCount = 0;
+    int errors = readLinkScript(scriptPath, slots, &slotCount) != 0;
+    if (errors == 0) {
+        errors = checkSlots(slots, slotCount);
+    }
+
+    if (errors == 0) {
+        // A imagem vai até a última palavra ocupada; os buracos entre slots ficam zerados
+        int imageSize = 0;
+        for (int i = 0; i < slotCount; i++) {
+            if (slots[i].address + slots[i].object.count > imageSize) {
+                imageSize = slots[i].address + slots[i].object.count;
+            }
+        }
+        unsigned int* image = calloc(imageSize + 1, sizeof(unsigned int));
+        errors = placeObjects(slots, slotCount, image);
+
+        if (errors == 0) {
+            char path[OUTPUT_PATH_SIZE];
+            artifactPath(ART_IMAGE, path, sizeof(path));
+            OutputBuffer* out = openOutputBuffer(path, formatoSaida != OUT_BITS);
+            if (out == NULL || writeMemoryImage(out, formatoSaida, image, imageSize) != 0) {
+                errors++;
+            }
+            if (out != NULL && closeOutputBuffer(out) != 0) {
+                errors++;
+            }
+            if (errors > 0) {
+                printError("Erro ao gravar %s.", path);
+                if (strcmp(path, OUTPUT_STDOUT) != 0) {
+                    remove(path);
+                }
+            } else {
+                printInfo("Ligação concluída: %d imagem(ns), %d palavras em %s", slotCount, imageSize, path);
+                writeMemoryMap(slots, slotCount, imageSize);
+            }
+        }
+        free(image);
+    }
+
+    for (int i = 0; i < slotCount; i++) {
+        freeObjectFile(&slots[i].object);
+    }
+    free(slots);
+    return errors > 0 ? -1 : 0;
+}
@@ -0,0 +1,49 @@
+#ifndef LIGADOR_H
+#define LIGADOR_H
+
+#include "globals.h"
+#include "binario_proc.h"
+
+#define MAX_LINK_OBJECTS 64 // imagens num script de ligação
+
+// Função definida no objeto, com o deslocamento a partir do início da imagem
+typedef struct {
+    char* name;
+    int offset;
+} ObjectSymbol;
+
+// Objeto relocável (Output/<nome>.obj). O código de cada imagem é relativo ao
+// próprio início (a base vem de r44/r39 em tempo de execução); só as referências
+// a outras imagens (@imagem) precisam ser corrigidas pelo ligador.
+typedef struct {
+    char* name;                 // nome da imagem, usado nas referências @nome
+    unsigned int* words;
+    int count;
+    ObjectSymbol* functions;
+    int functionCount;
+    Relocation* relocations;
+    int relocationCount;
+} ObjectFile;
+
+// Imagem posicionada pelo script de ligação
+typedef struct {
+    int address;        // início do slot
+    int size;           // tamanho do slot em palavras
+    ObjectFile object;
+} LinkSlot;
+
+extern int gerarObjeto;         // -c: grava o objeto relocável em vez da imagem
+extern const char* nomeObjeto;  // --obj-name=NOME
+
+int defaultImageAddress(const char* image);
+const char* objectName(const MachineCode* code);
+void freeRelocations(RelocationList* relocations);
+
+int writeObjectFile(const ObjectFile* object, const char* path);
+int readObjectFile(const char* path, ObjectFile* object);
+void freeObjectFile(ObjectFile* object);
+
+// Liga os objetos do script numa única imagem e, com --emit-link-map, grava memoria.map
+int linkObjects(const char* scriptPath);
+
+#endif
@@ -0,0 +1,216 @@
+#include "lote.h"
+#include "formato_saida.h"
+#include <unistd.h>
+#include <sys/wait.h>
+
+int tarefasParalelas = 1;
+
+int parseJobsOption(int argc, char* argv[], int i) {
+    if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+        tarefasParalelas = atoi(argv[i + 1]);
+        return 2;
+    }
+    if (strncmp(argv[i], "-j", 2) == 0 && isdigit((unsigned char)argv[i][2])) {
+        tarefasParalelas = atoi(argv[i] + 2);
+        return 1;
+    }
+    return 0;
+}
+
+// Diretório padrão de um arquivo do lote: Output/<nome sem extensão>
+static char* defaultBatchDirectory(const char* source) {
+    char dir[OUTPUT_PATH_SIZE];
+    const char* name = strrchr(source, '/');
+    name = name != NULL ? name + 1 : source;
+    const char* dot = strrchr(name, '.');
+    int length = dot != NULL && dot != name ? (int)(dot - name) : (int)strlen(name);
+    snprintf(dir, sizeof(dir), "%s/%.*s", OUTPUT_DEFAULT_DIR, length, name);
+    return strdup(dir);
+}
+
+// Cada linha da lista é "arquivo.c- [diretório] [opções...]". As opções da linha
+// valem só para aquele arquivo, somadas às da linha de comando.
+int readBatchList(const char* listPath, int argc, char* argv[], BatchEntry** entryList, int* entryCount) {
+    FILE* list = fopen(listPath, "r");
+    if (list == NULL) {
+        printError("Erro: não foi possível abrir a lista do lote '%s'.", listPath);
+        return -1;
+    }
+
+    BatchEntry* entries = NULL;
+    int count = 0;
+    char line[MAX_BATCH_LINE];
+    int lineNumber = 0;
+    while (fgets(line, sizeof(line), list) != NULL) {
+        lineNumber++;
+        char* source = strtok(line, " \t\r\n");
+        if (source == NULL || source[0] == '#') {
+            continue;
+        }
+
+        entries = realloc(entries, (count + 1) * sizeof(BatchEntry));
+        BatchEntry* entry = &entries[count++];
+        memset(entry, 0, sizeof(BatchEntry));
+        entry->source = strdup(source);
+        entry->lineNumber = lineNumber;
+
+        // A linha de comando (sem --batch e -j) seguida das opções da linha
+        for (int i = 0; i < argc && entry->argCount < MAX_BATCH_ARGS;) {
+            int consumed = i > 0 ? parseJobsOption(argc, argv, i) : 0;
+            if (consumed > 0) {
+                i += consumed;
+                continue;
+            }
+            if (strncmp(argv[i], "--batch=", 8) != 0) {
+                entry->args[entry->argCount++] = strdup(argv[i]);
+            }
+            i++;
+        }
+        char* token = strtok(NULL, " \t\r\n");
+        if (token != NULL && token[0] != '-') {
+            entry->dir = strdup(token);
+            token = strtok(NULL, " \t\r\n");
+        } else {
+            entry->dir = defaultBatchDirectory(source);
+        }
+        for (; token != NULL; token = strtok(NULL, " \t\r\n")) {
+            if (entry->argCount == MAX_BATCH_ARGS) {
+                printError("Erro: opções demais na linha %d da lista do lote.", lineNumber);
+                break;
+            }
+            entry->args[entry->argCount++] = strdup(token);
+        }
+    }
+    fclose(list);
+    *entryList = entries;
+    *entryCount = count;
+    return 0;
+}
+
+void freeBatchList(BatchEntry* entries, int count) {
+    for (int i = 0; i < count; i++) {
+        free(entries[i].source);
+        free(entries[i].dir);
+        for (int a = 0; a < entries[i].argCount; a++) {
+            free(entries[i].args[a]);
+        }
+    }
+    free(entries);
+}
+
+static int prepareEntry(const BatchEntry* entry) {
+    if (createOutputDirectory(entry->dir) != 0) {
+        printError("Erro: não foi possível criar o diretório '%s'.", entry->dir);
+        return -1;
+    }
+    return 0;
+}
+
+static void runSequential(BatchEntry* entries, int count, BatchCompiler compile, int* failed) {
+    for (int i = 0; i < count; i++) {
+        printInfo("\n=== [%d] %s -> %s ===", i + 1, entries[i].source, entries[i].dir);
+        failed[i] = prepareEntry(&entries[i]) != 0 || compile(&entries[i]) != 0;
+        if (failed[i]) {
+            printError("Falha ao compilar %s.", entries[i].source);
+        }
+    }
+}
+
+// Um processo por programa, no máximo tarefasParalelas ao mesmo tempo. Cada
+// processo começa com o estado do compilador intocado; a saída vai para o log
+// do diretório do programa para não se misturar com a dos outros.
+static void runParallel(BatchEntry* entries, int count, BatchCompiler compile, int* failed) {
+    pid_t* running = calloc(count, sizeof(pid_t));
+    int next = 0;
+    int active = 0;
+    int finished = 0;
+    while (finished < count) {
+        while (active < tarefasParalelas && next < count) {
+            int index = next++;
+            if (prepareEntry(&entries[index]) != 0) {
+                failed[index] = 1;
+                finished++;
+                continue;
+            }
+            fflush(stdout);
+            fflush(stderr);
+            flushTrace();
+            pid_t pid = fork();
+            if (pid == 0) {
+                char log[OUTPUT_PATH_SIZE];
+                snprintf(log, sizeof(log), "%s/%s", entries[index].dir, BATCH_LOG_FILE);
+                if (freopen(log, "w", stdout) != NULL) {
+                    dup2(fileno(stdout), STDERR_FILENO);
+                }
+                int result = compile(&entries[index]);
+                fflush(stdout);
+                fflush(stderr);
+                flushTrace();
+                _exit(result != 0 ? 1 : 0);
+            }
+            if (pid < 0) {
+                // sem processo novo: compila neste mesmo
+                printWarning("Aviso: fork falhou; compilando %s sem paralelismo.", entries[index].source);
+                failed[index] = compile(&entries[index]) != 0;
+                finished++;
+                continue;
+            }
+            running[index] = pid;
+            active++;
+        }
+        if (active == 0) {
+            continue;
+        }
+
+        int status;
+        pid_t pid = wait(&status);
+        if (pid < 0) {
+            break;
+        }
+        for (int i = 0; i < count; i++) {
+            if (running[i] == pid) {
+                running[i] = 0;
+                failed[i] = !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+                printInfo("[%d/%d] %s -> %s: %s", finished + 1, count, entries[i].source, entries[i].dir,
+                       failed[i] ? "erro (ver " BATCH_LOG_FILE ")" : "ok");
+                break;
+            }
+        }
+        active--;
+        finished++;
+    }
+    free(running);
+}
+
+int runBatch(const char* listPath, int argc, char* argv[], BatchCompiler compile) {
+    BatchEntry* entries = NULL;
+    int count = 0;
+    if (readBatchList(listPath, argc, argv, &entries, &count) != 0) {
+        return 1;
+    }
+
+    int* failed = calloc(count + 1, sizeof(int));
+    if (tarefasParalelas > 1 && count > 1) {
+        printInfo("Compilando %d programa(s) em até %d processo(s).", count, tarefasParalelas);
+        runParallel(entries, count, compile, failed);
+    } else {
+        runSequential(entries, count, compile, failed);
+    }
+
+    int failures = 0;
+    for (int i = 0; i < count; i++) {
+        failures += failed[i];
+    }
+    printInfo("\n-------------------------------------");
+    printInfo("Lote concluído: %d arquivo(s), %d com erro(s).", count, failures);
+    if (tarefasParalelas > 1 && failures > 0) {
+        for (int i = 0; i < count; i++) {
+            if (failed[i]) {
+                printInfo("- %s (%s/%s)", entries[i].source, entries[i].dir, BATCH_LOG_FILE);
+            }
+        }
+    }
+    free(failed);
+    freeBatchList(entries, count);
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,36 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include "globals.h"
+
+#define MAX_BATCH_LINE 1024 // linha da lista do modo lote
+#define MAX_BATCH_ARGS 64   // argumentos de uma compilação do lote (linha de comando + linha da lista)
+#define BATCH_LOG_FILE "compilacao.log" // saída de cada programa quando compilado em paralelo
+
+// Um programa da lista do lote
+typedef struct {
+    char* source;             // arquivo .c-
+    char* dir;                // diretório de saída
+    char* args[MAX_BATCH_ARGS]; // linha de comando (sem --batch e -j) + opções da linha
+    int argCount;
+    int lineNumber;
+} BatchEntry;
+
+// Compila um programa do lote; devolve o código de saída da compilação
+typedef int (*BatchCompiler)(const BatchEntry* entry);
+
+extern int tarefasParalelas;  // -j N: programas do lote (fora do lote, funções) compilados ao mesmo tempo
+
+// -j N ou -jN; devolve quantos argumentos a opção ocupa (0 se não é -j)
+int parseJobsOption(int argc, char* argv[], int i);
+
+// Lê a lista do lote; args de cada entrada = linha de comando + opções da linha
+int readBatchList(const char* listPath, int argc, char* argv[], BatchEntry** entryList, int* entryCount);
+void freeBatchList(BatchEntry* entries, int count);
+
+// --batch=lista: compila cada programa da lista com o estado do compilador zerado.
+// Com -j N > 1, até N programas são compilados ao mesmo tempo em processos
+// separados, cada um com a saída em <diretório>/compilacao.log.
+int runBatch(const char* listPath, int argc, char* argv[], BatchCompiler compile);
+
+#endif
@@ -1,31 +1,157 @@
+#include <limits.h>
 #include "globals.h"
 #include "asnt.h"
 #include "parser.h"
 #include "symtab.h"
 #include "semantic.h"
 #include "cinter.h"
+#include "inliner.h"
 #include "assembly_mips.h"
 #include "binario_proc.h"
+#include "formato_saida.h"
+#include "ligador.h"
+#include "cache_funcoes.h"
+#include "peephole.h"
+#include "lote.h"
+#include "simulador.h"
+#include "perfil.h"
+#include "metricas.h"
+#include "tempo_fases.h"
+#include "unidades.h"
 
 extern int yyparse(); /*função do parser*/
 extern int lexErrorCount; /*contador de erros léxicos*/
 extern int syntaxErrorCount; /*contador de erros sintáticos*/
 extern int semanticErrorCount; /*contador de erros semânticos*/
+extern void yyrestart(FILE* input); /*troca a entrada do analisador léxico*/
 
-int main(int argc, char *argv[]) {
+
+// Formato da imagem gravada (compilação ou ligação)
+static int parseOutputOptions(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--format=", 9) == 0) {
+            if (parseOutputFormat(argv[i] + 9, &formatoSaida) != 0) {
+                printError("Formato de saída desconhecido: '%s' (use bits, bin, bin-be, hex ou mif).",
+                           argv[i] + 9);
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--base=", 7) == 0) {
+            enderecoBase = strtoul(argv[i] + 7, NULL, 0);
+        } else if (strncmp(argv[i], "--mif-depth=", 12) == 0) {
+            profundidadeMif = strtoul(argv[i] + 12, NULL, 0);
+        }
+    }
+    return 0;
+}
+
+// Valor numérico de uma opção do inliner; -1 se não é um inteiro não negativo
+static int parseInlineValue(const char* option, const char* value) {
+    char* end;
+    long number = strtol(value, &end, 10);
+    if (*value == '\0' || *end != '\0' || number < 0 || number > INT_MAX) {
+        printError("Valor inválido para %.*s: '%s'.", (int)(value - option - 1), option, value);
+        return -1;
+    }
+    return (int)number;
+}
+
+// Opções do inliner (aplicado sobre o código intermediário); -1 se algum valor é inválido
+static int parseInlineOptions(int argc, char *argv[]) {
+    static const struct {
+        const char* prefix;
+        int* value;
+    } limits[] = {
+        {"--inline-threshold=", &inlineOptions.sizeThreshold},
+        {"--inline-single-threshold=", &inlineOptions.singleThreshold},
+        {"--inline-max-locals=", &inlineOptions.maxLocals}
+    };
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--inline") == 0) {
+            inlineOptions.enabled = 1;
+        } else if (strcmp(argv[i], "--inline-report") == 0) {
+            inlineOptions.enabled = 1;
+            inlineOptions.report = 1;
+        }
+        for (size_t k = 0; k < sizeof(limits) / sizeof(limits[0]); k++) {
+            size_t length = strlen(limits[k].prefix);
+            if (strncmp(argv[i], limits[k].prefix, length) == 0) {
+                int value = parseInlineValue(argv[i], argv[i] + length);
+                if (value < 0) {
+                    return -1;
+                }
+                inlineOptions.enabled = 1;
+                *limits[k].value = value;
+            }
+        }
+    }
+    return 0;
+}
+
+// --dispatcher: código sem inicialização do BCP
+static int modoDispatcher = 0;
+
+// Opções da geração de código e da montagem; -1 se algum valor é inválido
+static int parseBackendOptions(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dispatcher") == 0) {
+            modoDispatcher = 1;
+        } else if (strcmp(argv[i], "--pc-relative-branches") == 0) {
+            desvioLongo = 0;  // beqr..bler: exige o processador com os opcodes 29 e 33-37
+        } else if (strcmp(argv[i], "--long-branches") == 0) {
+            desvioLongo = 1;  // addil + bxx (o padrão)
+        } else if (strcmp(argv[i], "--no-peephole") == 0) {
+            peepholeEnabled = 0;
+        } else if (strcmp(argv[i], "--div-shift") == 0) {
+            divisaoPorDeslocamento = 1;
+        } else if (strcmp(argv[i], "-c") == 0) {
+            gerarObjeto = 1;  // objeto relocável para o ligador
+        } else if (strncmp(argv[i], "--obj-name=", 11) == 0) {
+            nomeObjeto = argv[i] + 11;
+        } else if (strcmp(argv[i], "--cache") == 0) {
+            cacheFuncoes = 1;  // reaproveita funções sem mudanças (funcoes.cache no diretório de saída)
+        } else if (strcmp(argv[i], "--metrics") == 0 || strncmp(argv[i], "--bench=", 8) == 0) {
+            gravarMetricas = 1;  // métricas estáticas do código gerado (metricas.json)
+        } else if (strncmp(argv[i], "--slot-size=", 12) == 0) {
+            tamanhoSlot = atoi(argv[i] + 12);  // avisa se a imagem não cabe no slot do processo
+        }
+    }
+    if (parseOutputOptions(argc, argv) != 0 || parseSimulatorOptions(argc, argv) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+// Compila o programa que está na entrada do analisador léxico (stdin ou o arquivo do lote)
+static int compileSource(int argc, char *argv[]) {
     int success = 1; // Flag para indicar se o processo foi bem-sucedido
-    printf("Iniciando a análise...\n");
+    int assemblyFailed = 0; // Flag para erros na montagem do binário
+    int simulationFailed = 0; // --simulate terminou com erro ou sem parar
+
+    // Todas as opções são lidas antes da análise: um valor inválido não gasta uma compilação
+    if (parseArtifactOptions(argc, argv) != 0 || parseInlineOptions(argc, argv) != 0 ||
+        parseBackendOptions(argc, argv) != 0) {
+        return 1;
+    }
+    // Output/ não vem no repositório: é criado na primeira compilação
+    if (createOutputDirectory(diretorioSaida) != 0) {
+        printError("Erro: não foi possível criar o diretório de saída '%s'.", diretorioSaida);
+        return 1;
+    }
+
+    printInfo("Iniciando a análise...");
 
     // Realiza a análise sintática
+    phaseBegin("analise lexica e sintatica");
     yyparse();
+    phaseEnd();
     if (lexErrorCount > 0) {
-        printf("Análise léxica concluída com %d erro(s).\n\n", syntaxErrorCount);
+        printInfo("Análise léxica concluída com %d erro(s).\n", lexErrorCount);
         success = 0;
     } else {
         printSuccess("Análise léxica concluída com sucesso!\n\n");
     }
     if (syntaxErrorCount > 0) {
-        printf("Análise sintática concluída com %d erro(s).\n\n", syntaxErrorCount);
+        printInfo("Análise sintática concluída com %d erro(s).\n", syntaxErrorCount);
         success = 0;
     } else {
         printSuccess("Análise sintática concluída com sucesso!\n\n");
@@ -36,23 +162,29 @@ int main(int argc, char *argv[]) {
         if (argc > 1 && strcmp(argv[1], "--print-tree") == 0) 
             printReducedAST(root, 0);
         else if (argc > 1 && strcmp(argv[1], "--print-full-tree") == 0){
-            FILE* outfile = fopen("Output/asnt.txt", "w");
+            char path[OUTPUT_PATH_SIZE];
+            outputPath(path, sizeof(path), "asnt.txt");
+            FILE* outfile = fopen(path, "w");
             printASTVertical(root, outfile);
             fclose(outfile);
-            printf("Árvore sintática completa impressa em 'Projeto_final/Output/asnt.txt'.\n");
+            printInfo("Árvore sintática completa impressa em '%s'.", path);
         } 
             
 
         // Construção da tabela de símbolos
-        printf("\nConstruindo tabela de símbolos...\n"); 
+        printInfo("\nConstruindo tabela de símbolos..."); 
+        phaseBegin("tabela de simbolos");
         buildSymtab(root);
-        printf("Tabela de símbolos construída com sucesso! \n");
+        phaseEnd();
+        printInfo("Tabela de símbolos construída com sucesso! ");
         // Análise semântica
-        printf("\nIniciando análise semântica...\n");
+        printInfo("\nIniciando análise semântica...");
+        phaseBegin("analise semantica");
         semanticAnalysis(root);
+        phaseEnd();
         
         if (semanticErrorCount > 0) {
-            printf("Análise semântica concluída com %d erro(s).\n", semanticErrorCount);
+            printInfo("Análise semântica concluída com %d erro(s).", semanticErrorCount);
             success = 0;
         } else {
             printSuccess("Análise semântica concluída com sucesso!\n");
@@ -60,44 +192,73 @@ int main(int argc, char *argv[]) {
 
         // Geração de código intermediário apenas se não houver erros
         if (success) {
-            printf("\nGerando código intermediário...\n");
-            ircode_generate(root);
-            printSuccess("Geração de código intermediário concluída!\n");
-            //abrir arquivo e para usar a função e salvar na pasta output
-            FILE* out_qd = fopen("Output/quadruples.txt", "r");
-            if (out_qd == NULL) {
-                printError("Erro ao abrir o arquivo.\n");
+            // --instrument e --profile: contadores por bloco e o perfil coletado com eles
+            if (parseProfileOptions(argc, argv) != 0) {
                 return 1;
             }
-            
-            
-            // Verifica se o argumento --dispatcher foi passado na linha de comando
-            int isDispatcherFile = 0;
-            for (int i = 1; i < argc; i++) {
-                if (strcmp(argv[i], "--dispatcher") == 0) {
-                    isDispatcherFile = 1;
-                    break;
+            printInfo("\nGerando código intermediário...");
+            int emitirAssembly = artefatos[ART_ASM].requested;  // -S: grava a visão textual assembly.asm
+            MachineCode code;
+            initMachineCode(&code, emitirAssembly);
+            // Código intermediário e backend por função, ligados no fim (-j N: em N processos)
+            generateProgramCode(root, modoDispatcher ? 0 : 1, &code);
+            printSuccess("Geração de código intermediário concluída!\n");
+            phaseBegin("geracao de codigo");
+            analyzeRegisterUsage(&code);  // relatório do uso de registradores, sobre o programa ligado
+            phaseEnd();
+            if (modoDispatcher) {
+                printInfo("Modo dispatcher ativado - código gerado sem inicialização BCP");
+            } else {
+                printInfo("Modo normal - código gerado com inicialização BCP");
+            }
+            if (cacheFuncoes) {
+                printFunctionCacheStats();
+            }
+            printSuccess("Código de máquina gerado\n");
+
+            // Otimizações locais sobre o código antes da montagem
+            if (peepholeEnabled) {
+                phaseBegin("peephole");
+                peepholeOptimize(&code);
+                phaseEnd();
+            }
+            if (gravarMetricas) {
+                writeProgramMetrics(&code);
+            }
+
+            // O assembly textual é só uma visão do código, gravada quando pedida
+            char path[OUTPUT_PATH_SIZE];
+            if (artifactPath(ART_ASM, path, sizeof(path))) {
+                FILE* out_asm = fopen(path, "w");
+                if (out_asm == NULL) {
+                    printError("Erro ao abrir o arquivo.\n");
+                    return 1;
                 }
+                writeAssemblyText(&code, out_asm);
+                fclose(out_asm);
+                printSuccess("Código assembly salvo em %s\n", path);
             }
-        
-            if (isDispatcherFile) {
-                generateAssembly(out_qd, 0);  // Modo dispatcher (sem inicialização BCP)
-                printf("Modo dispatcher ativado - código gerado sem inicialização BCP\n");
-            } else {
-                generateAssembly(out_qd, 1);  // Modo normal (com inicialização BCP)
-                printf("Modo normal - código gerado com inicialização BCP\n");
+
+            phaseBegin("montagem");
+            if (assembleMachineCode(&code) != 0) {
+                assemblyFailed = 1;  // rótulo duplicado ou não definido, ou imagem inválida
             }
-            
-            fclose(out_qd);
-            printSuccess("Código assembly gerado e salvo na pasta Output\n");
+            phaseEnd();
 
-            FILE* out_asm = fopen("Output/assembly.asm", "r");
-            if (out_asm == NULL) {
-                printError("Erro ao abrir o arquivo.\n");
-                return 1;
+            // --simulate: executa a imagem montada no simulador do processador
+            if (simularPrograma && !assemblyFailed) {
+                if (gerarObjeto) {
+                    printWarning("Aviso: --simulate ignorado com -c (o objeto ainda não foi ligado).");
+                } else {
+                    unsigned int* image = NULL;
+                    int imageSize = 0;
+                    if (assembleImage(&code, &image, &imageSize) != 0 || simulateImage(image, imageSize) != 0) {
+                        simulationFailed = 1;
+                    }
+                    free(image);
+                }
             }
-            read_assembly_file(out_asm);
-            fclose(out_asm);
+            freeMachineCode(&code);
 
         } else {
             printError("\nGeração de código intermediário, de código assembly e de código binário ignorada devido a erros.\n");
@@ -110,19 +271,224 @@ int main(int argc, char *argv[]) {
             freeIRCode();  // Libera a memória do código intermediário
         }
     } else {
-        printf("Aviso: Nenhuma árvore foi construída.\n");
+        printWarning("Aviso: Nenhuma árvore foi construída.");
         return 3;
     }
     
     // Resumo final dos erros
     if (lexErrorCount > 0 || syntaxErrorCount > 0 || semanticErrorCount > 0) {
-        printf("\n-------------------------------------\n");
-        printf("Resumo de erros:\n");
-        printf("- Erros léxicos: %d\n", lexErrorCount);
-        printf("- Erros sintáticos: %d\n", syntaxErrorCount);
-        printf("- Erros semânticos: %d\n", semanticErrorCount);
+        printInfo("\n-------------------------------------");
+        printInfo("Resumo de erros:");
+        printInfo("- Erros léxicos: %d", lexErrorCount);
+        printInfo("- Erros sintáticos: %d", syntaxErrorCount);
+        printInfo("- Erros semânticos: %d", semanticErrorCount);
+        return 1;
+    }
+    if (assemblyFailed || simulationFailed) {
         return 1;
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+static int compileProgram(int argc, char *argv[]) {
+    // Medidas das fases: --phase-times=arquivo, --time-passes, --mem-stats e --stats-json=arquivo
+    int printTimes = 0;
+    int printMemory = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--phase-times=", 14) == 0) {
+            arquivoTempos = argv[i] + 14;
+        } else if (strcmp(argv[i], "--time-passes") == 0) {
+            printTimes = 1;
+        } else if (strcmp(argv[i], "--mem-stats") == 0) {
+            printMemory = 1;
+        } else if (strncmp(argv[i], "--stats-json=", 13) == 0) {
+            arquivoEstatisticas = argv[i] + 13;
+        }
+    }
+    medirCpu = printTimes || arquivoEstatisticas != NULL;
+    medirMemoria = printMemory || arquivoEstatisticas != NULL;
+    medirFases = medirCpu || medirMemoria || arquivoTempos != NULL;
+    resetPhaseTimes();
+    phaseBegin("compilacao");
+    int result = compileSource(argc, argv);
+    phaseEnd();
+    if (arquivoTempos != NULL && writePhaseTimes(arquivoTempos) == 0) {
+        printInfo("Tempos das fases salvos em %s", arquivoTempos);
+    }
+    if (arquivoEstatisticas != NULL && writePhaseStatsJson(arquivoEstatisticas) == 0) {
+        printInfo("Medidas das fases salvas em %s", arquivoEstatisticas);
+    }
+    printPhaseReport(printTimes, printMemory);
+    return result;
+}
+
+// Volta as opções da linha de comando aos valores padrão
+static void resetOptions(void) {
+    inlineOptions.enabled = 0;
+    inlineOptions.sizeThreshold = INLINE_DEFAULT_THRESHOLD;
+    inlineOptions.singleThreshold = INLINE_DEFAULT_SINGLE_THRESHOLD;
+    inlineOptions.maxLocals = INLINE_DEFAULT_MAX_LOCALS;
+    inlineOptions.report = 0;
+    modoDispatcher = 0;
+    desvioLongo = 1;
+    peepholeEnabled = 1;
+    divisaoPorDeslocamento = 0;
+    gerarObjeto = 0;
+    nomeObjeto = NULL;
+    cacheFuncoes = 0;
+    formatoSaida = OUT_BITS;
+    enderecoBase = 0;
+    profundidadeMif = 0;
+    simularPrograma = 0;
+    memoriaSimulador = SIM_DEFAULT_MEMORY;
+    passosSimulador = SIM_DEFAULT_MAX_STEPS;
+    entradaSimulador = NULL;
+    custosSimulador = NULL;
+    gravarMetricas = 0;
+    tamanhoSlot = 0;
+    instrumentarBlocos = 0;
+    baseContadores = PROFILE_DEFAULT_BASE;
+    arquivoPerfil = NULL;
+    resetArtifactOptions();
+    arquivoTempos = NULL;
+    arquivoEstatisticas = NULL;
+    medirFases = 0;
+    medirCpu = 0;
+    medirMemoria = 0;
+}
+
+// Estado que cada módulo guarda de um programa para o outro
+static void resetCompilerState(void) {
+    lexErrorCount = 0;
+    syntaxErrorCount = 0;
+    root = NULL;
+    yylineno = 1;
+    st_reset();
+    resetSemanticState();
+    freeIRCode();
+    initIRCode();
+    resetFunctionCacheStats();
+    resetProfileState();
+    resetOptions();
+}
+
+// Compila um programa do lote, lendo do arquivo em vez de stdin
+static int compileBatchEntry(const BatchEntry* entry) {
+    FILE* input = fopen(entry->source, "r");
+    if (input == NULL) {
+        printError("Erro: não foi possível abrir '%s' (linha %d da lista).", entry->source, entry->lineNumber);
+        return 1;
+    }
+    resetCompilerState();
+    diretorioSaida = entry->dir;
+    arquivoFonte = entry->source;
+    yyrestart(input);
+    int result = compileProgram(entry->argCount, (char**)entry->args);
+    fclose(input);
+    diretorioSaida = OUTPUT_DEFAULT_DIR;
+    arquivoFonte = DIAG_STDIN_NAME;
+    return result;
+}
+
+// --trace=categorias e --trace-file=arquivo valem para o processo inteiro
+static int parseTraceOptions(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--trace=", 8) == 0) {
+            if (parseTraceCategories(argv[i] + 8) != 0) {
+                return -1;
+            }
+            if (!TRACE_BUILD) {
+                printWarning("Aviso: --trace só tem efeito no executável de 'make debug'.");
+            }
+        } else if (strncmp(argv[i], "--trace-file=", 13) == 0) {
+            if (openTraceFile(argv[i] + 13) != 0) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+// -q e --diagnostics=text|json valem para o processo inteiro
+static int parseDiagnosticOptions(int argc, char *argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
+            modoSilencioso = 1;
+        } else if (strcmp(argv[i], "--diagnostics=json") == 0) {
+            diagnosticosJson = 1;
+        } else if (strcmp(argv[i], "--diagnostics=text") == 0) {
+            diagnosticosJson = 0;
+        } else if (strncmp(argv[i], "--diagnostics=", 14) == 0) {
+            printError("Formato de diagnóstico desconhecido: '%s' (use text ou json).", argv[i] + 14);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    if (parseDiagnosticOptions(argc, argv) != 0) {
+        return 1;
+    }
+    initDiagnostics();
+    if (parseTraceOptions(argc, argv) != 0) {
+        return 1;
+    }
+
+    // -o -: a imagem vai para a saída padrão, e as mensagens para stderr
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            for (int j = 1; j < argc; j++) {
+                if (strncmp(argv[j], "--batch=", 8) == 0 || strncmp(argv[j], "--bench=", 8) == 0) {
+                    printError("Erro: -o não vale com %.7s (cada programa do lote tem o seu diretório).", argv[j]);
+                    return 1;
+                }
+            }
+            if (strcmp(argv[i + 1], OUTPUT_STDOUT) == 0 && reserveStdoutForImage() != 0) {
+                printError("Erro: não foi possível reservar a saída padrão para a imagem.");
+                return 1;
+            }
+        }
+    }
+
+    // --link=script: só liga objetos já gerados com -c, sem ler código-fonte
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--link=", 7) == 0) {
+            if (parseOutputOptions(argc, argv) != 0 || parseArtifactOptions(argc, argv) != 0) {
+                return 1;
+            }
+            return linkObjects(argv[i] + 7) == 0 ? 0 : 1;
+        }
+    }
+
+    // --sim=arquivo: só simula um assembly (.asm) ou uma imagem binary.txt já gerada
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--sim=", 6) == 0) {
+            if (parseSimulatorOptions(argc, argv) != 0) {
+                return 1;
+            }
+            return simulateFile(argv[i] + 6) == 0 ? 0 : 1;
+        }
+    }
+
+    // --batch=lista: vários programas, cada um no seu diretório de saída;
+    // -j N compila até N deles ao mesmo tempo
+    for (int i = 1; i < argc;) {
+        int consumed = parseJobsOption(argc, argv, i);
+        i += consumed > 0 ? consumed : 1;
+    }
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--batch=", 8) == 0) {
+            return runBatch(argv[i] + 8, argc, argv, compileBatchEntry);
+        }
+        if (strncmp(argv[i], "--bench=", 8) == 0) {
+            // lote com --metrics, comparado com a linha de base
+            return runBench(argv[i] + 8, argc, argv, compileBatchEntry);
+        }
+    }
+
+    // Fora do lote, -j N divide as funções do programa entre N processos
+    funcoesParalelas = tarefasParalelas;
+    return compileProgram(argc, argv);
+}
@@ -0,0 +1,530 @@
+#include "metricas.h"
+#include "formato_saida.h"
+
+int gravarMetricas = 0;
+int tamanhoSlot = 0;
+
+#define METRICS_LINE_SIZE 65536 // um programa por linha no resultado do benchmark
+
+// Métricas comparadas com a linha de base, na ordem em que são gravadas
+static const char* metricKeys[] = {"instrucoes", "acessos_memoria", "desvios", "saltos", "pilha", NULL};
+
+static int metricValue(const CodeMetrics* metrics, int key) {
+    switch (key) {
+        case 0: return metrics->instructions;
+        case 1: return metrics->memoryOps;
+        case 2: return metrics->branches;
+        case 3: return metrics->jumps;
+        default: return metrics->stack;
+    }
+}
+
+static int isRegister(const MachineInstr* instr, const char* mnemonic, int rt, int rs) {
+    return strcmp(instr->info->mnemonic, mnemonic) == 0 && instr->regs[0] == rt && instr->regs[1] == rs;
+}
+
+// Percorre o código uma vez; cada rótulo de função abre um novo trecho. A pilha é
+// acompanhada em linha reta: subi/addi em r1 e fp = sp / sp = fp. Com calls != NULL
+// também guarda os saltos para rótulos (na ordem dos trechos), com a pilha naquele
+// ponto; quais deles vão para uma função só se sabe no fim.
+static CodeMetrics* collectMetrics(const MachineCode* code, int* functionCount, CallSite** calls, int* callCount) {
+    int capacity = 16;
+    int count = 1;
+    int callCapacity = 0;
+    CodeMetrics* functions = calloc(capacity, sizeof(CodeMetrics));
+    functions[0].name = METRICS_START_FUNCTION;
+    CodeMetrics* current = &functions[0];
+    int depth = 0;
+    int frameDepth = 0;
+
+    for (int i = 0; i < code->count; i++) {
+        const MachineInstr* instr = &code->items[i];
+        if (instr->label != NULL && instr->isFunction) {
+            if (count == capacity) {
+                capacity *= 2;
+                functions = realloc(functions, capacity * sizeof(CodeMetrics));
+            }
+            current = &functions[count++];
+            memset(current, 0, sizeof(CodeMetrics));
+            current->name = instr->label;
+            current->first = i;
+            depth = 0;
+            frameDepth = 0;
+        }
+        if (instr->info == NULL) {
+            continue;
+        }
+
+        current->instructions++;
+        switch (instr->info->format) {
+            case FMT_MEM:
+                current->memoryOps++;
+                break;
+            case FMT_BRANCH:
+            case FMT_BRANCH_REL:
+                current->branches++;
+                break;
+            case FMT_JUMP:
+            case FMT_JR:
+                current->jumps++;
+                break;
+            default:
+                break;
+        }
+        if (calls != NULL && instr->info->format == FMT_JUMP && instr->symbol != NULL) {
+            if (*callCount == callCapacity) {
+                callCapacity = callCapacity ? callCapacity * 2 : 64;
+                *calls = realloc(*calls, callCapacity * sizeof(CallSite));
+            }
+            CallSite* call = &(*calls)[(*callCount)++];
+            call->caller = count - 1;
+            call->callee = instr->symbol;
+            call->depth = depth;
+        }
+
+        if (isRegister(instr, "subi", 1, 1)) {
+            depth += instr->imm;
+        } else if (isRegister(instr, "addi", 1, 1)) {
+            depth -= instr->imm;
+        } else if (isRegister(instr, "move", 2, 1)) {
+            frameDepth = depth;
+        } else if (isRegister(instr, "move", 1, 2)) {
+            depth = frameDepth;
+        }
+        if (depth > current->stack) {
+            current->stack = depth;
+        }
+    }
+    *functionCount = count;
+    return functions;
+}
+
+static void writeMetricsObject(FILE* file, const CodeMetrics* metrics) {
+    for (int key = 0; metricKeys[key] != NULL; key++) {
+        fprintf(file, "%s\"%s\": %d", key > 0 ? ", " : "", metricKeys[key], metricValue(metrics, key));
+    }
+}
+
+int writeProgramMetrics(const MachineCode* code) {
+    int functionCount = 0;
+    CodeMetrics* functions = collectMetrics(code, &functionCount, NULL, NULL);
+    CodeMetrics total = {NULL, 0, 0, 0, 0, 0, 0};
+    for (int i = 0; i < functionCount; i++) {
+        total.instructions += functions[i].instructions;
+        total.memoryOps += functions[i].memoryOps;
+        total.branches += functions[i].branches;
+        total.jumps += functions[i].jumps;
+        total.stack += functions[i].stack; // soma dos quadros
+    }
+
+    char path[OUTPUT_PATH_SIZE];
+    outputPath(path, sizeof(path), METRICS_FILE);
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printError("Erro ao abrir %s.", path);
+        free(functions);
+        return -1;
+    }
+    // Uma linha só: o benchmark junta os programas copiando as linhas
+    fprintf(file, "{");
+    writeMetricsObject(file, &total);
+    fprintf(file, ", \"funcoes\": [");
+    for (int i = 0; i < functionCount; i++) {
+        fprintf(file, "%s{\"nome\": \"%s\", ", i > 0 ? ", " : "", functions[i].name);
+        writeMetricsObject(file, &functions[i]);
+        fprintf(file, "}");
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+    free(functions);
+    printInfo("Métricas salvas em %s (%d instruções, %d função(ões))", path, total.instructions, functionCount - 1);
+    return 0;
+}
+
+/* ---------- mapa das funções (--emit-map) ---------- */
+
+#define STACK_RECURSIVE -1  // a função está num ciclo do grafo de chamadas: pilha sem limite
+
+typedef struct {
+    const char* name;
+    int index;
+} FunctionName;
+
+static int compareFunctionNames(const void* a, const void* b) {
+    return strcmp(((const FunctionName*)a)->name, ((const FunctionName*)b)->name);
+}
+
+static int findFunctionIndex(const FunctionName* names, int count, const char* name) {
+    FunctionName key = {name, 0};
+    const FunctionName* found = bsearch(&key, names, count, sizeof(FunctionName), compareFunctionNames);
+    return found != NULL ? found->index : -1;
+}
+
+typedef struct {
+    const CodeMetrics* functions;
+    const CallSite* calls;
+    const int* firstCall;   // chamadas do trecho f: [firstCall[f], firstCall[f + 1])
+    const int* callee;      // trecho chamado em cada chamada (-1: rótulo que não é de função)
+    int* maxStack;
+    char* state;            // 0 não visitado, 1 na pilha da busca, 2 calculado
+} StackSearch;
+
+// Pilha máxima do trecho f: o próprio quadro ou, em cada chamada, a pilha do
+// chamador ali mais a máxima da função chamada
+static int maxStackDepth(StackSearch* search, int f) {
+    if (search->state[f] == 1) {
+        return STACK_RECURSIVE;
+    }
+    if (search->state[f] == 2) {
+        return search->maxStack[f];
+    }
+    search->state[f] = 1;
+    int result = search->functions[f].stack;
+    for (int c = search->firstCall[f]; c < search->firstCall[f + 1]; c++) {
+        if (search->callee[c] < 0) {
+            continue;
+        }
+        int callee = maxStackDepth(search, search->callee[c]);
+        if (callee == STACK_RECURSIVE) {
+            result = STACK_RECURSIVE;
+            break;
+        }
+        if (search->calls[c].depth + callee > result) {
+            result = search->calls[c].depth + callee;
+        }
+    }
+    search->state[f] = 2;
+    search->maxStack[f] = result;
+    return result;
+}
+
+int writeFunctionMap(const MachineCode* code, const int* addresses, int imageSize, const char* path) {
+    int functionCount = 0;
+    int callCount = 0;
+    CallSite* calls = NULL;
+    CodeMetrics* functions = collectMetrics(code, &functionCount, &calls, &callCount);
+
+    FunctionName* names = malloc(functionCount * sizeof(FunctionName));
+    for (int f = 0; f < functionCount; f++) {
+        names[f].name = functions[f].name;
+        names[f].index = f;
+    }
+    qsort(names, functionCount, sizeof(FunctionName), compareFunctionNames);
+
+    int* firstCall = calloc(functionCount + 1, sizeof(int));
+    int* callee = malloc((callCount + 1) * sizeof(int));
+    for (int c = 0, f = 0; f <= functionCount; f++) {
+        while (c < callCount && calls[c].caller < f) {
+            c++;
+        }
+        firstCall[f] = c;
+    }
+    for (int c = 0; c < callCount; c++) {
+        callee[c] = findFunctionIndex(names, functionCount, calls[c].callee);
+    }
+    StackSearch search = {functions, calls, firstCall, callee, calloc(functionCount, sizeof(int)),
+                          calloc(functionCount, 1)};
+
+    int result = 0;
+    OutputBuffer* out = openOutputBuffer(path, 0);
+    if (out == NULL) {
+        printError("Erro ao abrir %s.", path);
+        result = -1;
+    } else {
+        bufferPrintf(out, "Mapa de funções de %s (%d palavras)\n\n", arquivoFonte, imageSize);
+        // Larguras em bytes: os acentos do cabeçalho ocupam dois
+        bufferPrintf(out, "%-26s %9s %8s %8s %8s %11s  %s\n", "Função", "Início", "Fim", "Palavras", "Quadro",
+                     "Pilha máx.", "Chama");
+        for (int f = 0; f < functionCount; f++) {
+            int start = addresses[functions[f].first];
+            int end = f + 1 < functionCount ? addresses[functions[f + 1].first] : imageSize;
+            if (f == 0 && end == start) {
+                continue;  // nada antes da primeira função (dispatcher)
+            }
+            char stack[16];
+            int depth = maxStackDepth(&search, f);
+            if (depth == STACK_RECURSIVE) {
+                strcpy(stack, "recursiva");
+            } else {
+                snprintf(stack, sizeof(stack), "%d", depth);
+            }
+            bufferPrintf(out, "%-24s %8d %8d %8d %8d %10s", functions[f].name, start, end - 1, end - start,
+                         functions[f].stack, stack);
+            // Funções chamadas, cada uma uma vez
+            const char* separator = "  ";
+            for (int c = firstCall[f]; c < firstCall[f + 1]; c++) {
+                int repeated = callee[c] < 0;
+                for (int k = firstCall[f]; k < c && !repeated; k++) {
+                    repeated = callee[k] == callee[c];
+                }
+                if (!repeated) {
+                    bufferPrintf(out, "%s%s", separator, functions[callee[c]].name);
+                    separator = " ";
+                }
+            }
+            bufferPrintf(out, "\n");
+        }
+
+        int programStack = maxStackDepth(&search, 0);
+        bufferPrintf(out, "\nTotal: %d palavras\n", imageSize);
+        if (programStack == STACK_RECURSIVE) {
+            bufferPrintf(out, "Pilha máxima do programa: sem limite (há recursão)\n");
+        } else {
+            bufferPrintf(out, "Pilha máxima do programa: %d palavras\n", programStack);
+        }
+        if (tamanhoSlot > 0) {
+            bufferPrintf(out, "Slot: %d palavras, %s %d\n", tamanhoSlot,
+                         imageSize <= tamanhoSlot ? "livres" : "AVISO: excede em", abs(tamanhoSlot - imageSize));
+        }
+        if (closeOutputBuffer(out) != 0) {
+            printError("Erro ao gravar %s.", path);
+            result = -1;
+        } else {
+            printInfo("Mapa de funções salvo em %s", path);
+        }
+    }
+
+    free(search.maxStack);
+    free(search.state);
+    free(callee);
+    free(firstCall);
+    free(names);
+    free(calls);
+    free(functions);
+    return result;
+}
+
+void checkSlotSize(int imageSize) {
+    if (tamanhoSlot > 0 && imageSize > tamanhoSlot) {
+        printWarning("Aviso: a imagem tem %d palavras e passa %d do slot de %d palavras (--slot-size).",
+                     imageSize, imageSize - tamanhoSlot, tamanhoSlot);
+    }
+}
+
+// Valor de "chave": N dentro do trecho [text, end)
+static int jsonInt(const char* text, const char* end, const char* key, int* value) {
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+    const char* found = strstr(text, pattern);
+    if (found == NULL || (end != NULL && found >= end)) {
+        return -1;
+    }
+    *value = atoi(found + strlen(pattern));
+    return 0;
+}
+
+// Linha do programa no resultado do benchmark (ou na linha de base)
+static const char* findProgram(char** lines, int count, const char* program) {
+    char pattern[OUTPUT_PATH_SIZE + 32];
+    snprintf(pattern, sizeof(pattern), "{\"programa\": \"%s\"", program);
+    for (int i = 0; i < count; i++) {
+        if (strstr(lines[i], pattern) != NULL) {
+            return lines[i];
+        }
+    }
+    return NULL;
+}
+
+// Trecho [início, fim) das métricas da função dentro da linha do programa
+static const char* findFunction(const char* line, const char* name, const char** end) {
+    char pattern[256];
+    snprintf(pattern, sizeof(pattern), "{\"nome\": \"%s\"", name);
+    const char* start = strstr(line, pattern);
+    if (start != NULL) {
+        *end = strchr(start, '}');
+    }
+    return start;
+}
+
+static int exceedsTolerance(int base, int current, double tolerance) {
+    return current > base && (base == 0 || (current - base) * 100.0 / base > tolerance);
+}
+
+// Compara um trecho (programa ou função) com a linha de base; devolve quantas métricas pioraram
+static int compareMetrics(const char* label, const char* base, const char* baseEnd, const char* current,
+                          const char* currentEnd, double tolerance) {
+    int regressions = 0;
+    for (int key = 0; metricKeys[key] != NULL; key++) {
+        int before, after;
+        if (jsonInt(base, baseEnd, metricKeys[key], &before) != 0 ||
+            jsonInt(current, currentEnd, metricKeys[key], &after) != 0 || before == after) {
+            continue;
+        }
+        if (exceedsTolerance(before, after, tolerance)) {
+            printError("  %-8s %-40s %-16s %6d -> %6d", "piorou", label, metricKeys[key], before, after);
+            regressions++;
+        } else {
+            printf("  %-8s %-40s %-16s %6d -> %6d\n", after < before ? "melhorou" : "variou", label,
+                   metricKeys[key], before, after);
+        }
+    }
+    return regressions;
+}
+
+static int compareProgram(const char* program, const char* base, const char* current, double tolerance) {
+    const char* baseFunctions = strstr(base, "\"funcoes\"");
+    const char* currentFunctions = strstr(current, "\"funcoes\"");
+    int regressions = compareMetrics(program, base, baseFunctions, current, currentFunctions, tolerance);
+
+    // Funções presentes nas duas versões
+    const char* cursor = currentFunctions;
+    while (cursor != NULL && (cursor = strstr(cursor, "{\"nome\": \"")) != NULL) {
+        char name[256];
+        if (sscanf(cursor, "{\"nome\": \"%255[^\"]\"", name) != 1) {
+            break;
+        }
+        const char* currentEnd = strchr(cursor, '}');
+        const char* baseEnd = NULL;
+        const char* baseStart = findFunction(baseFunctions != NULL ? baseFunctions : base, name, &baseEnd);
+        if (baseStart != NULL) {
+            char label[OUTPUT_PATH_SIZE + 256];
+            snprintf(label, sizeof(label), "%s:%s", program, name);
+            regressions += compareMetrics(label, baseStart, baseEnd, cursor, currentEnd, tolerance);
+        }
+        cursor = currentEnd;
+    }
+    return regressions;
+}
+
+static char** readLines(const char* path, int* count) {
+    FILE* file = fopen(path, "r");
+    *count = 0;
+    if (file == NULL) {
+        return NULL;
+    }
+    char** lines = NULL;
+    char* line = malloc(METRICS_LINE_SIZE);
+    while (fgets(line, METRICS_LINE_SIZE, file) != NULL) {
+        lines = realloc(lines, (*count + 1) * sizeof(char*));
+        lines[(*count)++] = strdup(line);
+    }
+    free(line);
+    fclose(file);
+    return lines;
+}
+
+static void freeLines(char** lines, int count) {
+    for (int i = 0; i < count; i++) {
+        free(lines[i]);
+    }
+    free(lines);
+}
+
+// Junta o metricas.json de cada programa num único arquivo, um programa por linha
+static int writeBenchResult(const BatchEntry* entries, int count) {
+    if (createOutputDirectory("Output/bench") != 0) {
+        printError("Erro: não foi possível criar o diretório de %s.", BENCH_RESULT_FILE);
+        return -1;
+    }
+    FILE* result = fopen(BENCH_RESULT_FILE, "w");
+    if (result == NULL) {
+        printError("Erro ao abrir %s.", BENCH_RESULT_FILE);
+        return -1;
+    }
+    int missing = 0;
+    fprintf(result, "{\"programas\": [\n");
+    for (int i = 0; i < count; i++) {
+        char path[OUTPUT_PATH_SIZE];
+        snprintf(path, sizeof(path), "%s/%s", entries[i].dir, METRICS_FILE);
+        int lineCount = 0;
+        char** lines = readLines(path, &lineCount);
+        if (lineCount == 0) {
+            printError("Erro: %s não tem métricas (%s).", entries[i].source, path);
+            missing++;
+        } else {
+            lines[0][strcspn(lines[0], "\n")] = '\0';
+            fprintf(result, "%s{\"programa\": \"%s\", \"metricas\": %s}", i - missing > 0 ? ",\n" : "",
+                    entries[i].source, lines[0]);
+        }
+        freeLines(lines, lineCount);
+    }
+    fprintf(result, "\n]}\n");
+    fclose(result);
+    return missing;
+}
+
+static int copyFile(const char* from, const char* to) {
+    FILE* input = fopen(from, "r");
+    FILE* output = input != NULL ? fopen(to, "w") : NULL;
+    if (output == NULL) {
+        if (input != NULL) {
+            fclose(input);
+        }
+        return -1;
+    }
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), input)) > 0) {
+        fwrite(buffer, 1, n, output);
+    }
+    fclose(input);
+    return fclose(output) == 0 ? 0 : -1;
+}
+
+int runBench(const char* listPath, int argc, char* argv[], BatchCompiler compile) {
+    const char* baselinePath = BENCH_BASELINE_FILE;
+    double tolerance = 0.0;
+    int update = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--bench-baseline=", 17) == 0) {
+            baselinePath = argv[i] + 17;
+        } else if (strncmp(argv[i], "--bench-tolerance=", 18) == 0) {
+            tolerance = atof(argv[i] + 18);
+        } else if (strcmp(argv[i], "--bench-update") == 0) {
+            update = 1;
+        }
+    }
+
+    int failed = runBatch(listPath, argc, argv, compile);
+    BatchEntry* entries = NULL;
+    int count = 0;
+    if (readBatchList(listPath, argc, argv, &entries, &count) != 0) {
+        return 1;
+    }
+    failed |= writeBenchResult(entries, count) != 0;
+    printInfo("Métricas do benchmark salvas em %s", BENCH_RESULT_FILE);
+
+    if (update) {
+        if (failed || copyFile(BENCH_RESULT_FILE, baselinePath) != 0) {
+            printError("Linha de base não atualizada (%s).", failed ? "houve falhas" : baselinePath);
+            freeBatchList(entries, count);
+            return 1;
+        }
+        printSuccess("Linha de base atualizada em %s\n", baselinePath);
+        freeBatchList(entries, count);
+        return 0;
+    }
+
+    int baseCount = 0;
+    int currentCount = 0;
+    char** base = readLines(baselinePath, &baseCount);
+    char** current = readLines(BENCH_RESULT_FILE, &currentCount);
+    int regressions = 0;
+    if (base == NULL) {
+        printWarning("Aviso: sem linha de base em %s; use --bench-update para criar.", baselinePath);
+    } else {
+        printf("\nComparação com %s (tolerância de %.1f%%):\n", baselinePath, tolerance);
+        for (int i = 0; i < count; i++) {
+            const char* before = findProgram(base, baseCount, entries[i].source);
+            const char* after = findProgram(current, currentCount, entries[i].source);
+            if (before == NULL || after == NULL) {
+                printf("  %-8s %s (sem linha de base)\n", "novo", entries[i].source);
+                continue;
+            }
+            regressions += compareProgram(entries[i].source, strstr(before, "\"metricas\""),
+                                          strstr(after, "\"metricas\""), tolerance);
+        }
+    }
+
+    printf("\n-------------------------------------\n");
+    if (failed || regressions > 0) {
+        printError("Benchmark: %d programa(s), %d métrica(s) piorou(aram)%s.", count, regressions,
+                   failed ? ", com falhas de compilação" : "");
+    } else {
+        printSuccess("Benchmark: %d programa(s), nenhuma métrica piorou.\n", count);
+    }
+    freeLines(base, baseCount);
+    freeLines(current, currentCount);
+    freeBatchList(entries, count);
+    return failed || regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,49 @@
+#ifndef METRICAS_H
+#define METRICAS_H
+
+#include "globals.h"
+#include "codigo_maquina.h"
+#include "lote.h"
+
+#define METRICS_FILE "metricas.json"                 // no diretório de saída do programa
+#define BENCH_BASELINE_FILE "Bench/baseline.json"
+#define BENCH_RESULT_FILE "Output/bench/resultado.json"
+#define METRICS_START_FUNCTION "_inicio"             // código antes da primeira função
+
+// Métricas estáticas de um trecho do código (o programa ou uma função)
+typedef struct {
+    char* name;
+    int instructions;
+    int memoryOps;      // lw, lw2, lw3, sw
+    int branches;       // desvios condicionais
+    int jumps;          // j, jal, jr
+    int stack;          // maior profundidade da pilha (r1) alcançada no trecho, em palavras
+    int first;          // índice no código da primeira entrada do trecho
+} CodeMetrics;
+
+// Chamada (jal, ou j para o rótulo de uma função) e a pilha do chamador naquele ponto
+typedef struct {
+    int caller;         // trecho que chama (índice nas métricas)
+    const char* callee;
+    int depth;
+} CallSite;
+
+extern int gravarMetricas;   // --metrics: grava metricas.json junto com a imagem
+extern int tamanhoSlot;      // --slot-size=N: palavras do slot do processo (0 = não verifica)
+
+// Métricas do código que vai para a montagem, gravadas em <diretório>/metricas.json
+int writeProgramMetrics(const MachineCode* code);
+
+// Mapa das funções do programa montado (--emit-map): início, palavras, quadro e
+// pilha máxima pelo grafo de chamadas. addresses[i] é o endereço da entrada i.
+int writeFunctionMap(const MachineCode* code, const int* addresses, int imageSize, const char* path);
+
+// Avisa se a imagem não cabe no slot de --slot-size
+void checkSlotSize(int imageSize);
+
+// --bench=lista: compila a lista com --metrics, junta as métricas em
+// Output/bench/resultado.json e compara com a linha de base. Devolve 1 se algum
+// programa falhou ou piorou.
+int runBench(const char* listPath, int argc, char* argv[], BatchCompiler compile);
+
+#endif
@@ -280,7 +280,7 @@ arg_list:
 
 void yyerror(const char *s) {
     if(strcmp(s, "syntax error") != 0){
-        printError("Erro sintático na linha %d: %s\n", yylineno, s);
+        diagnostic(DIAG_ERROR, yylineno, "P01", "Erro sintático na linha %d: %s\n", yylineno, s);
         syntaxErrorCount++;
         //exit(2);
     }
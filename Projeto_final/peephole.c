@@ -0,0 +1,237 @@
+#include "peephole.h"
+
+int peepholeEnabled = 1;
+
+/* ---------- informações das instruções ---------- */
+
+static MachineInstr* lineAt(PeepholeList* list, int i) {
+    return &list->code->items[i];
+}
+
+static int isInstruction(PeepholeList* list, int i) {
+    return !list->removed[i] && lineAt(list, i)->info != NULL;
+}
+
+static int hasMnemonic(const MachineInstr* line, const char* mnemonic) {
+    return line->info != NULL && strcmp(line->info->mnemonic, mnemonic) == 0;
+}
+
+static int isBranch(const MachineInstr* line) {
+    return line->info != NULL &&
+           (line->info->format == FMT_BRANCH || line->info->format == FMT_BRANCH_REL);
+}
+
+// Desvia o fluxo ou tem efeitos que o peephole não modela
+static int isControl(const MachineInstr* line) {
+    switch (line->info->format) {
+        case FMT_BRANCH:
+        case FMT_BRANCH_REL:
+        case FMT_JUMP:
+        case FMT_JR:
+        case FMT_SYSCALL:
+        case FMT_HALT:
+            return 1;
+        default:
+            return hasMnemonic(line, "saltoUser");
+    }
+}
+
+static int readsRegister(const MachineInstr* line, int reg) {
+    OperandFormat format = line->info->format;
+    int first = writesFirstRegister(line->info) ? 1 : 0; // registradores a partir daqui são lidos
+    if (format == FMT_LI || format == FMT_IN) {
+        return 0;
+    }
+    for (int k = first; k < formatRegisterCount(format); k++) {
+        if (line->regs[k] == reg) return 1;
+    }
+    return 0;
+}
+
+static int writesRegister(const MachineInstr* line, int reg) {
+    return writesFirstRegister(line->info) && line->regs[0] == reg;
+}
+
+// Temporários (r4-r30) não sobrevivem a um retorno; o resto é tratado como vivo
+// em rótulos e desvios, já que o peephole só olha dentro do bloco
+static int isDeadAfter(PeepholeList* list, int i, int reg) {
+    for (int k = i + 1; k < list->code->count; k++) {
+        MachineInstr* line = lineAt(list, k);
+        if (list->removed[k]) continue;
+        if (line->label != NULL) return 0;
+        if (line->info == NULL) continue;
+        if (readsRegister(line, reg)) return 0;
+        if (writesRegister(line, reg)) return 1;
+        if (line->info->format == FMT_JR) return reg >= 4 && reg <= 30;
+        if (isControl(line)) return 0;
+    }
+    return 0;
+}
+
+// Próxima entrada não removida (rótulo, comentário ou instrução), ou -1
+static int nextLive(PeepholeList* list, int i) {
+    for (int k = i + 1; k < list->code->count; k++) {
+        if (!list->removed[k]) return k;
+    }
+    return -1;
+}
+
+static int prevLive(PeepholeList* list, int i) {
+    for (int k = i - 1; k >= 0; k--) {
+        if (!list->removed[k]) return k;
+    }
+    return -1;
+}
+
+/* ---------- regras ---------- */
+
+// move $rX $rX
+static int ruleSelfMove(PeepholeList* list, int i) {
+    MachineInstr* line = lineAt(list, i);
+    if (line->info->format == FMT_MOVE && line->regs[0] == line->regs[1]) {
+        list->removed[i] = 1;
+        return 1;
+    }
+    return 0;
+}
+
+// li/lw/add... $rT ...; move $rD $rT  (rT morto depois)  ->  li/lw/add... $rD ...
+static int ruleDefThenMove(PeepholeList* list, int i) {
+    MachineInstr* def = lineAt(list, i);
+    if (!writesFirstRegister(def->info)) return 0;
+    int temp = def->regs[0];
+    if (temp < 4 || temp > 30) return 0;
+
+    int j = nextLive(list, i);
+    if (j < 0) return 0;
+    MachineInstr* move = lineAt(list, j);
+    if (move->label != NULL || move->info == NULL || move->info->format != FMT_MOVE) return 0;
+    if (move->regs[1] != temp || move->regs[0] == temp) return 0;
+    if (!isDeadAfter(list, j, temp)) return 0;
+
+    def->regs[0] = move->regs[0];
+    if (move->comment != NULL) {
+        free(def->comment);
+        def->comment = move->comment;
+        move->comment = NULL;
+    }
+    list->removed[j] = 1;
+    return 1;
+}
+
+// j L / bxx ... L seguido do próprio L (e o addil que carregava L em r43)
+static int ruleJumpToNext(PeepholeList* list, int i) {
+    MachineInstr* jump = lineAt(list, i);
+    if ((!hasMnemonic(jump, "j") && !isBranch(jump)) || jump->symbol == NULL) return 0;
+    const char* target = jump->symbol;
+
+    int found = 0;
+    for (int k = nextLive(list, i); k >= 0; k = nextLive(list, k)) {
+        MachineInstr* line = lineAt(list, k);
+        if (line->label != NULL && strcmp(line->label, target) == 0) found = 1;
+        if (line->info != NULL || found) break;
+    }
+    if (!found) return 0;
+
+    list->removed[i] = 1;
+    int p = prevLive(list, i);
+    if (p >= 0 && hasMnemonic(lineAt(list, p), "addil") && lineAt(list, p)->symbol != NULL &&
+        strcmp(lineAt(list, p)->symbol, target) == 0) {
+        list->removed[p] = 1;
+    }
+    return 1;
+}
+
+// sw $rX off($rA); lw $rY off($rA)  ->  sw $rX off($rA); move $rY $rX
+static int ruleStoreLoad(PeepholeList* list, int i) {
+    MachineInstr* store = lineAt(list, i);
+    if (!hasMnemonic(store, "sw")) return 0;
+    int j = nextLive(list, i);
+    if (j < 0) return 0;
+    MachineInstr* load = lineAt(list, j);
+    if (load->label != NULL || !hasMnemonic(load, "lw")) return 0;
+    if (store->imm != load->imm || store->regs[1] != load->regs[1]) return 0;
+
+    if (load->regs[0] == store->regs[0]) {
+        list->removed[j] = 1;
+    } else {
+        load->info = findInstruction("move");
+        load->regs[1] = store->regs[0];
+        load->imm = 0;
+    }
+    return 1;
+}
+
+// instruções depois de j/jr até o próximo rótulo
+static int ruleUnreachable(PeepholeList* list, int i) {
+    MachineInstr* jump = lineAt(list, i);
+    if (!hasMnemonic(jump, "j") && jump->info->format != FMT_JR) return 0;
+    int changed = 0;
+    for (int k = nextLive(list, i); k >= 0 && lineAt(list, k)->label == NULL; k = nextLive(list, k)) {
+        if (lineAt(list, k)->info != NULL) {
+            list->removed[k] = 1;
+            changed = 1;
+        }
+    }
+    return changed;
+}
+
+static PeepholeRule peepholeRules[] = {
+    {"move redundante", ruleSelfMove, 0},
+    {"definição de temporário + move", ruleDefThenMove, 0},
+    {"salto para o rótulo seguinte", ruleJumpToNext, 0},
+    {"sw seguido de lw do mesmo endereço", ruleStoreLoad, 0},
+    {"código inalcançável", ruleUnreachable, 0},
+    {NULL, NULL, 0}
+};
+
+/* ---------- passagem ---------- */
+
+static void runPeephole(PeepholeList* list) {
+    int changed;
+    do {
+        changed = 0;
+        for (int r = 0; peepholeRules[r].name != NULL; r++) {
+            for (int i = 0; i < list->code->count; i++) {
+                if (isInstruction(list, i) && peepholeRules[r].apply(list, i)) {
+                    peepholeRules[r].hits++;
+                    changed = 1;
+                }
+            }
+        }
+    } while (changed);
+}
+
+int peepholeOptimize(MachineCode* code) {
+    PeepholeList list = {code, calloc(code->count + 1, 1)};
+
+    int before = 0;
+    for (int i = 0; i < code->count; i++) {
+        if (code->items[i].info != NULL) before++;
+    }
+
+    for (int r = 0; peepholeRules[r].name != NULL; r++) {
+        peepholeRules[r].hits = 0;
+    }
+    runPeephole(&list);
+
+    // Compacta a sequência, descartando as entradas removidas
+    int after = 0;
+    int kept = 0;
+    for (int i = 0; i < code->count; i++) {
+        if (list.removed[i]) {
+            freeMachineInstr(&code->items[i]);
+            continue;
+        }
+        code->items[kept++] = code->items[i];
+        if (code->items[i].info != NULL) after++;
+    }
+    code->count = kept;
+    free(list.removed);
+
+    printInfo("\nPeephole: %d -> %d instruções", before, after);
+    for (int r = 0; peepholeRules[r].name != NULL; r++) {
+        printInfo("  %s: %d", peepholeRules[r].name, peepholeRules[r].hits);
+    }
+    return before - after;
+}
@@ -0,0 +1,26 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "globals.h"
+#include "codigo_maquina.h"
+
+// Código sob otimização: as regras só marcam entradas como removidas e a
+// sequência é compactada no fim
+typedef struct {
+    MachineCode* code;
+    char* removed;      // 1 se a regra apagou a entrada
+} PeepholeList;
+
+// Regra do peephole: tenta casar o padrão a partir da entrada i e devolve 1 se reescreveu algo
+typedef struct {
+    const char* name;
+    int (*apply)(PeepholeList* list, int i);
+    int hits;
+} PeepholeRule;
+
+extern int peepholeEnabled; // --no-peephole desativa
+
+// Otimiza o código de máquina gerado pelo backend, no lugar
+int peepholeOptimize(MachineCode* code);
+
+#endif
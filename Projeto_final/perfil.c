@@ -0,0 +1,530 @@
+#include "perfil.h"
+#include "assembly_mips.h"
+#include "formato_saida.h"
+#include "tempo_fases.h"
+
+int instrumentarBlocos = 0;
+int baseContadores = PROFILE_DEFAULT_BASE;
+const char* arquivoPerfil = NULL;
+
+// Uma linha do perfil: execuções de um bloco
+typedef struct {
+    char* function;
+    char* block;
+    long long count;
+} ProfileEntry;
+
+// Contador inserido pelo --instrument, no endereço baseContadores + índice
+typedef struct {
+    char* function;
+    char* block;
+} ProfileCounter;
+
+// Início de um bloco: o bloco começa logo depois da quádrupla 'after'
+typedef struct {
+    const char* function;
+    char block[PROFILE_MAX_BLOCK];
+    Quadruple* after;
+} BlockStart;
+
+static ProfileEntry* perfil = NULL;  // ordenado por função e bloco
+static int perfilCount = 0;
+static int perfilCarregado = 0;
+static long long perfilMaximo = 0;
+
+static ProfileCounter* contadores = NULL;
+static int contadorCount = 0;
+
+// Rótulo original de cada rótulo Ln criado pelo inline, indexado por n
+typedef struct {
+    char* function;
+    char* label;
+} LabelAlias;
+
+static LabelAlias* aliases = NULL;
+static int aliasCapacity = 0;
+
+static int compareEntries(const void* a, const void* b) {
+    const ProfileEntry* x = a;
+    const ProfileEntry* y = b;
+    int byFunction = strcmp(x->function, y->function);
+    return byFunction != 0 ? byFunction : strcmp(x->block, y->block);
+}
+
+static void freeProfile(void) {
+    for (int i = 0; i < aliasCapacity; i++) {
+        free(aliases[i].function);
+        free(aliases[i].label);
+    }
+    free(aliases);
+    aliases = NULL;
+    aliasCapacity = 0;
+    for (int i = 0; i < perfilCount; i++) {
+        free(perfil[i].function);
+        free(perfil[i].block);
+    }
+    free(perfil);
+    perfil = NULL;
+    perfilCount = 0;
+    perfilCarregado = 0;
+    perfilMaximo = 0;
+}
+
+// Linhas "função<TAB>bloco<TAB>contagem" ('#' comenta); o mesmo bloco repetido soma as
+// contagens, então perfis de várias execuções podem ser concatenados
+static int loadProfile(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printError("Erro ao abrir o perfil %s.", path);
+        return -1;
+    }
+    char line[256];
+    int lineNumber = 0;
+    int capacity = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') {
+            continue;
+        }
+        char function[128], block[PROFILE_MAX_BLOCK];
+        long long count;
+        if (sscanf(line, "%127[^\t]\t%31[^\t]\t%lld", function, block, &count) != 3 || count < 0) {
+            printError("Erro: linha %d de %s não é 'função<TAB>bloco<TAB>contagem'.", lineNumber, path);
+            fclose(file);
+            freeProfile();
+            return -1;
+        }
+        if (perfilCount == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 64;
+            perfil = realloc(perfil, capacity * sizeof(ProfileEntry));
+        }
+        perfil[perfilCount].function = strdup(function);
+        perfil[perfilCount].block = strdup(block);
+        perfil[perfilCount].count = count;
+        perfilCount++;
+    }
+    fclose(file);
+
+    qsort(perfil, perfilCount, sizeof(ProfileEntry), compareEntries);
+    int unique = 0;
+    for (int i = 0; i < perfilCount; i++) {
+        if (unique > 0 && compareEntries(&perfil[unique - 1], &perfil[i]) == 0) {
+            perfil[unique - 1].count += perfil[i].count;
+            free(perfil[i].function);
+            free(perfil[i].block);
+            continue;
+        }
+        perfil[unique++] = perfil[i];
+    }
+    perfilCount = unique;
+    for (int i = 0; i < perfilCount; i++) {
+        if (perfil[i].count > perfilMaximo) {
+            perfilMaximo = perfil[i].count;
+        }
+    }
+    perfilCarregado = 1;
+    printInfo("Perfil '%s': %d bloco(s), o mais executado %lld vez(es).", path, perfilCount, perfilMaximo);
+    return 0;
+}
+
+int parseProfileOptions(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--instrument") == 0) {
+            instrumentarBlocos = 1;
+        } else if (strncmp(argv[i], "--instrument=", 13) == 0) {
+            char* end;
+            long base = strtol(argv[i] + 13, &end, 0);
+            if (argv[i][13] == '\0' || *end != '\0' || base < 0 || base > IMEDIATO_MAX) {
+                printError("Endereço inválido para os contadores: '%s' (de 0 a %d).", argv[i] + 13, IMEDIATO_MAX);
+                return -1;
+            }
+            instrumentarBlocos = 1;
+            baseContadores = (int)base;
+        } else if (strncmp(argv[i], "--profile=", 10) == 0) {
+            arquivoPerfil = argv[i] + 10;
+        }
+    }
+    if (arquivoPerfil != NULL) {
+        return loadProfile(arquivoPerfil);
+    }
+    return 0;
+}
+
+int profileLoaded(void) {
+    return perfilCarregado;
+}
+
+long long profileCount(const char* function, const char* block) {
+    if (!perfilCarregado || function == NULL) {
+        return -1;
+    }
+    ProfileEntry key = {(char*)function, (char*)block, 0};
+    ProfileEntry* found = bsearch(&key, perfil, perfilCount, sizeof(ProfileEntry), compareEntries);
+    if (found != NULL) {
+        return found->count;
+    }
+    // Bloco de uma cópia feita pelo inline: conta como o bloco original da função expandida
+    char* suffix;
+    long n = block[0] == 'L' ? strtol(block + 1, &suffix, 10) : -1;
+    if (n < 0 || n >= aliasCapacity || aliases[n].label == NULL || (*suffix != '\0' && strcmp(suffix, "+") != 0)) {
+        return -1;
+    }
+    char original[PROFILE_MAX_BLOCK];
+    snprintf(original, sizeof(original), "%s%s", aliases[n].label, suffix);
+    return profileCount(aliases[n].function, original);
+}
+
+void profileAliasLabel(const char* copy, const char* function, const char* original) {
+    if (!perfilCarregado || copy[0] != 'L') {
+        return;
+    }
+    int n = atoi(copy + 1);
+    if (n >= aliasCapacity) {
+        int capacity = aliasCapacity > 0 ? aliasCapacity : 64;
+        while (capacity <= n) capacity *= 2;
+        aliases = realloc(aliases, capacity * sizeof(LabelAlias));
+        memset(&aliases[aliasCapacity], 0, (capacity - aliasCapacity) * sizeof(LabelAlias));
+        aliasCapacity = capacity;
+    }
+    free(aliases[n].function);
+    free(aliases[n].label);
+    aliases[n].function = strdup(function);
+    aliases[n].label = strdup(original);
+}
+
+int profileIsHot(long long count) {
+    return count > 0 && count * PROFILE_HOT_DIVISOR >= perfilMaximo;
+}
+
+void profileNextBlock(const Quadruple* q, char* block, size_t size) {
+    if (q->op == OP_FUNCTION) {
+        snprintf(block, size, "%s", PROFILE_ENTRY_BLOCK);
+    } else if (q->op == OP_LABEL) {
+        snprintf(block, size, "%s", q->result);
+    } else if (q->op == OP_JUMPFALSE || q->op == OP_JUMPTRUE) {
+        snprintf(block, size, "%s+", q->result);
+    }
+}
+
+// Blocos do programa na ordem do código; a entrada fica depois dos PARAM e ALLOC iniciais
+static BlockStart* collectBlocks(int* count) {
+    BlockStart* blocks = NULL;
+    int capacity = 0;
+    const char* function = NULL;
+    *count = 0;
+    for (Quadruple* q = getIRCode()->head; q != NULL; q = q->next) {
+        Quadruple* after = q;
+        if (q->op == OP_FUNCTION) {
+            function = q->arg1;
+            while (after->next != NULL && (after->next->op == OP_PARAM || after->next->op == OP_ALLOC)) {
+                after = after->next;
+            }
+        } else if (q->op == OP_END) {
+            function = NULL;
+            continue;
+        } else if (function == NULL ||
+                   (q->op != OP_LABEL && q->op != OP_JUMPFALSE && q->op != OP_JUMPTRUE)) {
+            continue;
+        }
+        if (*count == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 64;
+            blocks = memRealloc(blocks, capacity * sizeof(BlockStart));
+        }
+        blocks[*count].function = function;
+        blocks[*count].after = after;
+        profileNextBlock(q, blocks[*count].block, sizeof(blocks[*count].block));
+        (*count)++;
+        q = after;
+    }
+    return blocks;
+}
+
+void checkProfileMatches(void) {
+    if (!perfilCarregado) {
+        return;
+    }
+    int count;
+    BlockStart* blocks = collectBlocks(&count);
+    int found = 0;
+    for (int i = 0; i < count; i++) {
+        found += profileCount(blocks[i].function, blocks[i].block) >= 0;
+    }
+    memFree(blocks);
+    if (found != count || found != perfilCount) {
+        printWarning("Aviso: o perfil %s não corresponde ao programa (%d de %d bloco(s) encontrados, %d no perfil); "
+                     "compilando sem ele.", arquivoPerfil, found, count, perfilCount);
+        freeProfile();
+    }
+}
+
+static Quadruple* newCountQuadruple(int address, int sourceLine) {
+    char text[16];
+    snprintf(text, sizeof(text), "%d", address);
+    Quadruple* quad = memAlloc(sizeof(Quadruple));
+    quad->op = OP_COUNT;
+    quad->arg1 = memStrdup(text);
+    quad->arg2 = NULL;
+    quad->result = NULL;
+    quad->line = 0;
+    quad->sourceLine = sourceLine;
+    quad->next = NULL;
+    return quad;
+}
+
+static void renumberIRCode(void) {
+    IRCode* ir = getIRCode();
+    int line = 1;
+    for (Quadruple* q = ir->head; q != NULL; q = q->next) {
+        q->line = line++;
+        if (q->next == NULL) ir->tail = q;
+    }
+}
+
+static int writeCounterTable(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printError("Erro ao gravar %s.", path);
+        return -1;
+    }
+    fprintf(file, "# Contadores de blocos: %d a partir do endereço %d\n", contadorCount, baseContadores);
+    fprintf(file, "# endereço\tfunção\tbloco\n");
+    for (int i = 0; i < contadorCount; i++) {
+        fprintf(file, "%d\t%s\t%s\n", baseContadores + i, contadores[i].function, contadores[i].block);
+    }
+    fclose(file);
+    return 0;
+}
+
+int instrumentIRCode(void) {
+    int count;
+    BlockStart* blocks = collectBlocks(&count);
+    if (count > 0 && baseContadores + count - 1 > IMEDIATO_MAX) {
+        printError("Erro: %d contador(es) a partir do endereço %d passam do endereço %d alcançável por lw/sw.",
+                   count, baseContadores, IMEDIATO_MAX);
+        memFree(blocks);
+        return -1;
+    }
+    contadores = malloc((count > 0 ? count : 1) * sizeof(ProfileCounter));
+    contadorCount = count;
+    for (int i = 0; i < count; i++) {
+        Quadruple* counter = newCountQuadruple(baseContadores + i, blocks[i].after->sourceLine);
+        counter->next = blocks[i].after->next;
+        blocks[i].after->next = counter;
+        contadores[i].function = strdup(blocks[i].function);
+        contadores[i].block = strdup(blocks[i].block);
+    }
+    memFree(blocks);
+    renumberIRCode();
+
+    printInfo("Instrumentação: %d contador(es) nos endereços %d a %d.", count, baseContadores,
+              baseContadores + count - 1);
+    char path[OUTPUT_PATH_SIZE];
+    if (artifactPath(ART_COUNTERS, path, sizeof(path))) {
+        if (writeCounterTable(path) != 0) {
+            return -1;
+        }
+        printInfo("Tabela dos contadores salva em '%s'.", path);
+    }
+    return 0;
+}
+
+/* ---------- disposição dos blocos pelo perfil ---------- */
+
+// Quádruplas de uma função (entre FUNCTION e END), em vetor para mover blocos inteiros
+typedef struct {
+    Quadruple** items;
+    int count;
+} QuadVector;
+
+static int findLabel(const QuadVector* v, int from, const char* name) {
+    for (int i = from; i < v->count; i++) {
+        if (v->items[i]->op == OP_LABEL && strcmp(v->items[i]->result, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Troca v[first..first+length-1] pelos 'length' itens de 'segment'
+static void replaceRange(QuadVector* v, int first, Quadruple** segment, int length) {
+    memcpy(&v->items[first], segment, length * sizeof(Quadruple*));
+}
+
+// LABEL Lc; cond; JUMPTRUE t Lb; JUMP Le; LABEL Lb; corpo; JUMP Lc; LABEL Le
+// vira JUMP Lc; LABEL Lb; corpo; LABEL Lc; cond; JUMPTRUE t Lb; LABEL Le:
+// cada volta passa a ter só o desvio condicional. Devolve onde recomeçar a busca, ou -1.
+static int rotateLoop(QuadVector* v, int i, const char* function) {
+    Quadruple** q = v->items;
+    if (q[i]->op != OP_JUMPTRUE || i + 3 >= v->count || q[i + 1]->op != OP_JUMP ||
+        q[i + 2]->op != OP_LABEL || strcmp(q[i + 2]->result, q[i]->result) != 0) {
+        return -1;
+    }
+    int end = findLabel(v, i + 3, q[i + 1]->result);
+    if (end < 0 || end - 1 < i + 3 || q[end - 1]->op != OP_JUMP) {
+        return -1;
+    }
+    // A condição é um trecho sem desvios que começa no rótulo de volta do laço
+    int cond = i - 1;
+    while (cond >= 0 && q[cond]->op != OP_LABEL && q[cond]->op != OP_JUMP &&
+           q[cond]->op != OP_JUMPFALSE && q[cond]->op != OP_JUMPTRUE) {
+        cond--;
+    }
+    if (cond < 0 || q[cond]->op != OP_LABEL || strcmp(q[cond]->result, q[end - 1]->result) != 0) {
+        return -1;
+    }
+    if (profileCount(function, q[i + 2]->result) <= 0) {
+        return -1;
+    }
+
+    Quadruple* entryJump = q[i + 1];
+    Quadruple* backJump = q[end - 1];
+    memFree(entryJump->result);
+    entryJump->result = memStrdup(q[cond]->result);
+
+    int length = end - cond;  // um a menos: o JUMP de volta sai
+    Quadruple** segment = memAlloc(length * sizeof(Quadruple*));
+    int n = 0;
+    segment[n++] = entryJump;
+    for (int k = i + 2; k <= end - 2; k++) segment[n++] = q[k];
+    for (int k = cond; k <= i; k++) segment[n++] = q[k];
+    segment[n++] = q[end];
+    replaceRange(v, cond, segment, length);
+    memmove(&q[end], &q[end + 1], (v->count - end - 1) * sizeof(Quadruple*));
+    v->count--;
+    memFree(segment);
+
+    memFree(backJump->arg1);
+    memFree(backJump->arg2);
+    memFree(backJump->result);
+    memFree(backJump);
+    return cond;
+}
+
+// cond; JUMPFALSE t Lf; então; JUMP Le; LABEL Lf; senão; LABEL Le
+// vira cond; JUMPTRUE t Lf; senão; JUMP Le; LABEL Lf; então; LABEL Le
+// quando o então executa mais que o senão: o caminho mais comum segue sem desvio incondicional
+static int swapBranches(QuadVector* v, int i, const char* function) {
+    Quadruple** q = v->items;
+    if (q[i]->op != OP_JUMPFALSE) {
+        return 0;
+    }
+    int elseStart = findLabel(v, i + 1, q[i]->result);
+    if (elseStart < 0 || elseStart - 1 < i + 1 || q[elseStart - 1]->op != OP_JUMP) {
+        return 0;
+    }
+    int end = findLabel(v, elseStart + 1, q[elseStart - 1]->result);
+    if (end < 0 || end == elseStart + 1) {
+        return 0;  // sem senão não há o que trocar
+    }
+    char thenBlock[PROFILE_MAX_BLOCK];
+    profileNextBlock(q[i], thenBlock, sizeof(thenBlock));
+    long long thenCount = profileCount(function, thenBlock);
+    long long elseCount = profileCount(function, q[elseStart]->result);
+    if (thenCount < 0 || elseCount < 0 || thenCount <= elseCount) {
+        return 0;
+    }
+
+    int length = end - (i + 1);
+    Quadruple** segment = memAlloc(length * sizeof(Quadruple*));
+    int n = 0;
+    for (int k = elseStart + 1; k < end; k++) segment[n++] = q[k];
+    segment[n++] = q[elseStart - 1];
+    segment[n++] = q[elseStart];
+    for (int k = i + 1; k <= elseStart - 2; k++) segment[n++] = q[k];
+    replaceRange(v, i + 1, segment, length);
+    memFree(segment);
+    q[i]->op = OP_JUMPTRUE;
+    return 1;
+}
+
+void layoutIRCode(void) {
+    if (!perfilCarregado) {
+        return;
+    }
+    int rotated = 0;
+    int swapped = 0;
+    QuadVector v = {NULL, 0};
+    int capacity = 0;
+
+    for (Quadruple* start = getIRCode()->head; start != NULL; start = start->next) {
+        if (start->op != OP_FUNCTION) {
+            continue;
+        }
+        v.count = 0;
+        Quadruple* end = start->next;
+        for (; end != NULL && end->op != OP_END; end = end->next) {
+            if (v.count == capacity) {
+                capacity = capacity > 0 ? capacity * 2 : 256;
+                v.items = memRealloc(v.items, capacity * sizeof(Quadruple*));
+            }
+            v.items[v.count++] = end;
+        }
+        if (end == NULL) {
+            break;
+        }
+
+        for (int i = 0; i < v.count; i++) {
+            int restart = rotateLoop(&v, i, start->arg1);
+            if (restart >= 0) {
+                rotated++;
+                i = restart;  // o corpo foi para antes da condição e ainda não foi visto
+                continue;
+            }
+            swapped += swapBranches(&v, i, start->arg1);
+        }
+
+        // Religa a lista na ordem nova
+        Quadruple* prev = start;
+        for (int i = 0; i < v.count; i++) {
+            prev->next = v.items[i];
+            prev = v.items[i];
+        }
+        prev->next = end;
+        start = end;
+    }
+    memFree(v.items);
+    renumberIRCode();
+    printInfo("Perfil: %d laço(s) rotacionado(s), %d if/else invertido(s).", rotated, swapped);
+}
+
+int writeProfileFromMemory(const int* memory, int memorySize) {
+    if (contadorCount == 0) {
+        return 0;
+    }
+    if (baseContadores + contadorCount > memorySize) {
+        printError("Erro: os contadores (endereços %d a %d) não cabem na memória do simulador (%d palavras).",
+                   baseContadores, baseContadores + contadorCount - 1, memorySize);
+        return -1;
+    }
+    char path[OUTPUT_PATH_SIZE];
+    outputPath(path, sizeof(path), PROFILE_OUTPUT_FILE);
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printError("Erro ao gravar %s.", path);
+        return -1;
+    }
+    fprintf(file, "# Perfil de blocos: %d contador(es) a partir do endereço %d\n", contadorCount, baseContadores);
+    fprintf(file, "# função\tbloco\tcontagem\n");
+    for (int i = 0; i < contadorCount; i++) {
+        fprintf(file, "%s\t%s\t%d\n", contadores[i].function, contadores[i].block, memory[baseContadores + i]);
+    }
+    fclose(file);
+    printInfo("Perfil salvo em '%s' (use com --profile=%s).", path, path);
+    return 0;
+}
+
+int profileCounterCount(void) {
+    return contadorCount;
+}
+
+void resetProfileState(void) {
+    freeProfile();
+    for (int i = 0; i < contadorCount; i++) {
+        free(contadores[i].function);
+        free(contadores[i].block);
+    }
+    free(contadores);
+    contadores = NULL;
+    contadorCount = 0;
+}
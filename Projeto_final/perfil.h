@@ -0,0 +1,59 @@
+#ifndef PERFIL_H
+#define PERFIL_H
+
+#include "globals.h"
+#include "cinter.h"
+
+#define PROFILE_DEFAULT_BASE 3000          // --instrument: endereço do primeiro contador
+#define PROFILE_OUTPUT_FILE "perfil.txt"   // contagens gravadas pelo --simulate de um programa instrumentado
+#define PROFILE_ENTRY_BLOCK "entrada"      // bloco da entrada da função (depois dos PARAM/ALLOC)
+#define PROFILE_MAX_BLOCK 32               // nome de um bloco: "entrada", "Ln" ou "Ln+"
+#define PROFILE_HOT_DIVISOR 10             // bloco quente: ao menos 1/10 das execuções do bloco mais executado
+#define PROFILE_HOT_INLINE_FACTOR 4        // limite de tamanho do inline multiplicado nas chamadas quentes
+
+// Blocos do perfil: "entrada" no início da função, "Ln" depois do LABEL Ln e "Ln+" na
+// continuação de um desvio condicional para Ln. Os nomes vêm do código intermediário
+// antes do inline, então o programa instrumentado e o compilado com o perfil concordam.
+
+extern int instrumentarBlocos;     // --instrument: conta as execuções de cada bloco
+extern int baseContadores;         // --instrument=endereço
+extern const char* arquivoPerfil;  // --profile=arquivo
+
+// Lê --instrument[=endereço] e --profile=arquivo (e carrega o perfil); -1 se alguma é inválida
+int parseProfileOptions(int argc, char* argv[]);
+
+// Perfil carregado e ainda válido para o programa
+int profileLoaded(void);
+
+// Execuções do bloco segundo o perfil; -1 se não há perfil ou o bloco não está nele
+long long profileCount(const char* function, const char* block);
+
+// Rótulo 'copy' criado pelo inline a partir do rótulo 'original' de 'function': os blocos
+// da cópia usam as contagens da função expandida (somadas sobre todas as chamadas)
+void profileAliasLabel(const char* copy, const char* function, const char* original);
+
+// Bloco executado ao menos 1/PROFILE_HOT_DIVISOR das vezes do bloco mais executado
+int profileIsHot(long long count);
+
+// Bloco em que fica a quádrupla seguinte a q (muda na FUNCTION, num LABEL e depois de um desvio condicional)
+void profileNextBlock(const Quadruple* q, char* block, size_t size);
+
+// Descarta o perfil se os blocos dele não são os do programa (fonte mudou depois da coleta)
+void checkProfileMatches(void);
+
+// --instrument: insere um COUNT no início de cada bloco (e, com --emit-counters, grava contadores.txt); -1 se não cabem
+int instrumentIRCode(void);
+
+// --profile: rotaciona os laços executados e põe a parte mais executada de cada if/else na continuação
+void layoutIRCode(void);
+
+// Depois do --simulate: grava perfil.txt com os contadores lidos da memória de dados
+int writeProfileFromMemory(const int* memory, int memorySize);
+
+// Contadores inseridos na compilação atual (0 sem --instrument)
+int profileCounterCount(void);
+
+// Libera o perfil e a tabela de contadores entre os programas do lote
+void resetProfileState(void);
+
+#endif
@@ -99,7 +99,7 @@ static void checkReturnStatement(ASTNode* node) {
         }
         
         if (!l && !errorAlreadyReported(returnExpr->value, node->lineno)) {
-            printError("Erro semântico: Variável '%s' usada em comando return não foi declarada (linha %d)",
+            diagnostic(DIAG_ERROR, node->lineno, "S01", "Erro semântico: Variável '%s' usada em comando return não foi declarada (linha %d)",
                     returnExpr->value, node->lineno);
             semanticErrorCount++;
         }
@@ -130,17 +130,17 @@ static void checkVariableDeclaration(ASTNode* node) {
     // Verifica se a variável já foi declarada no mesmo escopo
     if (l != NULL) {
         if (strcmp(l->scope, scope) == 0 && l->lines->lineno != node->lineno) {
-            printError("Erro semântico: Variável '%s' já declarada no escopo '%s' (linha %d)",
+            diagnostic(DIAG_ERROR, node->lineno, "S02", "Erro semântico: Variável '%s' já declarada no escopo '%s' (linha %d)",
                     node->value, scope, node->lineno);
             semanticErrorCount++;
         }
         else if (aux != NULL && strcmp(aux->idType, "func") == 0 && strcmp(aux->name, l->name) == 0) {
-            printError("Erro semântico: Variável '%s' declarado com nome de função (linha %d)",
+            diagnostic(DIAG_ERROR, node->lineno, "S03", "Erro semântico: Variável '%s' declarado com nome de função (linha %d)",
                     node->value, node->lineno);
             semanticErrorCount++;
         }
         else if (strcmp(node->idType,"void") == 0) {
-            printError("Erro semântico: Variável '%s' declarada com tipo void (linha %d)",
+            diagnostic(DIAG_ERROR, node->lineno, "S04", "Erro semântico: Variável '%s' declarada com tipo void (linha %d)",
                     node->value, node->lineno);
             semanticErrorCount++;
         }
@@ -148,7 +148,7 @@ static void checkVariableDeclaration(ASTNode* node) {
 
     // Verifica se o tamanho do array é válido (maior que 0)
     if (node->isArray && node->arraySize <= 0) {
-        printError("Erro semântico: Tamanho do array '%s' deve ser positivo (linha %d)",
+        diagnostic(DIAG_ERROR, node->lineno, "S05", "Erro semântico: Tamanho do array '%s' deve ser positivo (linha %d)",
                 node->value, node->lineno);
         semanticErrorCount++;
     }
@@ -171,7 +171,7 @@ static void checkAssignment(ASTNode* node) {
 
     // Conferir a declaração do lado esquerdo
     if (leftType == NULL) {
-        printError("Erro semântico na linha %d: Variável '%s' sendo usada sem ter sido declarada.",
+        diagnostic(DIAG_ERROR, node->lineno, "S01", "Erro semântico na linha %d: Variável '%s' sendo usada sem ter sido declarada.",
                 node->lineno, node->left->value ? node->left->value : "desconhecida");
         semanticErrorCount++;
         return;
@@ -179,7 +179,7 @@ static void checkAssignment(ASTNode* node) {
 
     // Conferir a declaração do lado direito
     if (rightType == NULL) {
-        printError("Erro semântico na linha %d: Expressão ou variável '%s' sendo usada sem ter sido declarada.",
+        diagnostic(DIAG_ERROR, node->lineno, "S01", "Erro semântico na linha %d: Expressão ou variável '%s' sendo usada sem ter sido declarada.",
                 node->lineno, node->right->value ? node->right->value : "desconhecida");
         semanticErrorCount++;
         return;
@@ -187,7 +187,7 @@ static void checkAssignment(ASTNode* node) {
 
     // Checar a compatibilidade de tipos
     if (!checkTypeCompatibility(leftType, rightType)) {
-        printError("Erro semântico na linha %d: Incompatibilidade de tipos na atribuição. "
+        diagnostic(DIAG_ERROR, node->lineno, "S06", "Erro semântico na linha %d: Incompatibilidade de tipos na atribuição. "
                   "Variável '%s' é do tipo '%s' mas está recebendo valor do tipo '%s'.",
                 node->lineno, node->left->value ? node->left->value : "desconhecida",
                 leftType, rightType);
@@ -228,7 +228,7 @@ static void checkFunctionCallParameters(ASTNode* node) {
 
         // Compara argType com declParam->paramType
         if (!checkTypeCompatibility(callParam->paramType, declParam->paramType)) {
-            printError("Erro semântico: Incompatibilidade de tipos no argumento %d da chamada da função '%s'. Esperado '%s%s', recebido '%s%s' (linha %d)",
+            diagnostic(DIAG_ERROR, node->lineno, "S07", "Erro semântico: Incompatibilidade de tipos no argumento %d da chamada da função '%s'. Esperado '%s%s', recebido '%s%s' (linha %d)",
                          argNum, funcName, declParam->paramType, declParam->isArray ? "[]" : "", 
                          callParam->paramType, callParam->isArray ? "[]" : "", node->lineno);
             semanticErrorCount++;
@@ -250,7 +250,7 @@ static void checkFunctionCall(ASTNode* node) {
     // Verifica se a função foi declarada
     if (!l) {
         if (!errorAlreadyReported(node->left->value, node->lineno)) {
-            printError("Erro semântico: Função '%s' não declarada (linha %d)",
+            diagnostic(DIAG_ERROR, node->lineno, "S08", "Erro semântico: Função '%s' não declarada (linha %d)",
                        node->left->value, node->lineno);
             semanticErrorCount++;
         }
@@ -260,7 +260,7 @@ static void checkFunctionCall(ASTNode* node) {
     // Verifica se o identificador é realmente uma função
     if (strcmp(l->idType, "func") != 0) {
         if (!errorAlreadyReported(node->left->value, node->lineno)) {
-            printError("Erro semântico: '%s' não é uma função (linha %d)",
+            diagnostic(DIAG_ERROR, node->lineno, "S09", "Erro semântico: '%s' não é uma função (linha %d)",
                        node->left->value, node->lineno);
             semanticErrorCount++;
         }
@@ -272,7 +272,7 @@ static void checkFunctionCall(ASTNode* node) {
 
 static void checkMainFunction(void) {
     if (!hasMainFunction) {
-        printError("Erro semântico: Função 'main' não declarada.");
+        diagnostic(DIAG_ERROR, 0, "S10", "Erro semântico: Função 'main' não declarada.");
         semanticErrorCount++;
     }
 }
@@ -280,7 +280,7 @@ static void checkMainFunction(void) {
 // Adicionar função para verificar se há pelo menos uma declaração
 static void checkAtLeastOneDeclaration(void) {
     if (!hasDeclaration) {
-        printError("Erro semântico: O código deve conter pelo menos uma declaração (função ou variável).");
+        diagnostic(DIAG_ERROR, 0, "S11", "Erro semântico: O código deve conter pelo menos uma declaração (função ou variável).");
         semanticErrorCount++;
     }
 }
@@ -288,7 +288,7 @@ static void checkAtLeastOneDeclaration(void) {
 // Adicionar função para verificar se a última função é void main(void)
 static void checkLastFunctionIsMain(void) {
     if (lastFunctionNode && strcmp(lastFunctionNode->value, "main") != 0) {
-        printError("Erro semântico: A última declaração de função deve ser 'void main(void)'.");
+        diagnostic(DIAG_ERROR, 0, "S10", "Erro semântico: A última declaração de função deve ser 'void main(void)'.");
         semanticErrorCount++;
     }
 }
@@ -305,14 +305,14 @@ static void checkArrayAccess(ASTNode* node) {
     }
     
     if (!l) {
-        printError("Erro semântico: Variável '%s' não declarada (linha %d)",
+        diagnostic(DIAG_ERROR, node->lineno, "S01", "Erro semântico: Variável '%s' não declarada (linha %d)",
                 node->value, node->lineno);
         semanticErrorCount++;
         return;
     }
 
     if (!l->isArray) {
-        printError("Erro semântico: Variável '%s' não é um array (linha %d)",
+        diagnostic(DIAG_ERROR, node->lineno, "S12", "Erro semântico: Variável '%s' não é um array (linha %d)",
                 node->value, node->lineno);
         semanticErrorCount++;
         return;
@@ -322,7 +322,7 @@ static void checkArrayAccess(ASTNode* node) {
     if (node->right) {
         char* indexType = getExpressionType(node->right);
         if (!indexType || strcmp(indexType, "int") != 0) {
-            printError("Erro semântico: Índice do array deve ser do tipo int (linha %d)",
+            diagnostic(DIAG_ERROR, node->lineno, "S13", "Erro semântico: Índice do array deve ser do tipo int (linha %d)",
                     node->lineno);
             semanticErrorCount++;
         }
@@ -331,12 +331,12 @@ static void checkArrayAccess(ASTNode* node) {
         if (node->right->type == NODE_FACTOR && node->right->value) {
             int index = atoi(node->right->value);
             if (index < 0) {
-                printError("Erro semântico: Índice negativo (%d) no acesso ao array '%s' (linha %d)",
+                diagnostic(DIAG_ERROR, node->lineno, "S14", "Erro semântico: Índice negativo (%d) no acesso ao array '%s' (linha %d)",
                         index, node->value, node->lineno);
                 semanticErrorCount++;
             } 
             else if (l->arraySize > 0 && index >= l->arraySize) {
-                printError("Erro semântico: Índice %d fora dos limites do array '%s[%d]' (linha %d)",
+                diagnostic(DIAG_ERROR, node->lineno, "S14", "Erro semântico: Índice %d fora dos limites do array '%s[%d]' (linha %d)",
                         index, node->value, l->arraySize, node->lineno);
                 semanticErrorCount++;
             }
@@ -358,7 +358,7 @@ static void validateExpressionVariables(ASTNode* expr) {
         }
         
         if (!var && !errorAlreadyReported(expr->value, expr->lineno)) {
-            printError("Erro semântico: Variável '%s' usada em expressão não foi declarada (linha %d)",
+            diagnostic(DIAG_ERROR, expr->lineno, "S01", "Erro semântico: Variável '%s' usada em expressão não foi declarada (linha %d)",
                     expr->value, expr->lineno);
             semanticErrorCount++;
         }
@@ -399,7 +399,7 @@ static char* getExpressionType(ASTNode* node) {
                     // Verifica se o índice é um inteiro
                     char* indexType = getExpressionType(node->right);
                     if (indexType == NULL || strcmp(indexType, "int") != 0) {
-                        printError("Erro semântico: índice do array deve ser inteiro");
+                        diagnostic(DIAG_ERROR, node->lineno, "S13", "Erro semântico: índice do array deve ser inteiro");
                         return NULL;
                     }
                     // Retorna o tipo base do array (sem os colchetes)
@@ -467,6 +467,15 @@ void freeSemanticResources(void) {
     clearErrorTracker();
 }
 
+// Zera o estado da análise para o próximo programa (modo lote)
+void resetSemanticState(void) {
+    clearErrorTracker();
+    semanticErrorCount = 0;
+    hasMainFunction = 0;
+    hasDeclaration = 0;
+    lastFunctionNode = NULL;
+}
+
 // Função principal de análise semântica
 void semanticAnalysis(ASTNode* node) {
     if (node == NULL) {
@@ -487,7 +496,7 @@ void semanticAnalysis(ASTNode* node) {
         case NODE_VAR:
             BucketList existing = st_lookup_all_scopes(node->value, "global");
             if(existing != NULL && strcmp(existing->idType, "func") == 0) {
-                printError("Erro semântico: '%s' é uma função, não uma variável", node->value);
+                diagnostic(DIAG_ERROR, node->lineno, "S15", "Erro semântico: '%s' é uma função, não uma variável", node->value);
                 semanticErrorCount++;
                 return;
             }
@@ -519,7 +528,7 @@ void semanticAnalysis(ASTNode* node) {
                     l = st_lookup_in_scope(node->left->value, "global");
                 }
                 if (!l && !errorAlreadyReported(node->left->value, node->lineno)) {
-                    printError("Erro semântico: Variável '%s' usada em comparação não foi declarada (linha %d)",
+                    diagnostic(DIAG_ERROR, node->lineno, "S01", "Erro semântico: Variável '%s' usada em comparação não foi declarada (linha %d)",
                             node->left->value, node->lineno);
                     semanticErrorCount++;
                 }
@@ -547,7 +556,7 @@ void semanticAnalysis(ASTNode* node) {
                             l = st_lookup_in_scope(node->right->right->value, "global");
                         }
                         if (!l && !errorAlreadyReported(node->right->right->value, node->lineno)) {
-                            printError("Erro semântico: Variável '%s' usada em comparação não foi declarada (linha %d)",
+                            diagnostic(DIAG_ERROR, node->lineno, "S01", "Erro semântico: Variável '%s' usada em comparação não foi declarada (linha %d)",
                                     node->right->right->value, node->lineno);
                             semanticErrorCount++;
                         }
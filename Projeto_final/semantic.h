@@ -9,5 +9,6 @@ extern int semanticErrorCount;
 // Funções para análise semântica
 void semanticAnalysis(ASTNode* node);
 void freeSemanticResources(void);
+void resetSemanticState(void);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,478 @@
+#include "simulador.h"
+#include "binario_proc.h"
+#include "perfil.h"
+
+int simularPrograma = 0;
+int memoriaSimulador = SIM_DEFAULT_MEMORY;
+long long passosSimulador = SIM_DEFAULT_MAX_STEPS;
+const char* entradaSimulador = NULL;
+const char* custosSimulador = NULL;
+
+// Operação das instruções que dividem um formato, resolvida pelo mnemônico na decodificação
+typedef enum {
+    SIM_OP_OTHER,   // o formato já basta
+    SIM_OP_ADDI,
+    SIM_OP_SUBI,
+    SIM_OP_ANDI,
+    SIM_OP_ORI,
+    SIM_OP_LOAD,    // lw, lw2, lw3
+    SIM_OP_STORE,   // sw
+    SIM_OP_BEQ,     // beq/beqr, e os outros desvios
+    SIM_OP_BNQ,
+    SIM_OP_BLT,
+    SIM_OP_BGT,
+    SIM_OP_BGE,
+    SIM_OP_BLE,
+    SIM_OP_J,
+    SIM_OP_JAL,
+    SIM_OP_MSG_LCD,
+    SIM_OP_SALTO_USER
+} SimOperation;
+
+// Palavra da imagem já decodificada, para não refazer a decodificação a cada execução
+typedef struct {
+    const InstructionInfo* info;  // NULL: palavra que não é instrução
+    int index;                    // posição de info na tabela de instruções
+    SimOperation operation;
+    int rs, rt, rd;
+    int imm;                      // imediato com sinal (desvios relativos, addi, lw/sw...)
+    unsigned int uimm;            // imediato sem sinal (endereços absolutos, andi/ori)
+    unsigned int target;          // destino de j/jal
+} SimInstr;
+
+typedef struct {
+    int regs[SIM_REGISTERS];
+    int* memory;
+    int pc;
+    int inputValues[SIM_MAX_INPUTS];
+    int inputCount;
+    int nextInput;
+    int costs[SIM_INSTRUCTIONS];
+    int userTarget;               // destino pedido pelo saltoUser
+    SimStats stats;
+} SimMachine;
+
+int parseSimulatorOptions(int argc, char* argv[]) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--simulate") == 0) {
+            simularPrograma = 1;
+        } else if (strncmp(argv[i], "--sim-memory=", 13) == 0) {
+            memoriaSimulador = atoi(argv[i] + 13);
+            if (memoriaSimulador <= 0) {
+                printError("Tamanho de memória inválido para o simulador: '%s'.", argv[i] + 13);
+                return -1;
+            }
+        } else if (strncmp(argv[i], "--sim-max-steps=", 16) == 0) {
+            passosSimulador = atoll(argv[i] + 16);
+        } else if (strncmp(argv[i], "--sim-input=", 12) == 0) {
+            entradaSimulador = argv[i] + 12;
+        } else if (strncmp(argv[i], "--sim-costs=", 12) == 0) {
+            custosSimulador = argv[i] + 12;
+        }
+    }
+    return 0;
+}
+
+static int signExtend14(unsigned int value) {
+    return (int)(value << 18) >> 18;
+}
+
+static SimOperation resolveOperation(const InstructionInfo* info) {
+    static const struct {
+        const char* mnemonic;  // desvios: só o prefixo, que vale para a forma absoluta e a relativa
+        SimOperation operation;
+    } operations[] = {
+        {"addi", SIM_OP_ADDI}, {"subi", SIM_OP_SUBI}, {"andi", SIM_OP_ANDI}, {"ori", SIM_OP_ORI},
+        {"sw", SIM_OP_STORE}, {"j", SIM_OP_J}, {"jal", SIM_OP_JAL},
+        {"msgLcd", SIM_OP_MSG_LCD}, {"saltoUser", SIM_OP_SALTO_USER},
+        {"beq", SIM_OP_BEQ}, {"bnq", SIM_OP_BNQ}, {"blt", SIM_OP_BLT},
+        {"bgt", SIM_OP_BGT}, {"bge", SIM_OP_BGE}, {"ble", SIM_OP_BLE}
+    };
+    int branch = info->format == FMT_BRANCH || info->format == FMT_BRANCH_REL;
+    for (size_t i = 0; i < sizeof(operations) / sizeof(operations[0]); i++) {
+        if (branch ? strncmp(info->mnemonic, operations[i].mnemonic, 3) == 0
+                   : strcmp(info->mnemonic, operations[i].mnemonic) == 0) {
+            return operations[i].operation;
+        }
+    }
+    return info->format == FMT_MEM ? SIM_OP_LOAD : SIM_OP_OTHER;
+}
+
+static void decodeWord(unsigned int word, SimInstr* instr) {
+    memset(instr, 0, sizeof(SimInstr));
+    instr->info = findInstructionByOpcode(word >> 26, word & 0xF);
+    if (instr->info != NULL) {
+        instr->index = instructionIndex(instr->info);
+        instr->operation = resolveOperation(instr->info);
+    }
+    instr->rs = (word >> 20) & 0x3F;
+    instr->rt = (word >> 14) & 0x3F;
+    instr->rd = (word >> 8) & 0x3F;
+    instr->uimm = word & 0x3FFF;
+    instr->imm = signExtend14(instr->uimm);
+    instr->target = word & 0x3FFFFFF;
+}
+
+// Custo padrão da tabela usada pela seleção de instruções (instructionCost);
+// --sim-costs=arquivo troca o de qualquer instrução, uma linha "mnemônico ciclos"
+static int loadCosts(SimMachine* machine) {
+    for (int i = 0; instructionAt(i) != NULL; i++) {
+        machine->costs[i] = instructionCost(instructionAt(i)->mnemonic);
+    }
+    if (custosSimulador == NULL) {
+        return 0;
+    }
+
+    FILE* file = fopen(custosSimulador, "r");
+    if (file == NULL) {
+        printError("Erro: não foi possível abrir a tabela de custos '%s'.", custosSimulador);
+        return -1;
+    }
+    char line[MAX_LINE_LENGTH];
+    int lineNumber = 0;
+    int errors = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        char mnemonic[32];
+        int cycles;
+        line[strcspn(line, "\r\n")] = '\0';
+        char* start = line + strspn(line, " \t");
+        if (*start == '#' || *start == '\0') {
+            continue;
+        }
+        const InstructionInfo* info = NULL;
+        if (sscanf(start, "%31s %d", mnemonic, &cycles) != 2 || (info = findInstruction(mnemonic)) == NULL ||
+            cycles < 0) {
+            printError("Erro: linha %d da tabela de custos inválida: %s", lineNumber, start);
+            errors++;
+            continue;
+        }
+        machine->costs[instructionIndex(info)] = cycles;
+    }
+    fclose(file);
+    return errors > 0 ? -1 : 0;
+}
+
+static int loadInputs(SimMachine* machine) {
+    if (entradaSimulador == NULL) {
+        return 0;
+    }
+    const char* p = entradaSimulador;
+    while (*p != '\0') {
+        char* end;
+        long value = strtol(p, &end, 0);
+        if (end == p || (*end != ',' && *end != '\0')) {
+            printError("Erro: valor de --sim-input inválido: '%s'.", p);
+            return -1;
+        }
+        if (machine->inputCount == SIM_MAX_INPUTS) {
+            printError("Erro: mais de %d valores em --sim-input.", SIM_MAX_INPUTS);
+            return -1;
+        }
+        machine->inputValues[machine->inputCount++] = (int)value;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return 0;
+}
+
+static int checkAddress(SimMachine* machine, int address) {
+    if (address < 0 || address >= memoriaSimulador) {
+        printError("Erro: acesso à memória fora do limite (endereço %d, PC %d).", address, machine->pc);
+        return 0;
+    }
+    return 1;
+}
+
+// Dispositivos de E/S simulados: in lê de --sim-input (0 quando acabam),
+// out e msgLcd imprimem o valor
+static int readInput(SimMachine* machine) {
+    machine->stats.inputs++;
+    if (machine->nextInput < machine->inputCount) {
+        return machine->inputValues[machine->nextInput++];
+    }
+    if (machine->nextInput++ == machine->inputCount) {
+        printWarning("Aviso: in no endereço %d sem valor em --sim-input; lido 0.", machine->pc);
+    }
+    return 0;
+}
+
+static int branchTaken(SimOperation operation, int a, int b) {
+    switch (operation) {
+        case SIM_OP_BEQ: return a == b;
+        case SIM_OP_BNQ: return a != b;
+        case SIM_OP_BLT: return a < b;
+        case SIM_OP_BGT: return a > b;
+        case SIM_OP_BGE: return a >= b;
+        default: return a <= b; // ble
+    }
+}
+
+// Executa uma instrução; devolve SIM_RUNNING enquanto o programa continua
+static SimStatus step(SimMachine* machine, const SimInstr* instr) {
+    int* r = machine->regs;
+    int next = machine->pc + 1;
+    int address;
+
+    switch (instr->info->format) {
+        case FMT_RRR: {
+            int a = r[instr->rs];
+            int b = r[instr->rt];
+            int value = 0;
+            switch (instr->info->funct) {
+                case 0: value = a & b; break;
+                case 1: value = a | b; break;
+                case 2: value = a + b; break;
+                case 3: value = a - b; break;
+                case 4: value = a * b; break;
+                case 5:
+                    if (b == 0) {
+                        printError("Erro: divisão por zero no endereço %d.", machine->pc);
+                        return SIM_ERROR;
+                    }
+                    value = a / b;
+                    break;
+                case 6: value = a >> (b & 31); break;
+                case 7: value = (int)((unsigned int)a << (b & 31)); break;
+                case 8: value = ~(a | b); break;
+            }
+            r[instr->rd] = value;
+            break;
+        }
+        case FMT_JR:
+            next = r[instr->rt];
+            break;
+        case FMT_RRI:
+            switch (instr->operation) {
+                case SIM_OP_ADDI: r[instr->rt] = r[instr->rs] + instr->imm; break;
+                case SIM_OP_SUBI: r[instr->rt] = r[instr->rs] - instr->imm; break;
+                case SIM_OP_ANDI: r[instr->rt] = r[instr->rs] & (int)instr->uimm; break;
+                default: r[instr->rt] = r[instr->rs] | (int)instr->uimm; break; // ori
+            }
+            break;
+        case FMT_LI:
+            r[instr->rt] = instr->imm;
+            break;
+        case FMT_MEM:
+            // o montador grava o deslocamento multiplicado por 2
+            address = r[instr->rs] + instr->imm / 2;
+            if (!checkAddress(machine, address)) {
+                return SIM_ERROR;
+            }
+            if (instr->operation == SIM_OP_STORE) {
+                machine->memory[address] = r[instr->rt];
+                machine->stats.stores++;
+            } else {
+                r[instr->rt] = machine->memory[address];
+                machine->stats.loads++;
+            }
+            break;
+        case FMT_BRANCH:
+        case FMT_BRANCH_REL:
+            machine->stats.branches++;
+            if (branchTaken(instr->operation, r[instr->rs], r[instr->rt])) {
+                machine->stats.branchesTaken++;
+                next = instr->info->format == FMT_BRANCH ? (int)instr->uimm : machine->pc + instr->imm;
+            }
+            break;
+        case FMT_IN:
+            r[instr->rt] = readInput(machine);
+            break;
+        case FMT_OUT:
+            machine->stats.outputs++;
+            printf("[out] %d\n", r[instr->rs]);
+            break;
+        case FMT_MOVE:
+            r[instr->rt] = r[instr->rs];
+            break;
+        case FMT_ADDIL:
+            r[instr->rt] = r[instr->rs] + (int)instr->uimm;
+            break;
+        case FMT_JUMP:
+            if (instr->operation == SIM_OP_JAL) {
+                r[31] = next;
+            }
+            next = (int)instr->target;
+            break;
+        case FMT_NOP:
+            break;
+        case FMT_HALT:
+            return SIM_HALT;
+        case FMT_REG:
+            if (instr->operation == SIM_OP_MSG_LCD) {
+                machine->stats.outputs++;
+                printf("[lcd] %d\n", r[instr->rs]);
+                break;
+            }
+            machine->userTarget = r[instr->rs];
+            return SIM_SALTO_USER;
+        case FMT_SYSCALL:
+            return SIM_SYSCALL;
+    }
+
+    if (r[1] < machine->stats.minStack) {
+        machine->stats.minStack = r[1];
+    }
+    machine->pc = next;
+    return SIM_RUNNING;
+}
+
+static SimStatus run(SimMachine* machine, const SimInstr* program, int count) {
+    while (machine->stats.instructions < passosSimulador) {
+        if (machine->pc < 0 || machine->pc >= count) {
+            printError("Erro: PC fora da imagem (%d; a imagem tem %d palavras).", machine->pc, count);
+            return SIM_ERROR;
+        }
+        const SimInstr* instr = &program[machine->pc];
+        if (instr->info == NULL) {
+            printError("Erro: palavra inválida no endereço %d.", machine->pc);
+            return SIM_ERROR;
+        }
+        int index = instr->index;
+        machine->stats.executed[index]++;
+        machine->stats.cycles[index] += machine->costs[index];
+        machine->stats.instructions++;
+        machine->stats.totalCycles += machine->costs[index];
+
+        SimStatus status = step(machine, instr);
+        if (status != SIM_RUNNING) {
+            return status;
+        }
+    }
+    return SIM_STEP_LIMIT;
+}
+
+static void printReport(const SimMachine* machine, SimStatus status) {
+    const SimStats* stats = &machine->stats;
+    printf("\n-------------------------------------\n");
+    switch (status) {
+        case SIM_SYSCALL:
+            printf("Simulação: syscall no endereço %d (r51 = %d)\n", machine->pc, machine->regs[51]);
+            break;
+        case SIM_HALT:
+            printf("Simulação: halt no endereço %d\n", machine->pc);
+            break;
+        case SIM_SALTO_USER:
+            printf("Simulação: saltoUser no endereço %d (destino %d)\n", machine->pc, machine->userTarget);
+            break;
+        case SIM_STEP_LIMIT:
+            printf("Simulação interrompida após %lld instruções (--sim-max-steps)\n", stats->instructions);
+            break;
+        default:
+            printf("Simulação interrompida por erro no endereço %d\n", machine->pc);
+            break;
+    }
+    printf("Instruções executadas: %lld\n", stats->instructions);
+    printf("Ciclos: %lld (CPI %.2f)\n", stats->totalCycles,
+           stats->instructions > 0 ? (double)stats->totalCycles / stats->instructions : 0.0);
+    printf("Memória de dados: %lld leitura(s), %lld escrita(s); pilha até %d palavra(s)\n",
+           stats->loads, stats->stores, memoriaSimulador - stats->minStack);
+    printf("Desvios condicionais: %lld (%lld tomado(s))\n", stats->branches, stats->branchesTaken);
+    printf("E/S: %d entrada(s), %d saída(s)\n", stats->inputs, stats->outputs);
+
+    // Instruções da mais executada para a menos
+    int order[SIM_INSTRUCTIONS];
+    int count = 0;
+    for (int i = 0; instructionAt(i) != NULL; i++) {
+        if (stats->executed[i] > 0) {
+            int j = count++;
+            while (j > 0 && stats->executed[order[j - 1]] < stats->executed[i]) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = i;
+        }
+    }
+    printf("%-10s %12s %12s\n", "instrução", "execuções", "ciclos");
+    for (int i = 0; i < count; i++) {
+        printf("%-10s %12lld %12lld\n", instructionAt(order[i])->mnemonic, stats->executed[order[i]],
+               stats->cycles[order[i]]);
+    }
+}
+
+int simulateImage(const unsigned int* image, int count) {
+    SimMachine* machine = calloc(1, sizeof(SimMachine));
+    if (loadCosts(machine) != 0 || loadInputs(machine) != 0) {
+        free(machine);
+        return -1;
+    }
+    machine->memory = calloc(memoriaSimulador, sizeof(int));
+    SimInstr* program = malloc((count + 1) * sizeof(SimInstr));
+    for (int i = 0; i < count; i++) {
+        decodeWord(image[i], &program[i]);
+    }
+
+    // Imagem carregada no endereço 0 (r44 = r39 = 0); a pilha (r1) e o quadro (r2)
+    // começam no fim da memória
+    machine->regs[1] = memoriaSimulador;
+    machine->regs[2] = memoriaSimulador;
+    machine->stats.minStack = memoriaSimulador;
+    printf("\nSimulando %d palavra(s) com %d palavra(s) de memória de dados...\n", count, memoriaSimulador);
+    SimStatus status = run(machine, program, count);
+    printReport(machine, status);
+    if (profileCounterCount() > 0 && status != SIM_ERROR) {
+        writeProfileFromMemory(machine->memory, memoriaSimulador);  // programa compilado com --instrument
+    }
+
+    free(program);
+    free(machine->memory);
+    free(machine);
+    return status == SIM_STEP_LIMIT || status == SIM_ERROR ? -1 : 0;
+}
+
+// binary.txt: uma palavra de 32 caracteres 0/1 por linha ("//" são comentários)
+static int readBitImage(FILE* file, unsigned int** image, int* count) {
+    char line[MAX_LINE_LENGTH];
+    int capacity = 256;
+    int lineNumber = 0;
+    *image = malloc(capacity * sizeof(unsigned int));
+    *count = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lineNumber++;
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || strncmp(line, "//", 2) == 0) {
+            continue;
+        }
+        if (strlen(line) != 32 || strspn(line, "01") != 32) {
+            printError("Erro: linha %d não é uma palavra de 32 bits.", lineNumber);
+            return -1;
+        }
+        if (*count == capacity) {
+            capacity *= 2;
+            *image = realloc(*image, capacity * sizeof(unsigned int));
+        }
+        (*image)[(*count)++] = (unsigned int)strtoul(line, NULL, 2);
+    }
+    return 0;
+}
+
+// A primeira linha com conteúdo decide: só 0 e 1 é imagem, o resto é assembly
+static int isBitImage(FILE* file) {
+    char line[MAX_LINE_LENGTH];
+    int bits = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] != '\0' && strncmp(line, "//", 2) != 0) {
+            bits = strlen(line) == 32 && strspn(line, "01") == 32;
+            break;
+        }
+    }
+    rewind(file);
+    return bits;
+}
+
+int simulateFile(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printError("Erro: não foi possível abrir '%s'.", path);
+        return -1;
+    }
+    unsigned int* image = NULL;
+    int count = 0;
+    int result = isBitImage(file) ? readBitImage(file, &image, &count) : readAssemblyImage(file, &image, &count);
+    fclose(file);
+    if (result == 0) {
+        result = simulateImage(image, count);
+    }
+    free(image);
+    return result;
+}
@@ -0,0 +1,55 @@
+#ifndef SIMULADOR_H
+#define SIMULADOR_H
+
+#include "globals.h"
+#include "codigo_maquina.h"
+
+#define SIM_REGISTERS 64
+#define SIM_DEFAULT_MEMORY 65536        // palavras da memória de dados
+#define SIM_DEFAULT_MAX_STEPS 10000000  // instruções antes de desistir (laço infinito)
+#define SIM_MAX_INPUTS 256              // valores de --sim-input
+#define SIM_INSTRUCTIONS 64             // entradas da tabela de instruções
+
+// Como a simulação terminou
+typedef enum {
+    SIM_RUNNING,
+    SIM_SYSCALL,     // syscall: volta ao SO (fim do programa de usuário)
+    SIM_HALT,        // halt: desliga o SO
+    SIM_SALTO_USER,  // saltoUser: o SO entrega a CPU a um programa
+    SIM_STEP_LIMIT,
+    SIM_ERROR        // PC fora da imagem, palavra inválida, acesso fora da memória, divisão por zero
+} SimStatus;
+
+// Contadores de uma execução
+typedef struct {
+    long long executed[SIM_INSTRUCTIONS];  // por instrução, na ordem da tabela
+    long long cycles[SIM_INSTRUCTIONS];
+    long long instructions;
+    long long totalCycles;
+    long long loads;
+    long long stores;
+    long long branches;       // desvios condicionais executados
+    long long branchesTaken;
+    int inputs;               // valores lidos por in
+    int outputs;              // valores escritos por out/msgLcd
+    int minStack;             // menor valor de r1 (topo da pilha)
+} SimStats;
+
+// Opções da linha de comando
+extern int simularPrograma;            // --simulate: executa a imagem gerada
+extern int memoriaSimulador;           // --sim-memory=N
+extern long long passosSimulador;      // --sim-max-steps=N
+extern const char* entradaSimulador;   // --sim-input=v1,v2,...
+extern const char* custosSimulador;    // --sim-costs=arquivo
+
+// Lê as opções --sim-*; devolve -1 se alguma é inválida
+int parseSimulatorOptions(int argc, char* argv[]);
+
+// Executa a imagem carregada no endereço 0 e imprime o relatório.
+// Devolve 0 se o programa terminou por syscall, halt ou saltoUser.
+int simulateImage(const unsigned int* image, int count);
+
+// --sim=arquivo: simula um assembly em texto (.asm) ou uma imagem binary.txt
+int simulateFile(const char* path);
+
+#endif
@@ -1,6 +1,8 @@
 #include "globals.h"
 #include "symtab.h"
 #include "semantic.h"
+#include "formato_saida.h"
+#include "tempo_fases.h"
 
 #define SIZE 211 //tamanho da tabela hash
 #define SHIFT 4 //deslocamento para a função hash
@@ -24,6 +26,7 @@ void st_insert(char *name, int lineno, int loc, char *scope, char *idType, char
         return;
     } //verifica se os parâmetros são válidos
 
+    countOperation(COUNTER_SYMBOL_LOOKUP);
     int h = hash(name);
     BucketList l = hashTable[h];
     BucketList prev = NULL;
@@ -36,17 +39,17 @@ void st_insert(char *name, int lineno, int loc, char *scope, char *idType, char
 
     if (l == NULL) {
         // Símbolo não encontrado, insere novo
-        l = (BucketList)malloc(sizeof(struct BucketListRec)); //aloca memória
+        l = (BucketList)memAlloc(sizeof(struct BucketListRec)); //aloca memória
         if (l == NULL) {
             DEBUG_SYMTAB("Erro: Falha ao alocar memória para BucketList.\n");
             exit(EXIT_FAILURE);
         }
 
-        l->name = strdup(name);
-        l->scope = strdup(scope);
-        l->idType = strdup(idType);
-        l->dataType = strdup(dataType);
-        l->lines = (LineList)malloc(sizeof(struct LineListRec));
+        l->name = memStrdup(name);
+        l->scope = memStrdup(scope);
+        l->idType = memStrdup(idType);
+        l->dataType = memStrdup(dataType);
+        l->lines = (LineList)memAlloc(sizeof(struct LineListRec));
         l->lines->lineno = lineno;
         l->lines->next = NULL;
         l->memloc = loc;
@@ -65,7 +68,7 @@ void st_insert(char *name, int lineno, int loc, char *scope, char *idType, char
 
         LineList t = l->lines;
         while (t->next != NULL) t = t->next;
-        t->next = (LineList)malloc(sizeof(struct LineListRec));
+        t->next = (LineList)memAlloc(sizeof(struct LineListRec));
         t->next->lineno = lineno;
         t->next->next = NULL;
     }
@@ -87,13 +90,13 @@ void add_param_info(char *func_name, char *param_type, int is_array) {
         return;
     }
 
-    ParamInfo param = (ParamInfo)malloc(sizeof(struct ParamInfoRec));
+    ParamInfo param = (ParamInfo)memAlloc(sizeof(struct ParamInfoRec));
     if (param == NULL) {
         DEBUG_SYMTAB("Erro: Falha ao alocar memória para ParamInfo.\n");
         exit(EXIT_FAILURE);
     }
 
-    param->paramType = strdup(param_type);
+    param->paramType = memStrdup(param_type);
     param->isArray = is_array;
     param->next = NULL;
 
@@ -118,6 +121,7 @@ BucketList st_lookup(char *name) {
         return NULL;
     }
 
+    countOperation(COUNTER_SYMBOL_LOOKUP);
     int h = hash(name);
     BucketList l = hashTable[h];
     while (l != NULL && strcmp(name, l->name) != 0) {
@@ -132,6 +136,7 @@ BucketList st_lookup_in_scope(char *name, char *scope) {
         return NULL;
     }
 
+    countOperation(COUNTER_SYMBOL_LOOKUP);
     int h = hash(name);
     BucketList l = hashTable[h];
     while (l != NULL && (strcmp(name, l->name) != 0 || strcmp(scope, l->scope) != 0)) {
@@ -159,7 +164,15 @@ BucketList st_lookup_all_scopes(char *name, char *scope) {
 
 void printSymTab(FILE *listing) {
     int i;
-    FILE* outfile = fopen("Output/symtab.txt", "w");
+    char path[OUTPUT_PATH_SIZE];
+    if (!artifactPath(ART_SYMTAB, path, sizeof(path))) {
+        return;  // só com --emit-symtab ou --save-temps
+    }
+    FILE* outfile = fopen(path, "w");
+    if (outfile == NULL) {
+        printError("Erro ao gravar %s.", path);
+        return;
+    }
     
     fprintf(outfile, "Variable Name  Scope       ID Type  Data Type  Location  Line Numbers\n");
     fprintf(outfile, "-------------  ----------  -------  ---------  --------  ------------\n");
@@ -214,7 +227,7 @@ void printSymTab(FILE *listing) {
             }
         }
     }
-    printf("Tabela de símbolos salvo em 'Projeto_final/Output/symtab.txt'\n");
+    printInfo("Tabela de símbolos salvo em '%s'", path);
     fclose(outfile);
 }
 
@@ -222,14 +235,14 @@ static ScopeNode *scope_stack = NULL; // scope_stack: Declara uma pilha de escop
 
 // Função para empilhar um novo escopo
 void push_scope(char *scope_name) {
-    ScopeNode *node = (ScopeNode*)malloc(sizeof(ScopeNode));
+    ScopeNode *node = (ScopeNode*)memAlloc(sizeof(ScopeNode));
 
     if (node == NULL) {
         DEBUG_SYMTAB("Erro: Falha ao alocar memória para ScopeNode.\n");
         exit(EXIT_FAILURE);
     }
 
-    node->scope_id = scope_name ? strdup(scope_name) : NULL; 
+    node->scope_id = scope_name ? memStrdup(scope_name) : NULL; 
     node->next = scope_stack;
     scope_stack = node;
 }
@@ -245,9 +258,9 @@ void pop_scope() {
     scope_stack = scope_stack->next;
 
     if (temp->scope_id) {
-        free(temp->scope_id); // Libera a memória alocada para o scope_id
+        memFree(temp->scope_id); // Libera a memória alocada para o scope_id
     }
-    free(temp); // Libera o nó
+    memFree(temp); // Libera o nó
 }
 
 // Função para obter o escopo atual
@@ -485,7 +498,7 @@ static void traverse(ASTNode *t,
                                 // Adiciona a linha de chamada
                                 LineList lines = funcInScope->lines;
                                 while (lines->next != NULL) lines = lines->next;
-                                lines->next = (LineList)malloc(sizeof(struct LineListRec));
+                                lines->next = (LineList)memAlloc(sizeof(struct LineListRec));
                                 lines->next->lineno = t->lineno;
                                 lines->next->next = NULL;
                             } else {
@@ -497,7 +510,7 @@ static void traverse(ASTNode *t,
                             // Adiciona linha à entrada global
                             LineList lines = func->lines;
                             while (lines->next != NULL) lines = lines->next;
-                            lines->next = (LineList)malloc(sizeof(struct LineListRec));
+                            lines->next = (LineList)memAlloc(sizeof(struct LineListRec));
                             lines->next->lineno = t->lineno;
                             lines->next->next = NULL;
                         }
@@ -528,8 +541,8 @@ static void traverse(ASTNode *t,
                                 while (current != NULL) {
                                     ParamInfo temp = current;
                                     current = current->next;
-                                    free(temp->paramType);
-                                    free(temp);
+                                    memFree(temp->paramType);
+                                    memFree(temp);
                                 }
                                 funcEntry->params = NULL;
                                 funcEntry->paramCount = 0;
@@ -579,14 +592,14 @@ static void insertNode(ASTNode *t) {
         case NODE_VAR_DECL:
             if (existing == NULL) {
                 DEBUG_SYMTAB("insertNode: Inserindo nova variável '%s'", t->value);
-                st_insert(t->value, t->lineno, location++, strdup(scope), "var", t->idType, t->isArray, t->arraySize);
+                st_insert(t->value, t->lineno, location++, memStrdup(scope), "var", t->idType, t->isArray, t->arraySize);
             }
             break;
 
         case NODE_PARAM:
             if (existing == NULL) {
                 DEBUG_SYMTAB("insertNode: Inserindo parâmetro '%s'", t->value);
-                st_insert(t->value, t->lineno, location++, strdup(scope), "param", t->idType, t->isArray, t->arraySize);
+                st_insert(t->value, t->lineno, location++, memStrdup(scope), "param", t->idType, t->isArray, t->arraySize);
                 
                 // Se estamos no escopo de uma função, adiciona informação do parâmetro à função
                 if (scope != NULL && strcmp(scope, "global") != 0) {
@@ -607,14 +620,14 @@ static void insertNode(ASTNode *t) {
                 // Se o símbolo existe em algum escopo acessível, adiciona a linha de uso
                 LineList lines = existing->lines;
                 while (lines->next != NULL) lines = lines->next;
-                lines->next = (LineList)malloc(sizeof(struct LineListRec));
+                lines->next = (LineList)memAlloc(sizeof(struct LineListRec));
                 lines->next->lineno = t->lineno;
                 lines->next->next = NULL;
                 DEBUG_SYMTAB("insertNode: Atualizando uso de '%s' na linha %d no escopo %s", 
                             t->value, t->lineno, existing->scope);
             } else {
                 // Se não existe em nenhum escopo acessível, cria uma nova entrada
-                st_insert(t->value, t->lineno, location++, strdup(scope), "var", t->idType, t->isArray, t->arraySize);
+                st_insert(t->value, t->lineno, location++, memStrdup(scope), "var", t->idType, t->isArray, t->arraySize);
                 DEBUG_SYMTAB("insertNode: Criando nova variável '%s' no escopo atual %s", t->value, scope);
             }
             break;
@@ -673,4 +686,36 @@ void buildSymtab(ASTNode *syntaxTree) {
     pop_scope();
 
     printSymTab(stdout); 
-}
\ No newline at end of file
+}
+
+// Libera a tabela e a pilha de escopos e volta ao estado inicial (modo lote)
+void st_reset(void) {
+    for (int i = 0; i < SIZE; i++) {
+        BucketList l = hashTable[i];
+        while (l != NULL) {
+            BucketList next = l->next;
+            while (l->lines != NULL) {
+                LineList line = l->lines;
+                l->lines = line->next;
+                memFree(line);
+            }
+            while (l->params != NULL) {
+                ParamInfo param = l->params;
+                l->params = param->next;
+                memFree(param->paramType);
+                memFree(param);
+            }
+            memFree(l->name);
+            memFree(l->scope);
+            memFree(l->idType);
+            memFree(l->dataType);
+            memFree(l);
+            l = next;
+        }
+        hashTable[i] = NULL;
+    }
+    while (scope_stack != NULL) {
+        pop_scope();
+    }
+    location = 0;
+}
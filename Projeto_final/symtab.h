@@ -62,6 +62,8 @@ void st_insert(char *name, int lineno, int loc, char *scope, char *idType, char
 
 void printSymTab(FILE *listing); //imprime a tabela de símbolos.
 
+void st_reset(void); //Libera a tabela de símbolos para compilar outro programa.
+
 void process_func_args(ASTNode *argsNode, char *funcName, int lineno);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,281 @@
+#include "tempo_fases.h"
+#include <time.h>
+#include <malloc.h>
+#include <sys/resource.h>
+
+const char* arquivoTempos = NULL;
+const char* arquivoEstatisticas = NULL;
+int medirFases = 0;
+int medirCpu = 0;
+int medirMemoria = 0;
+
+static PhaseTime phases[MAX_PHASES];
+static int phaseCount = 0;
+
+long long phaseCounters[COUNTER_TOTAL];
+static const char* counterNames[COUNTER_TOTAL] = {"busca na tabela de simbolos", "busca de rotulos"};
+
+// Fases abertas: índice em phases e o estado no instante de abertura
+typedef struct {
+    int phase;
+    double wall;
+    double cpu;
+    long long allocations;
+    long long bytes;
+    long long frees;
+    long long outerPeak;    // pico da fase de fora, guardado enquanto esta está aberta
+} OpenPhase;
+
+static OpenPhase openPhases[MAX_PHASE_DEPTH];
+static int openCount = 0;
+
+// Nomes das fases abertas, mantidos sempre
+static const char* phaseNames[MAX_PHASE_DEPTH];
+static int nameCount = 0;
+
+// Contadores do alocador desde o início da compilação
+static long long totalAllocations = 0;
+static long long totalBytes = 0;
+static long long totalFrees = 0;
+static long long liveBytes = 0;
+static long long windowPeak = 0;    // pico de liveBytes desde a abertura da fase mais interna
+
+static double now(clockid_t clock) {
+    struct timespec time;
+    clock_gettime(clock, &time);
+    return time.tv_sec + time.tv_nsec / 1e9;
+}
+
+// Fase 'name' aberta dentro de 'parent'. Os nomes são literais; a comparação por ponteiro resolve quase sempre
+static int findPhase(const char* name, int parent) {
+    for (int i = 0; i < phaseCount; i++) {
+        if (phases[i].parent == parent && (phases[i].name == name || strcmp(phases[i].name, name) == 0)) {
+            return i;
+        }
+    }
+    if (phaseCount == MAX_PHASES) {
+        return -1;
+    }
+    memset(&phases[phaseCount], 0, sizeof(PhaseTime));
+    phases[phaseCount].name = name;
+    phases[phaseCount].parent = parent;
+    phases[phaseCount].depth = parent >= 0 ? phases[parent].depth + 1 : 0;
+    return phaseCount++;
+}
+
+// Fases em pré-ordem: cada uma seguida das filhas, na ordem em que apareceram
+static int treeOrder(int parent, int* order, int count) {
+    for (int i = 0; i < phaseCount; i++) {
+        if (phases[i].parent == parent) {
+            order[count++] = i;
+            count = treeOrder(i, order, count);
+        }
+    }
+    return count;
+}
+
+void phaseBegin(const char* name) {
+    if (nameCount < MAX_PHASE_DEPTH) {
+        phaseNames[nameCount] = name;
+    }
+    nameCount++;
+    if (!medirFases) {
+        return;
+    }
+    if (openCount == MAX_PHASE_DEPTH) {
+        openCount++; // só conta, para o phaseEnd correspondente
+        return;
+    }
+    OpenPhase* open = &openPhases[openCount];
+    open->phase = findPhase(name, openCount > 0 ? openPhases[openCount - 1].phase : -1);
+    open->allocations = totalAllocations;
+    open->bytes = totalBytes;
+    open->frees = totalFrees;
+    open->outerPeak = windowPeak;
+    windowPeak = liveBytes;
+    open->cpu = medirCpu ? now(CLOCK_PROCESS_CPUTIME_ID) : 0;
+    open->wall = now(CLOCK_MONOTONIC);
+    openCount++;
+}
+
+void phaseEnd(void) {
+    if (nameCount > 0) {
+        nameCount--;
+    }
+    if (!medirFases || openCount == 0) {
+        return;
+    }
+    double wall = now(CLOCK_MONOTONIC);
+    openCount--;
+    if (openCount >= MAX_PHASE_DEPTH) {
+        return;
+    }
+    OpenPhase* open = &openPhases[openCount];
+    if (open->phase >= 0) {
+        PhaseTime* phase = &phases[open->phase];
+        phase->seconds += wall - open->wall;
+        if (medirCpu) {
+            phase->cpuSeconds += now(CLOCK_PROCESS_CPUTIME_ID) - open->cpu;
+        }
+        phase->calls++;
+        phase->allocations += totalAllocations - open->allocations;
+        phase->bytes += totalBytes - open->bytes;
+        phase->frees += totalFrees - open->frees;
+        if (windowPeak > phase->peakBytes) {
+            phase->peakBytes = windowPeak;
+        }
+    }
+    // O pico desta fase também é pico da fase de fora
+    if (open->outerPeak > windowPeak) {
+        windowPeak = open->outerPeak;
+    }
+}
+
+const char* currentPhase(void) {
+    if (nameCount == 0) {
+        return NULL;
+    }
+    return phaseNames[nameCount <= MAX_PHASE_DEPTH ? nameCount - 1 : MAX_PHASE_DEPTH - 1];
+}
+
+void resetPhaseTimes(void) {
+    phaseCount = 0;
+    nameCount = 0;
+    openCount = 0;
+    totalAllocations = 0;
+    totalBytes = 0;
+    totalFrees = 0;
+    liveBytes = 0;
+    windowPeak = 0;
+    memset(phaseCounters, 0, sizeof(phaseCounters));
+}
+
+// O tamanho real do bloco vem do malloc, então memFree não precisa de cabeçalho
+static void countAllocation(void* pointer) {
+    if (pointer == NULL) {
+        printError("Erro: Falha ao alocar memória.");
+        exit(EXIT_FAILURE);
+    }
+    if (medirMemoria) {
+        long long size = (long long)malloc_usable_size(pointer);
+        totalAllocations++;
+        totalBytes += size;
+        liveBytes += size;
+        if (liveBytes > windowPeak) {
+            windowPeak = liveBytes;
+        }
+    }
+}
+
+void* memAlloc(size_t size) {
+    void* pointer = malloc(size);
+    countAllocation(pointer);
+    return pointer;
+}
+
+void* memRealloc(void* pointer, size_t size) {
+    if (medirMemoria && pointer != NULL) {
+        liveBytes -= (long long)malloc_usable_size(pointer);
+    }
+    pointer = realloc(pointer, size);
+    countAllocation(pointer);
+    return pointer;
+}
+
+char* memStrdup(const char* text) {
+    char* copy = strdup(text);
+    countAllocation(copy);
+    return copy;
+}
+
+void memFree(void* pointer) {
+    if (pointer == NULL) {
+        return;
+    }
+    if (medirMemoria) {
+        totalFrees++;
+        liveBytes -= (long long)malloc_usable_size(pointer);
+        if (liveBytes < 0) {
+            liveBytes = 0; // bloco que não passou pelo memAlloc
+        }
+    }
+    free(pointer);
+}
+
+int writePhaseTimes(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printError("Erro ao abrir %s.", path);
+        return -1;
+    }
+    int order[MAX_PHASES];
+    int count = treeOrder(-1, order, 0);
+    for (int k = 0; k < count; k++) {
+        const PhaseTime* phase = &phases[order[k]];
+        fprintf(file, "%s\t%.6f\t%lld\t%d\n", phase->name, phase->seconds, phase->calls, phase->depth);
+    }
+    fclose(file);
+    return 0;
+}
+
+// Percentual em relação à primeira fase, que envolve a compilação inteira
+static double share(double value, double total) {
+    return total > 0 ? 100.0 * value / total : 0;
+}
+
+void printPhaseReport(int times, int memory) {
+    if (phaseCount == 0) {
+        return;
+    }
+    int order[MAX_PHASES];
+    int count = treeOrder(-1, order, 0);
+    if (times) {
+        printf("\n%-40s %10s %6s %10s %6s %10s\n", "Fase", "parede (s)", "%", "CPU (s)", "%", "chamadas");
+        for (int k = 0; k < count; k++) {
+            const PhaseTime* phase = &phases[order[k]];
+            printf("%*s%-*s %10.4f %5.1f%% %10.4f %5.1f%% %10lld\n", phase->depth * 2, "", 40 - phase->depth * 2,
+                   phase->name, phase->seconds, share(phase->seconds, phases[0].seconds), phase->cpuSeconds,
+                   share(phase->cpuSeconds, phases[0].cpuSeconds), phase->calls);
+        }
+        printf("\n%-40s %10s\n", "Operação (só contada)", "chamadas");
+        for (int i = 0; i < COUNTER_TOTAL; i++) {
+            printf("%-40s %10lld\n", counterNames[i], phaseCounters[i]);
+        }
+    }
+    if (memory) {
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        printf("\n%-40s %12s %12s %12s %12s\n", "Fase", "alocações", "bytes", "liberações", "pico (bytes)");
+        for (int k = 0; k < count; k++) {
+            const PhaseTime* phase = &phases[order[k]];
+            printf("%*s%-*s %12lld %12lld %12lld %12lld\n", phase->depth * 2, "", 40 - phase->depth * 2,
+                   phase->name, phase->allocations, phase->bytes, phase->frees, phase->peakBytes);
+        }
+        printf("Memória residente máxima do processo: %ld KB\n", usage.ru_maxrss);
+    }
+}
+
+int writePhaseStatsJson(const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printError("Erro ao abrir %s.", path);
+        return -1;
+    }
+    int order[MAX_PHASES];
+    int count = treeOrder(-1, order, 0);
+    fprintf(file, "{\"fases\": [\n");
+    for (int k = 0; k < count; k++) {
+        const PhaseTime* phase = &phases[order[k]];
+        fprintf(file, "%s{\"nome\": \"%s\", \"nivel\": %d, \"chamadas\": %lld, \"parede\": %.6f, \"cpu\": %.6f, "
+                "\"alocacoes\": %lld, \"bytes\": %lld, \"liberacoes\": %lld, \"pico\": %lld}",
+                k > 0 ? ",\n" : "", phase->name, phase->depth, phase->calls, phase->seconds, phase->cpuSeconds,
+                phase->allocations, phase->bytes, phase->frees, phase->peakBytes);
+    }
+    fprintf(file, "\n], \"operacoes\": [\n");
+    for (int i = 0; i < COUNTER_TOTAL; i++) {
+        fprintf(file, "%s{\"nome\": \"%s\", \"chamadas\": %lld}", i > 0 ? ",\n" : "", counterNames[i], phaseCounters[i]);
+    }
+    fprintf(file, "\n]}\n");
+    fclose(file);
+    return 0;
+}
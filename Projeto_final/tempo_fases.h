@@ -0,0 +1,67 @@
+#ifndef TEMPO_FASES_H
+#define TEMPO_FASES_H
+
+#include "globals.h"
+
+#define MAX_PHASES 32       // fases diferentes medidas numa compilação
+#define MAX_PHASE_DEPTH 8   // fases abertas ao mesmo tempo (uma dentro da outra)
+
+// Tempo e memória acumulados de uma fase. Uma fase aberta dentro de outra conta nas duas;
+// a mesma fase aberta dentro de pais diferentes é medida em separado, uma vez por pai.
+typedef struct {
+    const char* name;
+    double seconds;         // tempo de parede
+    double cpuSeconds;      // tempo de CPU do processo
+    long long calls;
+    int parent;             // fase em que esta foi aberta (-1 na de fora)
+    int depth;              // aninhamento: o do pai mais um
+    long long allocations;  // alocações feitas pelas funções mem* durante a fase
+    long long bytes;        // bytes dessas alocações
+    long long frees;
+    long long peakBytes;    // maior quantidade de memória viva (contada) durante a fase
+} PhaseTime;
+
+extern const char* arquivoTempos;        // --phase-times=arquivo
+extern const char* arquivoEstatisticas;  // --stats-json=arquivo
+extern int medirFases;                   // alguma opção pediu medidas das fases
+extern int medirCpu;                     // --time-passes ou --stats-json: também o tempo de CPU
+extern int medirMemoria;                 // --mem-stats ou --stats-json: conta as alocações
+
+// Sem medição ativa as duas só testam a flag
+void phaseBegin(const char* name);
+void phaseEnd(void);
+
+// Operações curtas e chamadas demais para virarem fase (duas leituras de relógio por
+// chamada custariam mais que a própria operação): só o número de chamadas é contado
+typedef enum {
+    COUNTER_SYMBOL_LOOKUP,  // st_insert, st_lookup e st_lookup_in_scope
+    COUNTER_LABEL_LOOKUP,   // lookupLabel
+    COUNTER_TOTAL
+} PhaseCounter;
+
+extern long long phaseCounters[COUNTER_TOTAL];
+
+#define countOperation(counter) (phaseCounters[counter]++)
+
+void resetPhaseTimes(void);
+
+// Fase mais interna aberta agora (mesmo sem medição), para os diagnósticos; NULL fora das fases
+const char* currentPhase(void);
+
+// Alocador contado: com medirMemoria cada chamada entra na fase aberta. Sem a
+// opção são só malloc/realloc/strdup/free. memFree aceita qualquer ponteiro do malloc.
+void* memAlloc(size_t size);
+void* memRealloc(void* pointer, size_t size);
+char* memStrdup(const char* text);
+void memFree(void* pointer);
+
+// Uma linha "fase<TAB>segundos<TAB>chamadas<TAB>nível" por fase, cada uma logo depois do pai
+int writePhaseTimes(const char* path);
+
+// Tabelas do --time-passes (tempos) e do --mem-stats (memória), na saída padrão
+void printPhaseReport(int times, int memory);
+
+// As mesmas medidas em JSON, uma fase por linha
+int writePhaseStatsJson(const char* path);
+
+#endif
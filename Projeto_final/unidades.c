@@ -0,0 +1,382 @@
+#include "unidades.h"
+#include <unistd.h>
+#include <sys/wait.h>
+#include "cinter.h"
+#include "assembly_mips.h"
+#include "cache_funcoes.h"
+#include "tempo_fases.h"
+
+int funcoesParalelas = 1;
+
+// Uma declaração de nível do programa, ou a faixa de quádruplas que veio dela
+typedef struct {
+    ASTNode* decl;              // NULL quando o código intermediário já foi ligado
+    const Quadruple* inicio;    // primeira quádrupla da faixa
+    int ehFuncao;
+    int primeiraFuncao;         // nenhuma função antes desta (salto inicial para a main)
+    GlobalRegisterMap globais;  // registradores das globais na entrada
+    IRCode ir;                  // quádruplas ainda não ligadas, numeradas a partir de zero
+    MachineCode code;
+    int retornos;               // rótulos RDn usados, numerados a partir de zero
+    int pronta;                 // código já gerado (aqui, num processo auxiliar ou no cache)
+    unsigned long long chave;   // --cache: função gerada que ainda vai para o cache (0 = nenhuma)
+} CompilationUnit;
+
+typedef struct {
+    CompilationUnit* items;
+    int count;
+    int capacity;
+} UnitList;
+
+static CompilationUnit* addUnit(UnitList* units) {
+    if (units->count == units->capacity) {
+        units->capacity = units->capacity ? units->capacity * 2 : 64;
+        units->items = memRealloc(units->items, units->capacity * sizeof(CompilationUnit));
+    }
+    CompilationUnit* unit = &units->items[units->count++];
+    memset(unit, 0, sizeof(CompilationUnit));
+    return unit;
+}
+
+// Declarações na ordem do fonte (decl_list é recursiva à esquerda)
+static void collectDecls(ASTNode* node, UnitList* units) {
+    if (node == NULL) return;
+    if (node->type == NODE_PROGRAM || node->type == NODE_DECL_LIST) {
+        collectDecls(node->left, units);
+        collectDecls(node->right, units);
+        return;
+    }
+    CompilationUnit* unit = addUnit(units);
+    unit->decl = node;
+    unit->ehFuncao = node->type == NODE_FUNC_DECL;
+}
+
+// Faixas do programa já ligado: cada função (FUNCTION até END) e as quádruplas
+// globais entre elas
+static void splitRanges(const Quadruple* head, UnitList* units) {
+    const Quadruple* atual = head;
+    while (atual != NULL) {
+        CompilationUnit* unit = addUnit(units);
+        unit->inicio = atual;
+        unit->ehFuncao = atual->op == OP_FUNCTION;
+        if (unit->ehFuncao) {
+            while (atual != NULL && atual->op != OP_END) atual = atual->next;
+            if (atual != NULL) atual = atual->next;
+        } else {
+            while (atual != NULL && atual->op != OP_FUNCTION) atual = atual->next;
+        }
+    }
+}
+
+// Código intermediário (se ainda não há) e código de máquina de uma unidade
+static void compileUnit(CompilationUnit* unit) {
+    if (unit->decl != NULL) {
+        unit->ir = generateDeclIR(unit->decl, 1);
+        unit->inicio = unit->ir.head;
+    }
+    phaseBegin("geracao de codigo");
+    generateRangeAssembly(unit->inicio, &unit->globais, unit->primeiraFuncao, &unit->code, &unit->retornos);
+    phaseEnd();
+    unit->pronta = 1;
+}
+
+// Dá a cada unidade o estado de entrada do backend. As declarações globais são
+// geradas aqui, em ordem: o mapa dos registradores das globais vem delas.
+static void prepareUnits(UnitList* units, int keepComments) {
+    GlobalRegisterMap globais;
+    initGlobalRegisterMap(&globais);
+    int primeiraFuncao = 1;
+    for (int i = 0; i < units->count; i++) {
+        CompilationUnit* unit = &units->items[i];
+        initMachineCode(&unit->code, keepComments);
+        unit->globais = globais;
+        if (unit->ehFuncao) {
+            unit->primeiraFuncao = primeiraFuncao;
+            primeiraFuncao = 0;
+        } else {
+            compileUnit(unit);
+            globais = unit->globais;
+        }
+    }
+}
+
+static int countQuadruples(const IRCode* ir) {
+    int count = 0;
+    for (const Quadruple* q = ir->head; q != NULL; q = q->next) count++;
+    return count;
+}
+
+// Resultado de um processo auxiliar: "U unidade retornos quádruplas entradas" e em
+// seguida as quádruplas (writeIRUnit) e o código (writeMachineCodeRange) da unidade
+static void writeUnitResult(FILE* file, int index, const CompilationUnit* unit) {
+    fprintf(file, "U %d %d %d %d\n", index, unit->retornos, countQuadruples(&unit->ir), unit->code.count);
+    writeIRUnit(file, &unit->ir, 0);
+    writeMachineCodeRange(file, &unit->code, 0, unit->code.count, 0);
+}
+
+// Lê os resultados de um processo auxiliar; para no primeiro incompleto
+static void readUnitResults(FILE* file, UnitList* units) {
+    int index, retornos, quadruplas, entradas;
+    while (fscanf(file, "U %d %d %d %d\n", &index, &retornos, &quadruplas, &entradas) == 4) {
+        if (index < 0 || index >= units->count || units->items[index].pronta) {
+            return;
+        }
+        CompilationUnit* unit = &units->items[index];
+        if (readIRUnit(file, &unit->ir, quadruplas, 0) != 0 ||
+            readMachineCodeRange(file, &unit->code, entradas, 0) != 0) {
+            freeIRUnit(&unit->ir);
+            while (unit->code.count > 0) {
+                freeMachineInstr(&unit->code.items[--unit->code.count]);
+            }
+            return;
+        }
+        unit->inicio = unit->ir.head;
+        unit->retornos = retornos;
+        unit->pronta = 1;
+    }
+}
+
+// Divide as funções entre 'tarefas' processos, uma a cada 'tarefas' em cada um.
+// Cada processo grava o resultado num arquivo temporário, lido aqui em ordem.
+static void runWorkers(UnitList* units, int tarefas) {
+    FILE** saidas = calloc(tarefas, sizeof(FILE*));
+    pid_t* processos = calloc(tarefas, sizeof(pid_t));
+    for (int w = 0; w < tarefas; w++) {
+        saidas[w] = tmpfile();
+    }
+    for (int w = 0; w < tarefas; w++) {
+        if (saidas[w] == NULL) {
+            continue;
+        }
+        fflush(stdout);
+        fflush(stderr);
+        flushTrace();
+        pid_t pid = fork();
+        if (pid == 0) {
+            int funcao = 0;
+            for (int i = 0; i < units->count; i++) {
+                CompilationUnit* unit = &units->items[i];
+                if (unit->ehFuncao && !unit->pronta && funcao++ % tarefas == w) {
+                    compileUnit(unit);
+                    writeUnitResult(saidas[w], i, unit);
+                }
+            }
+            int result = fflush(saidas[w]) != 0 || ferror(saidas[w]);
+            fflush(stdout);
+            fflush(stderr);
+            flushTrace();
+            _exit(result);
+        }
+        processos[w] = pid;
+    }
+
+    for (int w = 0; w < tarefas; w++) {
+        int status;
+        if (processos[w] > 0 && waitpid(processos[w], &status, 0) == processos[w] &&
+            WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+            rewind(saidas[w]);
+            readUnitResults(saidas[w], units);
+        }
+        if (saidas[w] != NULL) {
+            fclose(saidas[w]);
+        }
+    }
+    free(saidas);
+    free(processos);
+}
+
+// --cache: as funções cuja chave está no cache saem prontas, sem código
+// intermediário, otimização nem backend
+static void loadCachedUnits(UnitList* units, int keepComments) {
+    phaseBegin("cache de funcoes");
+    for (int i = 0; i < units->count; i++) {
+        CompilationUnit* unit = &units->items[i];
+        if (!unit->ehFuncao) {
+            continue;
+        }
+        unsigned long long chave = functionCacheKey(unit->decl, &unit->globais, unit->primeiraFuncao, keepComments);
+        if (loadCachedFunction(chave, &unit->ir, &unit->code, &unit->retornos, functionSourceLine(unit->decl)) == 0) {
+            unit->inicio = unit->ir.head;
+            unit->pronta = 1;
+        } else {
+            unit->chave = chave;
+        }
+    }
+    phaseEnd();
+}
+
+// Guarda as funções geradas nesta compilação, antes que a ligação renomeie os nomes
+static void storeCachedUnits(UnitList* units) {
+    phaseBegin("cache de funcoes");
+    for (int i = 0; i < units->count; i++) {
+        CompilationUnit* unit = &units->items[i];
+        if (unit->chave != 0) {
+            storeCachedFunction(unit->chave, &unit->ir, &unit->code, unit->retornos, functionSourceLine(unit->decl));
+        }
+    }
+    saveFunctionCache();
+    phaseEnd();
+}
+
+// Gera as funções que faltam, em funcoesParalelas processos quando há mais de uma
+static void compileFunctions(UnitList* units) {
+    int funcoes = 0;
+    for (int i = 0; i < units->count; i++) {
+        funcoes += units->items[i].ehFuncao && !units->items[i].pronta;
+    }
+    int tarefas = funcoesParalelas < funcoes ? funcoesParalelas : funcoes;
+
+    if (tarefas > 1) {
+        printInfo("Compilando %d função(ões) em até %d processo(s).", funcoes, tarefas);
+        phaseBegin("funcoes em paralelo");
+        runWorkers(units, tarefas);
+        phaseEnd();
+    }
+    // Sem paralelismo, ou o que um processo auxiliar não entregou (fork falhou, erro)
+    int avisou = tarefas <= 1;
+    for (int i = 0; i < units->count; i++) {
+        CompilationUnit* unit = &units->items[i];
+        if (!unit->pronta) {
+            if (!avisou) {
+                printWarning("Aviso: um processo auxiliar falhou; as funções restantes são compiladas neste.");
+                avisou = 1;
+            }
+            compileUnit(unit);
+        }
+    }
+}
+
+// Soma a base ao número de um nome gerado (prefixo seguido só de dígitos); 0 se o
+// nome não é do prefixo
+static int renumberToken(const char* token, size_t length, const char* prefix, int base, char* out, size_t size) {
+    size_t prefixLength = strlen(prefix);
+    if (length <= prefixLength || strncmp(token, prefix, prefixLength) != 0) return 0;
+    for (size_t i = prefixLength; i < length; i++) {
+        if (!isdigit((unsigned char)token[i])) return 0;
+    }
+    snprintf(out, size, "%s%d", prefix, atoi(token + prefixLength) + base);
+    return 1;
+}
+
+// Bases dos nomes de uma unidade no programa ligado
+typedef struct {
+    int rotulos;      // Ln
+    int temporarios;  // tvn
+    int retornos;     // RDn
+} NameBases;
+
+static int renameToken(const char* token, size_t length, const NameBases* bases, char* out, size_t size) {
+    return (bases->rotulos != 0 && renumberToken(token, length, "L", bases->rotulos, out, size)) ||
+           (bases->temporarios != 0 && renumberToken(token, length, "tv", bases->temporarios, out, size)) ||
+           (bases->retornos != 0 && renumberToken(token, length, "RD", bases->retornos, out, size));
+}
+
+static void renameLabel(char** name, const NameBases* bases) {
+    char renamed[32];
+    if (*name != NULL && renameToken(*name, strlen(*name), bases, renamed, sizeof(renamed))) {
+        free(*name);
+        *name = strdup(renamed);
+    }
+}
+
+// Os comentários citam rótulos e temporários das quádruplas: troca cada palavra
+// gerada pelo nome ligado, no limite do setInstrComment
+static void renameComment(char** comment, const NameBases* bases) {
+    char renamed[256];
+    size_t used = 0;
+    int changed = 0;
+    for (const char* p = *comment; *p && used < sizeof(renamed) - 1;) {
+        size_t length = 0;
+        while (isalnum((unsigned char)p[length])) length++;
+        char token[32];
+        if (length > 0 && length < sizeof(token) && renameToken(p, length, bases, token, sizeof(token))) {
+            used += snprintf(renamed + used, sizeof(renamed) - used, "%s", token);
+            if (used > sizeof(renamed) - 1) used = sizeof(renamed) - 1;
+            changed = 1;
+        } else {
+            size_t copy = length > 0 ? length : 1;
+            if (copy > sizeof(renamed) - 1 - used) copy = sizeof(renamed) - 1 - used;
+            memcpy(renamed + used, p, copy);
+            used += copy;
+        }
+        p += length > 0 ? length : 1;
+    }
+    if (changed) {
+        renamed[used] = '\0';
+        free(*comment);
+        *comment = strdup(renamed);
+    }
+}
+
+// Acrescenta o código da unidade ao programa com os nomes já ligados; as entradas
+// passam para output e a unidade fica vazia
+static void appendUnitCode(MachineCode* output, CompilationUnit* unit, const NameBases* bases) {
+    for (int i = 0; i < unit->code.count; i++) {
+        MachineInstr* instr = appendMachineInstr(output, NULL);
+        *instr = unit->code.items[i];
+        renameLabel(&instr->label, bases);
+        renameLabel(&instr->symbol, bases);
+        if (instr->comment != NULL) {
+            renameComment(&instr->comment, bases);
+        }
+    }
+    free(unit->code.items);
+    initMachineCode(&unit->code, output->keepComments);
+}
+
+// Ligação: as unidades entram no programa na ordem do fonte, cada uma com os nomes
+// somados aos das anteriores. ligarIR: as quádruplas ainda estão nas unidades.
+static void linkUnits(UnitList* units, int ligarIR, MachineCode* output) {
+    int retornoBase = 0;
+    for (int i = 0; i < units->count; i++) {
+        CompilationUnit* unit = &units->items[i];
+        NameBases bases = {0, 0, retornoBase};
+        if (ligarIR) {
+            const IRCode* programa = getIRCode();
+            bases.rotulos = programa->label_count;
+            bases.temporarios = programa->void_temp_count;
+            linkIRCode(&unit->ir, 0);
+        }
+        appendUnitCode(output, unit, &bases);
+        retornoBase += unit->retornos;
+    }
+}
+
+void generateProgramCode(ASTNode* root, int mode, MachineCode* output) {
+    UnitList units = {NULL, 0, 0};
+    collectDecls(root, &units);
+
+    // As passagens do programa inteiro rodam sobre o código já ligado; o backend
+    // continua por função, sobre as faixas do resultado
+    int porFuncao = !needsProgramIRPasses();
+    // A chave vem da árvore da função: não vale quando outras funções mudam o código dela
+    int usarCache = cacheFuncoes && porFuncao;
+    if (cacheFuncoes && !porFuncao) {
+        printWarning("Aviso: --cache não vale com --inline, --instrument ou --profile; as funções são geradas sem o cache.");
+    }
+    if (!porFuncao) {
+        for (int i = 0; i < units.count; i++) {
+            IRCode unit = generateDeclIR(units.items[i].decl, 0);
+            linkIRCode(&unit, 1);
+        }
+        optimizeProgramIR();
+        units.count = 0;
+        splitRanges(getIRCode()->head, &units);
+    }
+
+    prepareUnits(&units, output->keepComments);
+    if (usarCache) {
+        loadCachedUnits(&units, output->keepComments);
+    }
+    compileFunctions(&units);
+    if (usarCache) {
+        storeCachedUnits(&units);
+    }
+
+    phaseBegin("geracao de codigo");
+    generatePrologue(mode, output);
+    linkUnits(&units, porFuncao, output);
+    phaseEnd();
+    writeIRListings();
+    memFree(units.items);
+}
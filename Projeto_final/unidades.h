@@ -0,0 +1,21 @@
+#ifndef UNIDADES_H
+#define UNIDADES_H
+
+#include "globals.h"
+#include "asnt.h"
+#include "codigo_maquina.h"
+
+extern int funcoesParalelas;  // -j N fora do lote: funções compiladas ao mesmo tempo
+
+// Código intermediário e código de máquina do programa, uma declaração de nível do
+// programa (função ou variável global) por vez. Cada função é gerada, otimizada e
+// traduzida com rótulos, temporários e rótulos RDn numerados a partir de zero; a
+// ligação soma a esses nomes o que as anteriores já usaram, e o resultado é o mesmo
+// de gerar o programa inteiro de uma vez. Com -j N > 1 as funções são divididas
+// entre N processos. --instrument, --profile e --inline precisam do programa
+// inteiro: com elas o código intermediário é ligado antes das passagens e só o
+// backend é feito por função. Com --cache, as funções já guardadas não passam por
+// nenhuma dessas etapas.
+void generateProgramCode(ASTNode* root, int mode, MachineCode* output);
+
+#endif